@@ -30,7 +30,6 @@
 #include "app_priv.h"
 
 struct chan {
-    void *encoder;
     uint16_t handle;
 } chans[AUDIO_CHANNELS];
 
@@ -40,13 +39,10 @@ struct chan {
 #include <usb_audio.h>
 
 #include <lc3.h>
-#include <samplerate.h>
 #include <nrf_clock.h>
 
 #include "host/ble_gap.h"
-#include "os/os_cputime.h"
-
-#define AUDIO_BUF_SIZE      1024
+#include "audio/ble_audio_source_pipeline.h"
 
 static uint8_t g_usb_enabled;
 
@@ -56,29 +52,13 @@ static struct os_event usb_data_ev = {
     .ev_cb = usb_data_func,
 };
 
-static uint32_t frame_bytes_lc3;
-static uint16_t big_sdu;
+static struct ble_audio_source_pipeline *pipeline;
 
-static int16_t out_buf[AUDIO_BUF_SIZE];
-/* Reserve twice the size of input, so we'll always have space for resampler output */
-static uint8_t encoded_frame[155];
-static int out_idx = 0;
 #if MYNEWT_VAL(ISO_HCI_FEEDBACK)
-static int samples_idx = 0;
-static int16_t samples_read[AUDIO_BUF_SIZE];
-/* 155 is maximum value Octets Per Codec Frame described in Table 3.5 of BAP specification */
-static float samples_read_float[AUDIO_BUF_SIZE];
-static float resampled_float[AUDIO_BUF_SIZE];
 float resampler_in_rate = MYNEWT_VAL(USB_AUDIO_OUT_SAMPLE_RATE);
 float resampler_out_rate = LC3_SAMPLING_FREQ;
-float resampler_ratio;
-SRC_STATE *resampler_state;
 static struct ble_gap_event_listener feedback_listener;
-#endif
-static uint32_t pkt_counter = 0;
-
 
-#if MYNEWT_VAL(ISO_HCI_FEEDBACK)
 static int
 ble_hs_gap_event_handler(struct ble_gap_event *event, void *arg)
 {
@@ -99,135 +79,44 @@ ble_hs_gap_event_handler(struct ble_gap_event *event, void *arg)
             } else if (feedback_pkt->feedback[0].diff < 0) {
                 adjust -= 10;
             }
-            resampler_ratio = (resampler_out_rate + adjust) / resampler_in_rate;
+            ble_audio_source_pipeline_resample_ratio_set(pipeline,
+                (resampler_out_rate + adjust) / resampler_in_rate);
         }
     }
 
     return 0;
 }
+#endif
 
-static void
-resample(void)
+static uint16_t
+usb_source_read(struct ble_audio_pcm_source *source, int16_t *pcm,
+                uint16_t max_frames)
 {
-    static int resampled_len;
-    int samples_consumed;
-    int samples_left;
-    SRC_DATA sd;
-    int resample_avail = ARRAY_SIZE(out_buf) - out_idx;
-    int rc;
-
-    src_short_to_float_array(samples_read, samples_read_float, samples_idx);
-
-    sd.data_in = samples_read_float;
-    sd.data_out = resampled_float;
-    sd.input_frames = samples_idx / AUDIO_CHANNELS;
-    sd.output_frames = resample_avail / AUDIO_CHANNELS;
-    sd.end_of_input = 0;
-    sd.input_frames_used = 0;
-    sd.output_frames_gen = 0;
-    sd.src_ratio = resampler_ratio;
-
-    rc = src_process(resampler_state, &sd);
-    assert(rc == 0);
-
-    resampled_len = sd.output_frames_gen * AUDIO_CHANNELS;
-
-    assert(resampled_len <= resample_avail);
+    unsigned int num_frames;
+    int read;
 
-    src_float_to_short_array(resampled_float,
-                             &out_buf[out_idx],
-                             resampled_len);
+    num_frames = tud_audio_available() / (AUDIO_CHANNELS * AUDIO_SAMPLE_SIZE);
+    num_frames = MIN(num_frames, max_frames);
 
-    out_idx += resampled_len;
+    read = tud_audio_read(pcm, num_frames * AUDIO_CHANNELS * AUDIO_SAMPLE_SIZE);
+    assert(read == num_frames * AUDIO_CHANNELS * AUDIO_SAMPLE_SIZE);
 
-    samples_consumed = sd.input_frames_used * AUDIO_CHANNELS;
-    samples_left = samples_idx - samples_consumed;
-    memmove(samples_read, &samples_read[samples_consumed], samples_left);
-    samples_idx -= samples_consumed;
+    return num_frames;
 }
-#endif
+
+static struct ble_audio_pcm_source usb_source = {
+    .read = usb_source_read,
+};
 
 static void
 usb_data_func(struct os_event *ev)
 {
-    int ch_idx;
-    unsigned int num_bytes;
-    unsigned int num_samples;
-    unsigned int num_frames;
-    int read;
-    int skip;
-
     if (!g_usb_enabled) {
         tud_audio_clear_ep_out_ff();
         return;
     }
 
-    while ((num_bytes = tud_audio_available()) > 0) {
-        num_frames = num_bytes / (AUDIO_CHANNELS * AUDIO_SAMPLE_SIZE);
-        num_samples = num_frames * AUDIO_CHANNELS;
-        if (out_idx + num_samples >= ARRAY_SIZE(out_buf)) {
-            num_samples = ARRAY_SIZE(out_buf) - out_idx - 1;
-        }
-        num_frames = num_samples / AUDIO_CHANNELS;
-        num_bytes = num_frames * AUDIO_SAMPLE_SIZE * AUDIO_CHANNELS;
-
-#if MYNEWT_VAL(ISO_HCI_FEEDBACK)
-        assert(samples_idx + num_samples < ARRAY_SIZE(samples_read));
-        read = tud_audio_read(&samples_read[samples_idx], num_bytes);
-        samples_idx += num_samples;
-        resample();
-#else
-        assert(out_idx + num_samples < ARRAY_SIZE(out_buf));
-        read = tud_audio_read(&out_buf[out_idx], num_bytes);
-        out_idx += num_samples;
-#endif
-        assert(read == num_bytes);
-
-        assert((out_idx & 0x80000000) == 0);
-        if (out_idx / AUDIO_CHANNELS >= LC3_FPDT) {
-            pkt_counter++;
-            skip = 0;
-
-            for (ch_idx = 0; ch_idx < AUDIO_CHANNELS; ch_idx++) {
-                if (chans[ch_idx].handle == 0) {
-                    skip = 1;
-                    continue;
-                }
-            }
-
-            if (!skip) {
-                memset(encoded_frame, 0, sizeof(encoded_frame));
-                lc3_encode(chans[0].encoder, LC3_PCM_FORMAT_S16, out_buf + 0,
-                           AUDIO_CHANNELS, (int) frame_bytes_lc3,
-                           encoded_frame);
-                if (AUDIO_CHANNELS == 2) {
-                    if (MYNEWT_VAL(BIG_NUM_BIS) == 1) {
-                        lc3_encode(chans[0].encoder, LC3_PCM_FORMAT_S16,
-                                   out_buf + 1, AUDIO_CHANNELS,
-                                   (int) frame_bytes_lc3, encoded_frame + big_sdu / 2);
-                        ble_iso_tx(chans[0].handle, encoded_frame, big_sdu);
-                    } else {
-                        ble_iso_tx(chans[0].handle, encoded_frame, big_sdu);
-                        memset(encoded_frame, 0, sizeof(encoded_frame));
-                        lc3_encode(chans[1].encoder, LC3_PCM_FORMAT_S16, out_buf + 1,
-                                   AUDIO_CHANNELS, (int) frame_bytes_lc3,
-                                   encoded_frame);
-                        ble_iso_tx(chans[1].handle, encoded_frame, big_sdu);
-                    }
-                } else {
-                    ble_iso_tx(chans[0].handle, encoded_frame, big_sdu);
-                }
-
-                if (out_idx / AUDIO_CHANNELS >= LC3_FPDT) {
-                    out_idx -= LC3_FPDT * AUDIO_CHANNELS;
-                    memmove(out_buf, &out_buf[LC3_FPDT * AUDIO_CHANNELS],
-                            out_idx * AUDIO_SAMPLE_SIZE);
-                } else {
-                    out_idx = 0;
-                }
-            }
-        }
-    }
+    ble_audio_source_pipeline_process(pipeline);
 }
 
 bool
@@ -251,6 +140,20 @@ tud_audio_rx_done_post_read_cb(uint8_t rhport, uint16_t n_bytes_received,
 static void
 audio_usb_init(void)
 {
+    struct ble_audio_source_pipeline_bis bis[BIG_NUM_BIS];
+    struct ble_audio_source_pipeline_params params = {
+        .source = &usb_source,
+        .pcm_sample_rate = MYNEWT_VAL(USB_AUDIO_OUT_SAMPLE_RATE),
+        .pcm_chan_cnt = AUDIO_CHANNELS,
+        .sample_rate = LC3_SAMPLING_FREQ,
+        .frame_duration = LC3_FRAME_DURATION,
+        .octets_per_frame = lc3_frame_bytes(LC3_FRAME_DURATION, LC3_BITRATE),
+        .resample = MYNEWT_VAL(ISO_HCI_FEEDBACK),
+        .bis_cnt = BIG_NUM_BIS,
+        .bis = bis,
+    };
+    int rc;
+
     /* Need to reference those explicitly, so they are always pulled by linker
      * instead of weak symbols in tinyusb.
      */
@@ -261,32 +164,26 @@ audio_usb_init(void)
     assert(LC3_FPDT == lc3_frame_samples(LC3_FRAME_DURATION,
                                          AUDIO_PCM_SAMPLE_RATE));
 
-    unsigned esize = lc3_encoder_size(LC3_FRAME_DURATION,
-                                      AUDIO_PCM_SAMPLE_RATE);
-    for (int i = 0; i < AUDIO_CHANNELS; i++) {
-        chans[i].encoder = calloc(1, esize);
-        lc3_setup_encoder(LC3_FRAME_DURATION, LC3_SAMPLING_FREQ,
-                          AUDIO_PCM_SAMPLE_RATE, chans[i].encoder);
+    if (BIG_NUM_BIS == 1) {
+        /* Both channels in single BIS */
+        bis[0].chan_idx = 0;
+        bis[0].chan_cnt = AUDIO_CHANNELS;
+    } else {
+        for (int i = 0; i < BIG_NUM_BIS; i++) {
+            bis[i].chan_idx = i;
+            bis[i].chan_cnt = 1;
+        }
     }
 
-    g_usb_enabled = 1;
+    rc = ble_audio_source_pipeline_create(&params, &pipeline);
+    assert(rc == 0);
 
-    frame_bytes_lc3 = lc3_frame_bytes(LC3_FRAME_DURATION, LC3_BITRATE);
-    big_sdu = frame_bytes_lc3 *
-              (1 + ((AUDIO_CHANNELS == 2) && (BIG_NUM_BIS == 1)));
+    g_usb_enabled = 1;
 
 #if MYNEWT_VAL(ISO_HCI_FEEDBACK)
-    int rc;
-
-    assert(resampler_state == NULL);
-    resampler_state = src_new(SRC_SINC_FASTEST, AUDIO_CHANNELS, NULL);
-    assert(resampler_state != NULL);
-
     rc = ble_gap_event_listener_register(&feedback_listener,
                                          ble_hs_gap_event_handler, NULL);
     assert(rc == 0);
-
-    resampler_ratio = resampler_out_rate / resampler_in_rate;
 #endif
 }
 #else
@@ -375,4 +272,11 @@ audio_chan_set_conn_handle(uint8_t chan_idx, uint16_t conn_handle)
 {
     assert(chan_idx < ARRAY_SIZE(chans));
     chans[chan_idx].handle = conn_handle;
+
+#if MYNEWT_VAL(AUDIO_USB)
+    if (chan_idx < BIG_NUM_BIS) {
+        ble_audio_source_pipeline_bis_handle_set(pipeline, chan_idx,
+                                                 conn_handle);
+    }
+#endif
 }
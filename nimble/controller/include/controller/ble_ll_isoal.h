@@ -27,6 +27,20 @@
 extern "C" {
 #endif
 
+/* Position in SDU queue at which PDU (framed) or SDU (unframed) data starts */
+struct ble_ll_isoal_mux_pos {
+    struct os_mbuf_pkthdr *pkthdr;
+    /* Mbuf in SDU chain and offset in it to copy data from */
+    struct os_mbuf *om;
+    uint16_t om_off;
+    /* Offset in SDU */
+    uint16_t sdu_offset;
+    /* Number of SDUs left in event, including this one */
+    uint8_t num_sdu;
+    /* Segment is the Continuation of an SDU */
+    uint8_t sc;
+};
+
 struct ble_ll_isoal_mux {
 #if MYNEWT_VAL(BLE_LL_ISOAL_MUX_PREFILL)
     uint8_t active;
@@ -59,6 +73,15 @@ struct ble_ll_isoal_mux {
     uint8_t sc : 1;
     uint8_t framed : 1;
     uint8_t framing_mode : 1;
+    /* Layout covers all SDUs available for current event */
+    uint8_t layout_complete : 1;
+
+    /* Number of valid entries in layout */
+    uint8_t layout_cnt;
+    /* Start positions of PDUs (framed) or SDUs (unframed) of current event,
+     * calculated once on event start so that PDUs can be built directly.
+     */
+    struct ble_ll_isoal_mux_pos layout[MYNEWT_VAL(BLE_LL_ISOAL_MUX_LAYOUT_MAX)];
 };
 
 #define BLE_LL_ISOAL_SEGHDR(sc, cmplt, len) \
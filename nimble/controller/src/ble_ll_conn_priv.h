@@ -103,6 +103,7 @@ SLIST_HEAD(ble_ll_conn_active_list, ble_ll_conn_sm);
 STAILQ_HEAD(ble_ll_conn_free_list, ble_ll_conn_sm);
 extern struct ble_ll_conn_active_list g_ble_ll_conn_active_list;
 extern struct ble_ll_conn_free_list g_ble_ll_conn_free_list;
+extern struct ble_ll_conn_sm *g_ble_ll_conn_cur_sm;
 
 #if MYNEWT_VAL(BLE_LL_CONN_STRICT_SCHED)
 SLIST_HEAD(ble_ll_conn_css_list, ble_ll_conn_sm);
@@ -80,6 +80,163 @@ ble_ll_isoal_mux_free(struct ble_ll_isoal_mux *mux)
     STAILQ_INIT(&mux->sdu_q);
 }
 
+static void
+ble_ll_isoal_mux_pos_init(struct ble_ll_isoal_mux_pos *pos,
+                          struct os_mbuf_pkthdr *pkthdr, uint8_t num_sdu,
+                          uint8_t sc)
+{
+    pos->pkthdr = pkthdr;
+    pos->om = pkthdr ? OS_MBUF_PKTHDR_TO_MBUF(pkthdr) : NULL;
+    pos->om_off = 0;
+    pos->sdu_offset = 0;
+    pos->num_sdu = num_sdu;
+    pos->sc = sc;
+}
+
+/* Copies len bytes of SDU data from pos, one contiguous span of each mbuf at
+ * a time, and advances pos. If dptr is NULL, pos is only advanced.
+ */
+static void
+ble_ll_isoal_mux_pos_copy(struct ble_ll_isoal_mux_pos *pos, uint16_t len,
+                          uint8_t *dptr)
+{
+    uint16_t span;
+
+    while (len > 0) {
+        BLE_LL_ASSERT(pos->om);
+
+        span = min(len, pos->om->om_len - pos->om_off);
+        if (dptr) {
+            memcpy(dptr, pos->om->om_data + pos->om_off, span);
+            dptr += span;
+        }
+
+        len -= span;
+        pos->om_off += span;
+
+        if (pos->om_off == pos->om->om_len) {
+            pos->om = SLIST_NEXT(pos->om, om_next);
+            pos->om_off = 0;
+        }
+    }
+}
+
+/* Builds single framed PDU starting at pos, packing as many segments of
+ * subsequent SDUs as fit, and advances pos to start of next PDU. If dptr is
+ * NULL, PDU is not written and only its length is calculated.
+ */
+static uint8_t
+ble_ll_isoal_mux_framed_pdu(struct ble_ll_isoal_mux *mux,
+                            struct ble_ll_isoal_mux_pos *pos, uint8_t *dptr)
+{
+    struct ble_mbuf_hdr *blehdr;
+    struct os_mbuf *om;
+    uint32_t time_offset;
+    uint16_t seghdr;
+    uint16_t rem_len;
+    uint8_t frag_len;
+    uint8_t pdu_offset = 0;
+    uint8_t hdr_len;
+
+    while (pos->pkthdr && pos->num_sdu > 0) {
+        om = OS_MBUF_PKTHDR_TO_MBUF(pos->pkthdr);
+
+        rem_len = OS_MBUF_PKTLEN(om) - pos->sdu_offset;
+        hdr_len = pos->sc ? 2 /* Segmentation Header */
+                          : 5 /* Segmentation Header + TimeOffset */;
+
+        if (mux->max_pdu <= hdr_len + pdu_offset) {
+            break;
+        }
+
+        frag_len = min(rem_len, mux->max_pdu - hdr_len - pdu_offset);
+
+        if (dptr) {
+            /* Segmentation Header */
+            seghdr = BLE_LL_ISOAL_SEGHDR(pos->sc, frag_len == rem_len,
+                                         frag_len + hdr_len - 2);
+            put_le16(dptr + pdu_offset, seghdr);
+
+            /* Time Offset */
+            if (hdr_len > 2) {
+                blehdr = BLE_MBUF_HDR_PTR(om);
+
+                time_offset = mux->event_tx_timestamp -
+                              blehdr->txiso.cpu_timestamp;
+                put_le24(dptr + pdu_offset + 2, time_offset);
+            }
+
+            /* ISO Data Fragment */
+            ble_ll_isoal_mux_pos_copy(pos, frag_len,
+                                      dptr + pdu_offset + hdr_len);
+        } else {
+            ble_ll_isoal_mux_pos_copy(pos, frag_len, NULL);
+        }
+
+        pdu_offset += hdr_len + frag_len;
+
+        if (frag_len == rem_len) {
+            /* Process next SDU */
+            ble_ll_isoal_mux_pos_init(pos, STAILQ_NEXT(pos->pkthdr, omp_next),
+                                      pos->num_sdu - 1, 0);
+        } else {
+            pos->sdu_offset += frag_len;
+            pos->sc = 1;
+        }
+    }
+
+    return pdu_offset;
+}
+
+/* Calculates start positions of PDUs of current event. Only bn PDUs are sent
+ * in an event, so layout ends at position of PDU bn which is where next event
+ * starts. If all SDUs are covered, last entry is position past last SDU.
+ */
+static void
+ble_ll_isoal_mux_framed_layout(struct ble_ll_isoal_mux *mux)
+{
+    struct ble_ll_isoal_mux_pos pos;
+    uint8_t layout_max;
+
+    layout_max = min(mux->bn + 1, MYNEWT_VAL(BLE_LL_ISOAL_MUX_LAYOUT_MAX));
+
+    ble_ll_isoal_mux_pos_init(&pos, STAILQ_FIRST(&mux->sdu_q),
+                              mux->sdu_in_event, mux->sc);
+
+    mux->layout_cnt = 0;
+    mux->layout_complete = 0;
+
+    while (mux->layout_cnt < layout_max) {
+        mux->layout[mux->layout_cnt++] = pos;
+
+        if (!pos.pkthdr || pos.num_sdu == 0) {
+            mux->layout_complete = 1;
+            break;
+        }
+
+        ble_ll_isoal_mux_framed_pdu(mux, &pos, NULL);
+    }
+}
+
+static void
+ble_ll_isoal_mux_unframed_layout(struct ble_ll_isoal_mux *mux)
+{
+    struct os_mbuf_pkthdr *pkthdr;
+
+    pkthdr = STAILQ_FIRST(&mux->sdu_q);
+
+    mux->layout_cnt = 0;
+    while (pkthdr && mux->layout_cnt < mux->sdu_in_event &&
+           mux->layout_cnt < MYNEWT_VAL(BLE_LL_ISOAL_MUX_LAYOUT_MAX)) {
+        ble_ll_isoal_mux_pos_init(&mux->layout[mux->layout_cnt], pkthdr,
+                                  mux->sdu_in_event - mux->layout_cnt, 0);
+        mux->layout_cnt++;
+        pkthdr = STAILQ_NEXT(pkthdr, omp_next);
+    }
+
+    mux->layout_complete = !pkthdr || mux->layout_cnt == mux->sdu_in_event;
+}
+
 void
 ble_ll_isoal_mux_sdu_enqueue(struct ble_ll_isoal_mux *mux, struct os_mbuf *om)
 {
@@ -126,6 +283,12 @@ ble_ll_isoal_mux_event_start(struct ble_ll_isoal_mux *mux, uint32_t timestamp)
 #endif
     mux->event_tx_timestamp = timestamp;
 
+    if (mux->framed) {
+        ble_ll_isoal_mux_framed_layout(mux);
+    } else {
+        ble_ll_isoal_mux_unframed_layout(mux);
+    }
+
     return mux->sdu_in_event;
 }
 
@@ -182,17 +345,13 @@ ble_ll_isoal_mux_unframed_event_done(struct ble_ll_isoal_mux *mux)
 static int
 ble_ll_isoal_mux_framed_event_done(struct ble_ll_isoal_mux *mux)
 {
+    struct ble_ll_isoal_mux_pos pos;
     struct os_mbuf_pkthdr *pkthdr;
     struct os_mbuf *om;
     struct os_mbuf *om_next;
     uint8_t num_sdu;
     uint8_t num_pdu;
-    uint8_t pdu_offset = 0;
-    uint8_t frag_len = 0;
-    uint8_t rem_len = 0;
-    uint8_t hdr_len = 0;
     int pkt_freed = 0;
-    bool sc = mux->sc;
     os_sr_t sr;
 
     num_sdu = mux->sdu_in_event;
@@ -200,8 +359,6 @@ ble_ll_isoal_mux_framed_event_done(struct ble_ll_isoal_mux *mux)
         return 0;
     }
 
-    num_pdu = mux->bn;
-
 #if MYNEWT_VAL(BLE_LL_ISO_HCI_DISCARD_THRESHOLD)
     /* Drop queued SDUs if number of queued SDUs exceeds defined threshold.
      * Threshold is defined as number of ISO events. If number of queued SDUs
@@ -216,55 +373,49 @@ ble_ll_isoal_mux_framed_event_done(struct ble_ll_isoal_mux *mux)
     }
 #endif
 
-    /* Drop num_pdu PDUs */
-    pkthdr = STAILQ_FIRST(&mux->sdu_q);
-    while (pkthdr && num_sdu--) {
-        om = OS_MBUF_PKTHDR_TO_MBUF(pkthdr);
-
-        while (om && num_pdu > 0) {
-            rem_len = om->om_len;
-            hdr_len = sc ? 2 /* Segmentation Header */
-                         : 5 /* Segmentation Header + TimeOffset */;
-
-            if (mux->max_pdu <= hdr_len + pdu_offset) {
-                /* Advance to next PDU */
-                pdu_offset = 0;
-                num_pdu--;
-                continue;
-            }
-
-            frag_len = min(rem_len, mux->max_pdu - hdr_len - pdu_offset);
-
-            pdu_offset += hdr_len + frag_len;
-
-            os_mbuf_adj(om, frag_len);
-
-            if (frag_len == rem_len) {
-                om_next = SLIST_NEXT(om, om_next);
-                os_mbuf_free(om);
-                pkt_freed++;
-                om = om_next;
-            } else {
-                sc = 1;
-            }
+    /* Find where next event starts, i.e. position after bn PDUs */
+    if (num_sdu == mux->sdu_in_event && mux->bn < mux->layout_cnt) {
+        pos = mux->layout[mux->bn];
+    } else if (num_sdu == mux->sdu_in_event) {
+        pos = mux->layout[mux->layout_cnt - 1];
+        for (num_pdu = mux->layout_cnt - 1;
+             !mux->layout_complete && num_pdu < mux->bn; num_pdu++) {
+            ble_ll_isoal_mux_framed_pdu(mux, &pos, NULL);
         }
-
-        if (num_pdu == 0) {
-            break;
+    } else {
+        ble_ll_isoal_mux_pos_init(&pos, STAILQ_FIRST(&mux->sdu_q), num_sdu,
+                                  mux->sc);
+        for (num_pdu = 0; num_pdu < mux->bn; num_pdu++) {
+            ble_ll_isoal_mux_framed_pdu(mux, &pos, NULL);
         }
+    }
 
+    /* Drop SDUs which were sent completely */
+    num_sdu -= pos.num_sdu;
+    while (num_sdu--) {
         OS_ENTER_CRITICAL(sr);
+        pkthdr = STAILQ_FIRST(&mux->sdu_q);
         STAILQ_REMOVE_HEAD(&mux->sdu_q, omp_next);
         BLE_LL_ASSERT(mux->sdu_q_len > 0);
         mux->sdu_q_len--;
         OS_EXIT_CRITICAL(sr);
 
-        sc = 0;
-        pkthdr = STAILQ_FIRST(&mux->sdu_q);
+        om = OS_MBUF_PKTHDR_TO_MBUF(pkthdr);
+        while (om) {
+            om_next = SLIST_NEXT(om, om_next);
+            os_mbuf_free(om);
+            pkt_freed++;
+            om = om_next;
+        }
+    }
+
+    /* Trim segments already sent from SDU which continues in next event */
+    if (pos.num_sdu > 0 && pos.sdu_offset > 0) {
+        os_mbuf_adj(OS_MBUF_PKTHDR_TO_MBUF(pos.pkthdr), pos.sdu_offset);
     }
 
     mux->sdu_in_event = 0;
-    mux->sc = sc;
+    mux->sc = pos.num_sdu > 0 && pos.sc;
 
     return pkt_freed;
 }
@@ -311,9 +462,16 @@ ble_ll_isoal_mux_unframed_get(struct ble_ll_isoal_mux *mux, uint8_t idx,
         return 0;
     }
 
-    pkthdr = STAILQ_FIRST(&mux->sdu_q);
-    while (pkthdr && sdu_idx--) {
-        pkthdr = STAILQ_NEXT(pkthdr, omp_next);
+    if (sdu_idx < mux->layout_cnt) {
+        pkthdr = mux->layout[sdu_idx].pkthdr;
+    } else if (mux->layout_complete) {
+        pkthdr = NULL;
+    } else {
+        sdu_idx -= mux->layout_cnt - 1;
+        pkthdr = mux->layout[mux->layout_cnt - 1].pkthdr;
+        while (pkthdr && sdu_idx--) {
+            pkthdr = STAILQ_NEXT(pkthdr, omp_next);
+        }
     }
 
     if (!pkthdr) {
@@ -352,116 +510,34 @@ static int
 ble_ll_isoal_mux_framed_get(struct ble_ll_isoal_mux *mux, uint8_t idx,
                             uint8_t *llid, uint8_t *dptr)
 {
-    struct ble_mbuf_hdr *blehdr;
-    struct os_mbuf_pkthdr *pkthdr;
-    struct os_mbuf *om;
-    uint32_t time_offset;
-    uint16_t seghdr;
-    uint16_t rem_len = 0;
-    uint16_t sdu_offset = 0;
-    uint8_t num_sdu;
+    struct ble_ll_isoal_mux_pos pos;
     uint8_t num_pdu;
-    uint8_t frag_len;
-    uint8_t pdu_offset = 0;
-    bool sc = mux->sc;
-    uint8_t hdr_len = 0;
 
     *llid = 0b10;
 
-    num_sdu = mux->sdu_in_event;
-    if (num_sdu == 0) {
+    if (mux->sdu_in_event == 0) {
         return 0;
     }
 
-    num_pdu = idx;
-
-    /* Skip the idx PDUs */
-    pkthdr = STAILQ_FIRST(&mux->sdu_q);
-    while (pkthdr && num_sdu > 0 && num_pdu > 0) {
-        om = OS_MBUF_PKTHDR_TO_MBUF(pkthdr);
-
-        rem_len = OS_MBUF_PKTLEN(om) - sdu_offset;
-        hdr_len = sc ? 2 /* Segmentation Header */
-                     : 5 /* Segmentation Header + TimeOffset */;
-
-        if (mux->max_pdu <= hdr_len + pdu_offset) {
-            /* Advance to next PDU */
-            pdu_offset = 0;
-            num_pdu--;
-            continue;
-        }
-
-        frag_len = min(rem_len, mux->max_pdu - hdr_len - pdu_offset);
-
-        pdu_offset += hdr_len + frag_len;
-
-        if (frag_len == rem_len) {
-            /* Process next SDU */
-            sdu_offset = 0;
-            num_sdu--;
-            pkthdr = STAILQ_NEXT(pkthdr, omp_next);
-
-            sc = 0;
-        } else {
-            sdu_offset += frag_len;
-
-            sc = 1;
-        }
-    }
-
-    if (num_pdu > 0) {
+    if (idx < mux->layout_cnt) {
+        pos = mux->layout[idx];
+    } else if (mux->layout_complete) {
         return 0;
-    }
-
-    BLE_LL_ASSERT(pdu_offset == 0);
-
-    while (pkthdr && num_sdu > 0) {
-        om = OS_MBUF_PKTHDR_TO_MBUF(pkthdr);
-
-        rem_len = OS_MBUF_PKTLEN(om) - sdu_offset;
-        hdr_len = sc ? 2 /* Segmentation Header */
-                     : 5 /* Segmentation Header + TimeOffset */;
-
-        if (mux->max_pdu <= hdr_len + pdu_offset) {
-            break;
-        }
-
-        frag_len = min(rem_len, mux->max_pdu - hdr_len - pdu_offset);
-
-        /* Segmentation Header */
-        seghdr = BLE_LL_ISOAL_SEGHDR(sc, frag_len == rem_len, frag_len + hdr_len - 2);
-        put_le16(dptr + pdu_offset, seghdr);
-        pdu_offset += 2;
-
-        /* Time Offset */
-        if (hdr_len > 2) {
-            blehdr = BLE_MBUF_HDR_PTR(om);
-
-            time_offset = mux->event_tx_timestamp -
-                          blehdr->txiso.cpu_timestamp;
-            put_le24(dptr + pdu_offset, time_offset);
-            pdu_offset += 3;
+    } else {
+        /* Skip PDUs following last one in layout */
+        pos = mux->layout[mux->layout_cnt - 1];
+        num_pdu = idx - mux->layout_cnt + 1;
+        while (pos.pkthdr && pos.num_sdu > 0 && num_pdu > 0) {
+            ble_ll_isoal_mux_framed_pdu(mux, &pos, NULL);
+            num_pdu--;
         }
 
-        /* ISO Data Fragment */
-        os_mbuf_copydata(om, sdu_offset, frag_len, dptr + pdu_offset);
-        pdu_offset += frag_len;
-
-        if (frag_len == rem_len) {
-            /* Process next SDU */
-            sdu_offset = 0;
-            num_sdu--;
-            pkthdr = STAILQ_NEXT(pkthdr, omp_next);
-
-            sc = 0;
-        } else {
-            sdu_offset += frag_len;
-
-            sc = 1;
+        if (num_pdu > 0) {
+            return 0;
         }
     }
 
-    return pdu_offset;
+    return ble_ll_isoal_mux_framed_pdu(mux, &pos, dptr);
 }
 
 int
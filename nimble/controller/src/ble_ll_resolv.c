@@ -48,6 +48,25 @@ struct ble_ll_resolv_data g_ble_ll_resolv_data;
 __attribute__((aligned(4)))
 struct ble_ll_resolv_entry g_ble_ll_resolv_list[MYNEWT_VAL(BLE_LL_RESOLV_LIST_SIZE)];
 
+#if MYNEWT_VAL(BLE_LL_RESOLV_RPA_CACHE_SIZE)
+/*
+ * Cache of recently resolved peer RPAs. Cache is direct mapped and indexed
+ * with hash part of RPA, which is AES output so is uniformly distributed.
+ * Entries with negative index are RPAs which did not resolve with any IRK on
+ * the list so packets from unknown private devices are also handled without
+ * AES. Cache is flushed on every resolving list change (entries are moved in
+ * the list) and on RPA timeout.
+ */
+struct ble_ll_resolv_rpa_cache_entry {
+    uint8_t valid;
+    int16_t rl_idx;
+    uint8_t rpa[BLE_DEV_ADDR_LEN];
+};
+
+static struct ble_ll_resolv_rpa_cache_entry
+            g_ble_ll_resolv_rpa_cache[MYNEWT_VAL(BLE_LL_RESOLV_RPA_CACHE_SIZE)];
+#endif
+
 #if MYNEWT_VAL(BLE_LL_HCI_VS_LOCAL_IRK)
 struct local_irk_data {
     uint8_t is_set;
@@ -80,6 +99,34 @@ ble_ll_resolv_list_chg_allowed(void)
     return rc;
 }
 
+#if MYNEWT_VAL(BLE_LL_RESOLV_RPA_CACHE_SIZE)
+static struct ble_ll_resolv_rpa_cache_entry *
+ble_ll_resolv_rpa_cache_slot(const uint8_t *rpa)
+{
+    uint8_t hash;
+
+    hash = rpa[0] ^ rpa[1] ^ rpa[2];
+
+    return &g_ble_ll_resolv_rpa_cache[hash %
+                                      MYNEWT_VAL(BLE_LL_RESOLV_RPA_CACHE_SIZE)];
+}
+
+static void
+ble_ll_resolv_rpa_cache_flush(void)
+{
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+    memset(g_ble_ll_resolv_rpa_cache, 0, sizeof(g_ble_ll_resolv_rpa_cache));
+    OS_EXIT_CRITICAL(sr);
+}
+#else
+static inline void
+ble_ll_resolv_rpa_cache_flush(void)
+{
+}
+#endif
+
 static void
 generate_rpa(const uint8_t *irk, uint8_t *rpa)
 {
@@ -173,6 +220,9 @@ ble_ll_resolv_rpa_timer_cb(struct ble_npl_event *ev)
     }
 #endif
 
+    /* Peers are expected to change their RPAs as well */
+    ble_ll_resolv_rpa_cache_flush();
+
     ble_npl_callout_reset(&g_ble_ll_resolv_data.rpa_timer,
                           g_ble_ll_resolv_data.rpa_tmo);
 
@@ -223,6 +273,7 @@ ble_ll_resolv_list_clr(void)
     g_ble_ll_resolv_data.rl_cnt_hw = 0;
     g_ble_ll_resolv_data.rl_cnt = 0;
     ble_hw_resolv_list_clear();
+    ble_ll_resolv_rpa_cache_flush();
 
     /* stop RPA timer when clearing RL */
     ble_npl_callout_stop(&g_ble_ll_resolv_data.rpa_timer);
@@ -384,6 +435,7 @@ ble_ll_resolv_list_add(const uint8_t *cmdbuf, uint8_t len)
     }
 
     g_ble_ll_resolv_data.rl_cnt++;
+    ble_ll_resolv_rpa_cache_flush();
 
     /* start RPA timer if this was first element added to RL */
     if (g_ble_ll_resolv_data.rl_cnt == 1) {
@@ -426,6 +478,7 @@ ble_ll_resolv_list_rmv(const uint8_t *cmdbuf, uint8_t len)
                 (g_ble_ll_resolv_data.rl_cnt - position) *
                 sizeof(g_ble_ll_resolv_list[0]));
         g_ble_ll_resolv_data.rl_cnt--;
+        ble_ll_resolv_rpa_cache_flush();
 
         /* Remove from HW list */
         if (position <= g_ble_ll_resolv_data.rl_cnt_hw) {
@@ -767,18 +820,57 @@ ble_ll_resolv_rpa(const uint8_t *rpa, const uint8_t *irk)
     return rc;
 }
 
+/**
+ * Find resolving list entry with peer IRK that resolves given RPA.
+ *
+ * Recently resolved RPAs (also those which did not resolve) are served from
+ * cache so only first packet from given private device requires AES
+ * operation for each resolving list entry.
+ *
+ * @param rpa
+ *
+ * @return int  Resolving list index or -1 if RPA did not resolve
+ */
 int
 ble_ll_resolv_peer_rpa_any(const uint8_t *rpa)
 {
+#if MYNEWT_VAL(BLE_LL_RESOLV_RPA_CACHE_SIZE)
+    struct ble_ll_resolv_rpa_cache_entry *entry;
+    os_sr_t sr;
+#endif
+    int rl_idx;
     int i;
 
+#if MYNEWT_VAL(BLE_LL_RESOLV_RPA_CACHE_SIZE)
+    entry = ble_ll_resolv_rpa_cache_slot(rpa);
+
+    OS_ENTER_CRITICAL(sr);
+    if (entry->valid && !memcmp(entry->rpa, rpa, BLE_DEV_ADDR_LEN)) {
+        rl_idx = entry->rl_idx;
+        OS_EXIT_CRITICAL(sr);
+        return rl_idx;
+    }
+    OS_EXIT_CRITICAL(sr);
+#endif
+
+    rl_idx = -1;
+
     for (i = 0; i < g_ble_ll_resolv_data.rl_cnt_hw; i++) {
         if (ble_ll_resolv_rpa(rpa, g_ble_ll_resolv_list[i].rl_peer_irk)) {
-            return i;
+            rl_idx = i;
+            break;
         }
     }
 
-    return -1;
+#if MYNEWT_VAL(BLE_LL_RESOLV_RPA_CACHE_SIZE)
+    OS_ENTER_CRITICAL(sr);
+    entry->valid = 1;
+    entry->rl_idx = rl_idx;
+    memcpy(entry->rpa, rpa, BLE_DEV_ADDR_LEN);
+    OS_EXIT_CRITICAL(sr);
+#endif
+
+    return rl_idx;
 }
 
 /**
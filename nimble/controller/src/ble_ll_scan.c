@@ -767,6 +767,8 @@ ble_ll_scan_start(struct ble_ll_scan_sm *scansm)
     rc = ble_phy_setchan(chan, BLE_ACCESS_ADDR_ADV, BLE_LL_CRCINIT_ADV);
     BLE_LL_ASSERT(rc == 0);
 
+    ble_ll_trace_u32x2(BLE_LL_TRACE_ID_SCAN_START, chan, scanp->scan_type);
+
     /*
      * Set transmit end callback to NULL in case we transmit a scan request.
      * There is a callback for the connect request.
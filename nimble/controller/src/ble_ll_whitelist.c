@@ -30,21 +30,58 @@
 #include "controller/ble_ll_scan.h"
 #include "controller/ble_hw.h"
 
-#if (MYNEWT_VAL(BLE_LL_WHITELIST_SIZE) < BLE_HW_WHITE_LIST_SIZE)
+/*
+ * HW whitelist limits number of entries we can handle, otherwise whitelist
+ * is only limited by configured size.
+ */
+#if (BLE_USES_HW_WHITELIST == 1) && \
+    (MYNEWT_VAL(BLE_LL_WHITELIST_SIZE) > BLE_HW_WHITE_LIST_SIZE)
+#define BLE_LL_WHITELIST_SIZE       BLE_HW_WHITE_LIST_SIZE
+#else
 #define BLE_LL_WHITELIST_SIZE       MYNEWT_VAL(BLE_LL_WHITELIST_SIZE)
+#endif
+
+#if (BLE_LL_WHITELIST_SIZE > 255)
+    #error "Whitelist cannot have more than 255 entries!"
+#endif
+
+/* One hash bucket per entry is enough to keep chains short */
+#if (BLE_LL_WHITELIST_SIZE > 0)
+#define BLE_LL_WHITELIST_HASH_SIZE  (BLE_LL_WHITELIST_SIZE)
 #else
-#define BLE_LL_WHITELIST_SIZE       BLE_HW_WHITE_LIST_SIZE
+#define BLE_LL_WHITELIST_HASH_SIZE  (1)
 #endif
 
 struct ble_ll_whitelist_entry
 {
     uint8_t wl_valid;
     uint8_t wl_addr_type;
+    /* Next entry in hash bucket ('position', 0 terminates chain) */
+    uint8_t wl_next;
     uint8_t wl_dev_addr[BLE_DEV_ADDR_LEN];
 };
 
 struct ble_ll_whitelist_entry g_ble_ll_whitelist[BLE_LL_WHITELIST_SIZE];
 
+/* First entry in each hash bucket ('position', 0 means empty bucket) */
+static uint8_t g_ble_ll_whitelist_hash[BLE_LL_WHITELIST_HASH_SIZE];
+
+static inline int
+ble_ll_whitelist_hash(const uint8_t *addr, uint8_t addr_type)
+{
+    uint32_t hash;
+
+    /*
+     * Fold address halves so both company assigned (public address) and
+     * random parts contribute.
+     */
+    hash = (addr[0] ^ addr[3] ^ addr_type) |
+           ((addr[1] ^ addr[4]) << 8) |
+           ((uint32_t)(addr[2] ^ addr[5]) << 16);
+
+    return hash % BLE_LL_WHITELIST_HASH_SIZE;
+}
+
 static int
 ble_ll_whitelist_chg_allowed(void)
 {
@@ -90,9 +127,12 @@ ble_ll_whitelist_clear(void)
     wl = &g_ble_ll_whitelist[0];
     for (i = 0; i < BLE_LL_WHITELIST_SIZE; ++i) {
         wl->wl_valid = 0;
+        wl->wl_next = 0;
         ++wl;
     }
 
+    memset(g_ble_ll_whitelist_hash, 0, sizeof(g_ble_ll_whitelist_hash));
+
 #if (BLE_USES_HW_WHITELIST == 1)
     ble_hw_whitelist_clear();
 #endif
@@ -135,16 +175,17 @@ ble_ll_whitelist_read_size(uint8_t *rspbuf, uint8_t *rsplen)
 static int
 ble_ll_whitelist_search(const uint8_t *addr, uint8_t addr_type)
 {
-    int i;
+    int position;
     struct ble_ll_whitelist_entry *wl;
 
-    wl = &g_ble_ll_whitelist[0];
-    for (i = 0; i < BLE_LL_WHITELIST_SIZE; ++i) {
-        if ((wl->wl_valid) && (wl->wl_addr_type == addr_type) &&
+    position = g_ble_ll_whitelist_hash[ble_ll_whitelist_hash(addr, addr_type)];
+    while (position) {
+        wl = &g_ble_ll_whitelist[position - 1];
+        if ((wl->wl_addr_type == addr_type) &&
             (!memcmp(&wl->wl_dev_addr[0], addr, BLE_DEV_ADDR_LEN))) {
-            return i + 1;
+            return position;
         }
-        ++wl;
+        position = wl->wl_next;
     }
 
     return 0;
@@ -194,6 +235,7 @@ ble_ll_whitelist_add(const uint8_t *cmdbuf, uint8_t len)
 {
     const struct ble_hci_le_add_whte_list_cp *cmd = (const void *) cmdbuf;
     struct ble_ll_whitelist_entry *wl;
+    uint8_t *head;
     int rc;
     int i;
 
@@ -215,6 +257,11 @@ ble_ll_whitelist_add(const uint8_t *cmdbuf, uint8_t len)
                 memcpy(&wl->wl_dev_addr[0], cmd->addr, BLE_DEV_ADDR_LEN);
                 wl->wl_addr_type = cmd->addr_type;
                 wl->wl_valid = 1;
+
+                head = &g_ble_ll_whitelist_hash[
+                        ble_ll_whitelist_hash(cmd->addr, cmd->addr_type)];
+                wl->wl_next = *head;
+                *head = i + 1;
                 break;
             }
             ++wl;
@@ -243,6 +290,8 @@ int
 ble_ll_whitelist_rmv(const uint8_t *cmdbuf, uint8_t len)
 {
     const struct ble_hci_le_rmv_white_list_cp *cmd = (const void *) cmdbuf;
+    struct ble_ll_whitelist_entry *wl;
+    uint8_t *next;
     int position;
 
     if (len != sizeof(*cmd)) {
@@ -256,7 +305,17 @@ ble_ll_whitelist_rmv(const uint8_t *cmdbuf, uint8_t len)
 
     position = ble_ll_whitelist_search(cmd->addr, cmd->addr_type);
     if (position) {
-        g_ble_ll_whitelist[position - 1].wl_valid = 0;
+        /* Unlink entry from its hash bucket */
+        next = &g_ble_ll_whitelist_hash[
+                ble_ll_whitelist_hash(cmd->addr, cmd->addr_type)];
+        while (*next != position) {
+            next = &g_ble_ll_whitelist[*next - 1].wl_next;
+        }
+
+        wl = &g_ble_ll_whitelist[position - 1];
+        *next = wl->wl_next;
+        wl->wl_next = 0;
+        wl->wl_valid = 0;
     }
 
 #if (BLE_USES_HW_WHITELIST == 1)
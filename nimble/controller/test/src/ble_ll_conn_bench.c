@@ -0,0 +1,258 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * Benchmark of connection per-PDU hot paths. Link Layer is driven through
+ * simulated native PHY so the same code that runs in radio ISR is measured:
+ * rx start/end handling (ble_ll_conn_rx_isr_start(), ble_ll_conn_rx_isr_end())
+ * including reply transmission (ble_ll_conn_tx_pdu()), followed by LL task
+ * processing of received PDU (ble_ll_conn_rx_data_pdu()).
+ *
+ * Results are reported in host CPU cycles (or nanoseconds if cycle counter
+ * is not available) and are meant for tracking regressions, not for absolute
+ * numbers on target.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <time.h>
+#include <os/os.h>
+#include <os/os_mbuf.h>
+#include <nimble/ble.h>
+#include <controller/ble_ll.h>
+#include <controller/ble_ll_conn.h>
+#include <controller/ble_phy.h>
+#include <ble/xcvr.h>
+#include <testutil/testutil.h>
+#include "ble_ll_conn_priv.h"
+
+#define BLE_LL_CONN_BENCH_ITERATIONS    (1000)
+#define BLE_LL_CONN_BENCH_ACCESS_ADDR   (0x71764129)
+
+struct ble_ll_conn_bench_result {
+    uint64_t isr;
+    uint64_t ll;
+    uint32_t pdus;
+};
+
+static inline uint64_t
+ble_ll_conn_bench_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+static struct ble_ll_conn_sm *
+ble_ll_conn_bench_setup(int encrypted)
+{
+    struct ble_ll_conn_sm *connsm;
+
+    connsm = ble_ll_conn_sm_get();
+    TEST_ASSERT_FATAL(connsm != NULL);
+
+    connsm->conn_role = BLE_LL_CONN_ROLE_PERIPHERAL;
+    ble_ll_conn_sm_new(connsm);
+
+    connsm->conn_state = BLE_LL_CONN_STATE_ESTABLISHED;
+    connsm->access_addr = BLE_LL_CONN_BENCH_ACCESS_ADDR;
+    connsm->eff_max_tx_octets = BLE_LL_CONN_SUPP_BYTES_MAX;
+    connsm->eff_max_rx_octets = BLE_LL_CONN_SUPP_BYTES_MAX;
+    connsm->eff_max_tx_time = BLE_LL_CONN_SUPP_TIME_MAX_UNCODED;
+    connsm->eff_max_rx_time = BLE_LL_CONN_SUPP_TIME_MAX_UNCODED;
+    connsm->ota_max_rx_time = BLE_LL_CONN_SUPP_TIME_MAX_UNCODED;
+
+#if MYNEWT_VAL(BLE_LL_CFG_FEAT_LE_ENCRYPTION)
+    if (encrypted) {
+        connsm->enc_data.enc_state = CONN_ENC_S_ENCRYPTED;
+        connsm->enc_data.tx_encrypted = 1;
+        connsm->flags.encrypted = 1;
+        ble_phy_encrypt_enable(connsm->enc_data.enc_block.cipher_text);
+    }
+#endif
+
+    g_ble_ll_conn_cur_sm = connsm;
+    ble_ll_state_set(BLE_LL_STATE_CONNECTION);
+
+    ble_phy_disable();
+    ble_phy_setchan(0, connsm->access_addr, connsm->crcinit);
+    ble_phy_rx();
+
+    return connsm;
+}
+
+static void
+ble_ll_conn_bench_teardown(struct ble_ll_conn_sm *connsm)
+{
+    struct os_mbuf_pkthdr *pkthdr;
+
+    ble_phy_sim_tx_end();
+    ble_phy_disable();
+#if MYNEWT_VAL(BLE_LL_CFG_FEAT_LE_ENCRYPTION)
+    ble_phy_encrypt_disable();
+#endif
+
+    g_ble_ll_conn_cur_sm = NULL;
+    ble_ll_state_set(BLE_LL_STATE_STANDBY);
+
+#if MYNEWT_VAL(BLE_LL_CFG_FEAT_LE_PING)
+    ble_npl_callout_stop(&connsm->auth_pyld_timer);
+#endif
+
+    if (connsm->cur_tx_pdu) {
+        os_mbuf_free_chain(connsm->cur_tx_pdu);
+        connsm->cur_tx_pdu = NULL;
+    }
+
+    while ((pkthdr = STAILQ_FIRST(&connsm->conn_txq)) != NULL) {
+        STAILQ_REMOVE_HEAD(&connsm->conn_txq, omp_next);
+        os_mbuf_free_chain(OS_MBUF_PKTHDR_TO_MBUF(pkthdr));
+    }
+
+    connsm->conn_state = BLE_LL_CONN_STATE_IDLE;
+    SLIST_REMOVE(&g_ble_ll_conn_active_list, connsm, ble_ll_conn_sm, act_sle);
+    STAILQ_INSERT_TAIL(&g_ble_ll_conn_free_list, connsm, free_stqe);
+}
+
+static void
+ble_ll_conn_bench_enqueue(struct ble_ll_conn_sm *connsm, uint8_t len)
+{
+    struct os_mbuf *om;
+    int rc;
+
+    om = os_msys_get_pkthdr(len, sizeof(struct ble_mbuf_hdr));
+    TEST_ASSERT_FATAL(om != NULL);
+
+    while (OS_MBUF_PKTLEN(om) < len) {
+        rc = os_mbuf_append(om, "\x55", 1);
+        TEST_ASSERT_FATAL(rc == 0);
+    }
+
+    ble_ll_conn_enqueue_pkt(connsm, om, BLE_LL_LLID_DATA_START, len);
+}
+
+static void
+ble_ll_conn_bench_run(int encrypted, uint8_t len,
+                      struct ble_ll_conn_bench_result *res)
+{
+    struct ble_ll_conn_sm *connsm;
+    struct os_mbuf_pkthdr *pkthdr;
+    struct os_mbuf *rxpdu;
+    uint8_t pdu[BLE_LL_PDU_HDR_LEN + BLE_LL_CONN_SUPP_BYTES_MAX];
+    uint64_t start;
+    uint16_t msys_free;
+    int i;
+    int rc;
+
+    memset(res, 0, sizeof(*res));
+    memset(pdu, 0xaa, sizeof(pdu));
+
+    msys_free = os_msys_num_free();
+    connsm = ble_ll_conn_bench_setup(encrypted);
+
+    for (i = 0; i < BLE_LL_CONN_BENCH_ITERATIONS; i++) {
+        /* Zero length means empty PDUs are exchanged */
+        if (len && STAILQ_EMPTY(&connsm->conn_txq)) {
+            ble_ll_conn_bench_enqueue(connsm, len);
+        }
+
+        /* Peer always sends new data, acks our last PDU and keeps event open */
+        pdu[0] = (len ? BLE_LL_LLID_DATA_START : BLE_LL_LLID_DATA_FRAG) |
+                 BLE_LL_DATA_HDR_MD_MASK;
+        if (connsm->next_exp_seqnum) {
+            pdu[0] |= BLE_LL_DATA_HDR_SN_MASK;
+        }
+        if (!connsm->tx_seqnum) {
+            pdu[0] |= BLE_LL_DATA_HDR_NESN_MASK;
+        }
+        pdu[1] = len;
+
+        start = ble_ll_conn_bench_cycles();
+        rc = ble_phy_sim_rx(pdu, BLE_LL_PDU_HDR_LEN + len);
+        res->isr += ble_ll_conn_bench_cycles() - start;
+        TEST_ASSERT_FATAL(rc == 0);
+
+        /* Connection event shall not be ended by any of the PDUs */
+        TEST_ASSERT_FATAL(g_ble_ll_conn_cur_sm == connsm);
+        TEST_ASSERT_FATAL(ble_phy_state_get() == BLE_PHY_STATE_TX);
+
+        while ((pkthdr = STAILQ_FIRST(&g_ble_ll_data.ll_rx_pkt_q)) != NULL) {
+            STAILQ_REMOVE_HEAD(&g_ble_ll_data.ll_rx_pkt_q, omp_next);
+            rxpdu = OS_MBUF_PKTHDR_TO_MBUF(pkthdr);
+
+            start = ble_ll_conn_bench_cycles();
+            ble_ll_conn_rx_data_pdu(rxpdu, BLE_MBUF_HDR_PTR(rxpdu));
+            res->ll += ble_ll_conn_bench_cycles() - start;
+        }
+
+        rc = ble_phy_sim_tx_end();
+        TEST_ASSERT_FATAL(rc == 0);
+
+        res->pdus++;
+    }
+
+    ble_ll_conn_bench_teardown(connsm);
+
+    /* Make sure nothing leaked, otherwise numbers are meaningless */
+    TEST_ASSERT(os_msys_num_free() == msys_free);
+}
+
+TEST_CASE_SELF(ble_ll_conn_bench_data_pdu) {
+    static const uint8_t lens[] = { 0, 27, 123, 251 };
+    struct ble_ll_conn_bench_result res;
+    int encrypted;
+    int i;
+
+    printf("ble_ll_conn_bench: %d PDUs per run, results in %s/PDU\n",
+           BLE_LL_CONN_BENCH_ITERATIONS,
+#if defined(__x86_64__) || defined(__i386__)
+           "cycles"
+#else
+           "ns"
+#endif
+           );
+
+    for (encrypted = 0; encrypted < 2; encrypted++) {
+#if !MYNEWT_VAL(BLE_LL_CFG_FEAT_LE_ENCRYPTION)
+        if (encrypted) {
+            break;
+        }
+#endif
+        for (i = 0; i < ARRAY_SIZE(lens); i++) {
+            ble_ll_conn_bench_run(encrypted, lens[i], &res);
+            TEST_ASSERT(res.pdus == BLE_LL_CONN_BENCH_ITERATIONS);
+
+            printf("  %-9s len %3u: isr %6" PRIu64 " ll task %6" PRIu64 "\n",
+                   encrypted ? "encrypted" : "plain", lens[i],
+                   res.isr / res.pdus, res.ll / res.pdus);
+        }
+    }
+}
+
+TEST_SUITE(ble_ll_conn_bench_suite) {
+    ble_ll_conn_bench_data_pdu();
+}
@@ -1280,6 +1280,69 @@ TEST_CASE_SELF(test_ial_bis_fra_early_sdus) {
     test_ial_teardown(&mux);
 }
 
+TEST_CASE_SELF(test_ial_bis_fra_long_sdu) {
+    struct ble_ll_isoal_mux mux;
+    const uint32_t sdu_int = 10000;
+    const uint32_t iso_int = 10000;
+    const uint16_t mx_sdu = 300;
+    const uint8_t mx_pdu = 100;
+    const uint8_t bn = 2;
+    int num_completed_pkt;
+    int num_pkt;
+    int pdu_len;
+    uint16_t seg_hdr;
+    uint8_t pdu[mx_pdu];
+    uint8_t llid = 0xff;
+
+    test_ial_setup(&mux, mx_pdu, iso_int, sdu_int, bn, 0, true, 0);
+
+    /* SDU is longer than 255 octets and sent over 2 ISO events */
+    num_pkt = test_sdu_enqueue(&mux, mx_sdu, 0, 0);
+
+    ble_ll_isoal_mux_event_start(&mux, 500);
+
+    pdu_len = ble_ll_isoal_mux_pdu_get(&mux, 0, &llid, pdu);
+    TEST_ASSERT(llid == 0b10, "LLID is incorrect %d", llid);
+    TEST_ASSERT(pdu_len == mx_pdu, "PDU length is incorrect %d", pdu_len);
+    seg_hdr = get_le16(&pdu[0]);
+    TEST_ASSERT(BLE_LL_ISOAL_SEGHDR_SC(seg_hdr) == 0);
+    TEST_ASSERT(BLE_LL_ISOAL_SEGHDR_CMPLT(seg_hdr) == 0);
+    test_pdu_verify(&pdu[5], 95, 0);
+
+    pdu_len = ble_ll_isoal_mux_pdu_get(&mux, 1, &llid, pdu);
+    TEST_ASSERT(pdu_len == mx_pdu, "PDU length is incorrect %d", pdu_len);
+    seg_hdr = get_le16(&pdu[0]);
+    TEST_ASSERT(BLE_LL_ISOAL_SEGHDR_SC(seg_hdr) == 1);
+    TEST_ASSERT(BLE_LL_ISOAL_SEGHDR_CMPLT(seg_hdr) == 0);
+    test_pdu_verify(&pdu[2], 98, 95);
+
+    num_completed_pkt = ble_ll_isoal_mux_event_done(&mux);
+    TEST_ASSERT(num_completed_pkt == 0,
+                "num_completed_pkt is incorrect %d", num_completed_pkt);
+
+    ble_ll_isoal_mux_event_start(&mux, 500 + iso_int);
+
+    pdu_len = ble_ll_isoal_mux_pdu_get(&mux, 0, &llid, pdu);
+    TEST_ASSERT(pdu_len == mx_pdu, "PDU length is incorrect %d", pdu_len);
+    seg_hdr = get_le16(&pdu[0]);
+    TEST_ASSERT(BLE_LL_ISOAL_SEGHDR_SC(seg_hdr) == 1);
+    TEST_ASSERT(BLE_LL_ISOAL_SEGHDR_CMPLT(seg_hdr) == 0);
+    test_pdu_verify(&pdu[2], 98, 193);
+
+    pdu_len = ble_ll_isoal_mux_pdu_get(&mux, 1, &llid, pdu);
+    TEST_ASSERT(pdu_len == 2 + 9, "PDU length is incorrect %d", pdu_len);
+    seg_hdr = get_le16(&pdu[0]);
+    TEST_ASSERT(BLE_LL_ISOAL_SEGHDR_SC(seg_hdr) == 1);
+    TEST_ASSERT(BLE_LL_ISOAL_SEGHDR_CMPLT(seg_hdr) == 1);
+    test_pdu_verify(&pdu[2], 9, 291);
+
+    num_completed_pkt = ble_ll_isoal_mux_event_done(&mux);
+    TEST_ASSERT(num_completed_pkt == num_pkt,
+                "num_completed_pkt is incorrect %d", num_completed_pkt);
+
+    test_ial_teardown(&mux);
+}
+
 TEST_SUITE(ble_ll_isoal_test_suite) {
     os_mbuf_test_setup();
 
@@ -1327,6 +1390,7 @@ TEST_SUITE(ble_ll_isoal_test_suite) {
 
     test_ial_bis_unf_early_sdus();
     test_ial_bis_fra_early_sdus();
+    test_ial_bis_fra_long_sdu();
 
     ble_ll_isoal_reset();
 }
@@ -0,0 +1,217 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+/*
+ * Benchmark of ISOAL mux, i.e. building ISO Data PDUs from queued SDUs as
+ * done from BIG/CIG subevent in radio ISR. Each ISO event starts the mux,
+ * gets every PDU of the event twice (as for IRC = 2) and completes the event.
+ * Configurations use typical LC3 codec frame sizes, unframed and framed.
+ *
+ * One run queues SDUs as they become due and muxes BLE_LL_ISOAL_BENCH_EVENTS
+ * ISO events; time of the run is reported per non-empty PDU. SDU allocation
+ * is included since a single event is too short to time on its own.
+ * Unframed layouts cover one or more SDUs per ISO interval (BN 1 and 2),
+ * framed ones cover SDU interval not aligned to ISO interval, several SDUs
+ * packed into one PDU and single SDU segmented over several PDUs.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <time.h>
+#include <os/os.h>
+#include <os/os_mbuf.h>
+#include <nimble/ble.h>
+#include <controller/ble_ll_isoal.h>
+#include <testutil/testutil.h>
+
+#define BLE_LL_ISOAL_BENCH_EVENTS       (10000)
+#define BLE_LL_ISOAL_BENCH_IRC          (2)
+
+#define BLE_LL_ISOAL_BENCH_BUF_SIZE     (256 + BLE_MBUF_MEMBLOCK_OVERHEAD)
+#define BLE_LL_ISOAL_BENCH_BUF_COUNT    (16)
+
+struct ble_ll_isoal_bench_cfg {
+    const char *name;
+    uint16_t sdu_len;
+    uint32_t sdu_interval_us;
+    uint32_t iso_interval_us;
+    uint8_t max_pdu;
+    uint8_t bn;
+    uint8_t framed;
+};
+
+/* BAP broadcast Audio Stream configurations */
+static const struct ble_ll_isoal_bench_cfg ble_ll_isoal_bench_cfgs[] = {
+    { "16_2_1", 40, 10000, 10000, 40, 1, 0 },
+    { "24_2_1", 60, 10000, 10000, 60, 1, 0 },
+    { "32_2_1", 80, 10000, 10000, 80, 1, 0 },
+    { "48_2_1", 100, 10000, 10000, 100, 1, 0 },
+    { "48_4_1", 120, 10000, 10000, 120, 1, 0 },
+    { "48_6_1", 155, 10000, 10000, 155, 1, 0 },
+    { "48_6_1 x2", 155, 10000, 20000, 155, 2, 0 },
+    { "16_1_1", 30, 7500, 8750, 35, 2, 1 },
+    { "32_1_1", 60, 7500, 8750, 65, 2, 1 },
+    { "48_1_1", 75, 7500, 8750, 80, 2, 1 },
+    { "48_5_1", 117, 7500, 8750, 122, 2, 1 },
+    { "48_5_1 x4", 117, 7500, 30000, 251, 3, 1 },
+    { "48_2_1 seg", 100, 10000, 20000, 40, 6, 1 },
+};
+
+static os_membuf_t ble_ll_isoal_bench_mem[
+    OS_MEMPOOL_SIZE(BLE_LL_ISOAL_BENCH_BUF_COUNT,
+                    BLE_LL_ISOAL_BENCH_BUF_SIZE)];
+static struct os_mempool ble_ll_isoal_bench_mempool;
+static struct os_mbuf_pool ble_ll_isoal_bench_mbuf_pool;
+static uint8_t ble_ll_isoal_bench_data[256];
+
+static inline uint64_t
+ble_ll_isoal_bench_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void
+ble_ll_isoal_bench_enqueue(struct ble_ll_isoal_mux *mux, uint16_t len,
+                           uint32_t timestamp)
+{
+    struct ble_mbuf_hdr *blehdr;
+    struct os_mbuf *om;
+    int rc;
+
+    om = os_mbuf_get_pkthdr(&ble_ll_isoal_bench_mbuf_pool,
+                            sizeof(struct ble_mbuf_hdr));
+    TEST_ASSERT_FATAL(om != NULL);
+
+    blehdr = BLE_MBUF_HDR_PTR(om);
+    blehdr->txiso.cpu_timestamp = timestamp;
+    blehdr->txiso.packet_seq_num = 0;
+
+    rc = os_mbuf_append(om, ble_ll_isoal_bench_data, len);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    ble_ll_isoal_mux_sdu_enqueue(mux, om);
+}
+
+static void
+ble_ll_isoal_bench_run(const struct ble_ll_isoal_bench_cfg *cfg,
+                       uint64_t *ns, uint32_t *pdus)
+{
+    struct ble_ll_isoal_mux mux;
+    uint8_t pdu[UINT8_MAX];
+    uint32_t sdu_time = 0;
+    uint32_t event_time = 0;
+    uint64_t start;
+    uint8_t llid;
+    int pdu_len;
+    int i;
+    int j;
+    int k;
+
+    *pdus = 0;
+
+    ble_ll_isoal_mux_init(&mux, cfg->max_pdu, cfg->iso_interval_us,
+                          cfg->sdu_interval_us, cfg->bn, 0, cfg->framed, 0);
+
+    start = ble_ll_isoal_bench_ns();
+
+    for (i = 0; i < BLE_LL_ISOAL_BENCH_EVENTS; i++) {
+        event_time += cfg->iso_interval_us;
+
+        /* SDUs generated by the time event starts */
+        while (sdu_time + cfg->sdu_interval_us <= event_time) {
+            sdu_time += cfg->sdu_interval_us;
+            ble_ll_isoal_bench_enqueue(&mux, cfg->sdu_len, sdu_time);
+        }
+
+        ble_ll_isoal_mux_event_start(&mux, event_time);
+
+        for (j = 0; j < BLE_LL_ISOAL_BENCH_IRC; j++) {
+            for (k = 0; k < cfg->bn; k++) {
+                pdu_len = ble_ll_isoal_mux_pdu_get(&mux, k, &llid, pdu);
+                if (pdu_len > 0) {
+                    (*pdus)++;
+                }
+            }
+        }
+
+        ble_ll_isoal_mux_event_done(&mux);
+    }
+
+    *ns = ble_ll_isoal_bench_ns() - start;
+
+    ble_ll_isoal_mux_free(&mux);
+
+    /* Make sure nothing leaked and mux kept up with SDUs */
+    TEST_ASSERT(ble_ll_isoal_bench_mempool.mp_num_free ==
+                BLE_LL_ISOAL_BENCH_BUF_COUNT);
+}
+
+TEST_CASE_SELF(ble_ll_isoal_bench_mux) {
+    const struct ble_ll_isoal_bench_cfg *cfg;
+    uint64_t ns;
+    uint32_t pdus;
+    int rc;
+    int i;
+
+    rc = os_mempool_init(&ble_ll_isoal_bench_mempool,
+                         BLE_LL_ISOAL_BENCH_BUF_COUNT,
+                         BLE_LL_ISOAL_BENCH_BUF_SIZE,
+                         ble_ll_isoal_bench_mem, "isoal_bench");
+    TEST_ASSERT_FATAL(rc == 0);
+
+    rc = os_mbuf_pool_init(&ble_ll_isoal_bench_mbuf_pool,
+                           &ble_ll_isoal_bench_mempool,
+                           BLE_LL_ISOAL_BENCH_BUF_SIZE,
+                           BLE_LL_ISOAL_BENCH_BUF_COUNT);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    for (i = 0; i < sizeof(ble_ll_isoal_bench_data); i++) {
+        ble_ll_isoal_bench_data[i] = i;
+    }
+
+    printf("ble_ll_isoal_bench: %d ISO events per run, IRC %d\n",
+           BLE_LL_ISOAL_BENCH_EVENTS, BLE_LL_ISOAL_BENCH_IRC);
+
+    for (i = 0; i < ARRAY_SIZE(ble_ll_isoal_bench_cfgs); i++) {
+        cfg = &ble_ll_isoal_bench_cfgs[i];
+
+        ble_ll_isoal_bench_run(cfg, &ns, &pdus);
+        TEST_ASSERT(pdus > 0);
+        if (pdus == 0) {
+            continue;
+        }
+
+        printf("  %-10s %-8s sdu %3u pdu %3u: %5" PRIu64 " ns/PDU "
+               "%9" PRIu64 " PDUs/s\n", cfg->name,
+               cfg->framed ? "framed" : "unframed", cfg->sdu_len,
+               cfg->max_pdu, ns / pdus,
+               ns ? (uint64_t)pdus * 1000000000 / ns : 0);
+    }
+}
+
+TEST_SUITE(ble_ll_isoal_bench_suite) {
+    ble_ll_isoal_bench_mux();
+}
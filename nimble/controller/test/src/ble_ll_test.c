@@ -18,24 +18,65 @@
  */
 
 #include <syscfg/syscfg.h>
+#include <os/os_mbuf.h>
+#include <nimble/transport.h>
+#include <nimble/transport_impl.h>
 #include <testutil/testutil.h>
 
+/*
+ * Controller tests run without host, so just drop anything sent towards it.
+ */
+void
+ble_transport_hs_init(void)
+{
+}
+
+int
+ble_transport_to_hs_evt_impl(void *buf)
+{
+    ble_transport_free(buf);
+
+    return 0;
+}
+
+int
+ble_transport_to_hs_acl_impl(struct os_mbuf *om)
+{
+    os_mbuf_free_chain(om);
+
+    return 0;
+}
+
+int
+ble_transport_to_hs_iso_impl(struct os_mbuf *om)
+{
+    os_mbuf_free_chain(om);
+
+    return 0;
+}
+
 #if MYNEWT_VAL(SELFTEST)
 
 TEST_SUITE_DECL(ble_ll_aa_test_suite);
+TEST_SUITE_DECL(ble_ll_conn_bench_suite);
 TEST_SUITE_DECL(ble_ll_crypto_test_suite);
 TEST_SUITE_DECL(ble_ll_csa2_test_suite);
+TEST_SUITE_DECL(ble_ll_isoal_bench_suite);
 TEST_SUITE_DECL(ble_ll_isoal_test_suite);
 TEST_SUITE_DECL(ble_ll_iso_test_suite);
+TEST_SUITE_DECL(ble_ll_whitelist_test_suite);
 
 int
 main(int argc, char **argv)
 {
     ble_ll_aa_test_suite();
+    ble_ll_conn_bench_suite();
     ble_ll_crypto_test_suite();
     ble_ll_csa2_test_suite();
+    ble_ll_isoal_bench_suite();
     ble_ll_isoal_test_suite();
     ble_ll_iso_test_suite();
+    ble_ll_whitelist_test_suite();
 
     return tu_any_failed;
 }
@@ -0,0 +1,114 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <nimble/ble.h>
+#include <nimble/hci_common.h>
+#include <controller/ble_ll_whitelist.h>
+#include <testutil/testutil.h>
+
+#define BLE_LL_WHITELIST_TEST_CNT   (MYNEWT_VAL(BLE_LL_WHITELIST_SIZE))
+
+static void
+ble_ll_whitelist_test_addr(int i, struct ble_hci_le_add_whte_list_cp *cmd)
+{
+    /* Same company ID, and every 4 addresses have the same hash */
+    cmd->addr_type = BLE_ADDR_PUBLIC;
+    cmd->addr[0] = i / 4;
+    cmd->addr[1] = 0;
+    cmd->addr[2] = i % 4;
+    cmd->addr[3] = 0x02;
+    cmd->addr[4] = 0x00;
+    cmd->addr[5] = 0x0c ^ (i % 4);
+}
+
+static int
+ble_ll_whitelist_test_match(int i)
+{
+    struct ble_hci_le_add_whte_list_cp cmd;
+
+    ble_ll_whitelist_test_addr(i, &cmd);
+
+    return ble_ll_whitelist_match(cmd.addr, cmd.addr_type, 1);
+}
+
+TEST_CASE_SELF(ble_ll_whitelist_test_add_rmv)
+{
+    struct ble_hci_le_add_whte_list_cp cmd;
+    int rc;
+    int i;
+
+    rc = ble_ll_whitelist_clear();
+    TEST_ASSERT_FATAL(rc == 0);
+
+    for (i = 0; i < BLE_LL_WHITELIST_TEST_CNT; i++) {
+        ble_ll_whitelist_test_addr(i, &cmd);
+        rc = ble_ll_whitelist_add((const uint8_t *)&cmd, sizeof(cmd));
+        TEST_ASSERT_FATAL(rc == 0);
+    }
+
+    /* Duplicates are accepted but do not use entries */
+    ble_ll_whitelist_test_addr(0, &cmd);
+    rc = ble_ll_whitelist_add((const uint8_t *)&cmd, sizeof(cmd));
+    TEST_ASSERT(rc == 0);
+
+    /* List is full */
+    ble_ll_whitelist_test_addr(BLE_LL_WHITELIST_TEST_CNT, &cmd);
+    rc = ble_ll_whitelist_add((const uint8_t *)&cmd, sizeof(cmd));
+    TEST_ASSERT(rc == BLE_ERR_MEM_CAPACITY);
+    TEST_ASSERT(!ble_ll_whitelist_test_match(BLE_LL_WHITELIST_TEST_CNT));
+
+    for (i = 0; i < BLE_LL_WHITELIST_TEST_CNT; i++) {
+        TEST_ASSERT(ble_ll_whitelist_test_match(i));
+    }
+
+    /* Address type is part of the key */
+    ble_ll_whitelist_test_addr(1, &cmd);
+    TEST_ASSERT(!ble_ll_whitelist_match(cmd.addr, BLE_ADDR_RANDOM, 1));
+
+    /* Remove every third entry, i.e. from head, middle and tail of chains */
+    for (i = 0; i < BLE_LL_WHITELIST_TEST_CNT; i += 3) {
+        ble_ll_whitelist_test_addr(i, &cmd);
+        rc = ble_ll_whitelist_rmv((const uint8_t *)&cmd, sizeof(cmd));
+        TEST_ASSERT_FATAL(rc == 0);
+    }
+
+    for (i = 0; i < BLE_LL_WHITELIST_TEST_CNT; i++) {
+        TEST_ASSERT(!ble_ll_whitelist_test_match(i) == !(i % 3));
+    }
+
+    /* Freed entries are reused */
+    ble_ll_whitelist_test_addr(BLE_LL_WHITELIST_TEST_CNT, &cmd);
+    rc = ble_ll_whitelist_add((const uint8_t *)&cmd, sizeof(cmd));
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(ble_ll_whitelist_test_match(BLE_LL_WHITELIST_TEST_CNT));
+
+    rc = ble_ll_whitelist_clear();
+    TEST_ASSERT_FATAL(rc == 0);
+
+    for (i = 0; i <= BLE_LL_WHITELIST_TEST_CNT; i++) {
+        TEST_ASSERT(!ble_ll_whitelist_test_match(i));
+    }
+}
+
+TEST_SUITE(ble_ll_whitelist_test_suite)
+{
+    ble_ll_whitelist_test_add_rmv();
+}
@@ -20,6 +20,8 @@
 #ifndef H_BLE_XCVR_
 #define H_BLE_XCVR_
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -39,6 +41,13 @@ extern "C" {
  */
 #define BLE_HW_WHITE_LIST_SIZE        (0)
 
+/*
+ * Simulation hooks. These allow unit tests and benchmarks to drive the Link
+ * Layer through the PHY interface without a transceiver.
+ */
+int ble_phy_sim_tx_end(void);
+int ble_phy_sim_rx(const uint8_t *pdu, uint16_t len);
+
 #ifdef __cplusplus
 }
 #endif
@@ -27,6 +27,7 @@
 #include "nimble/nimble_opt.h"
 #include "controller/ble_phy.h"
 #include "controller/ble_ll.h"
+#include "controller/ble_ll_tmr.h"
 
 #ifndef min
 #define min(a, b) ((a) < (b) ? (a) : (b))
@@ -74,6 +75,9 @@ struct ble_phy_statistics g_ble_phy_stats;
 
 static uint8_t g_ble_phy_tx_buf[BLE_PHY_MAX_PDU_LEN];
 
+/* Receive buffer (must be word aligned, see ble_phy_rxpdu_copy()) */
+static uint32_t g_ble_phy_rx_buf[(BLE_PHY_MAX_PDU_LEN + 3) / 4];
+
 /* XCVR object to emulate transceiver */
 struct xcvr_data
 {
@@ -242,12 +246,17 @@ ble_phy_isr(void)
 
         transition = g_ble_phy_data.phy_transition;
         if (transition == BLE_PHY_TRANSITION_TX_RX) {
-            /* Disable the phy */
-            /* XXX: count no bufs? */
-            ble_phy_disable();
+            /* Go straight to receive state, as radio would do after T_IFS */
+            g_ble_phy_data.phy_state = BLE_PHY_STATE_RX;
         } else {
             /* Better not be going from rx to tx! */
             assert(transition == BLE_PHY_TRANSITION_NONE);
+            ble_phy_disable();
+        }
+
+        /* Call transmit end callback */
+        if (g_ble_phy_data.txend_cb) {
+            g_ble_phy_data.txend_cb(g_ble_phy_data.txend_arg);
         }
     }
 
@@ -256,6 +265,13 @@ ble_phy_isr(void)
 
         ble_xcvr_clear_irq(BLE_XCVR_IRQ_F_RX_START);
 
+        /* Initialize BLE header as the Link Layer expects it on rx start */
+        ble_hdr = &g_ble_phy_data.rxhdr;
+        ble_hdr->rxinfo.flags = ble_ll_state_get();
+        ble_hdr->rxinfo.handle = 0;
+        ble_hdr->beg_cputime = ble_ll_tmr_get();
+        ble_hdr->rem_usecs = 0;
+
         /* Call Link Layer receive start function */
         rc = ble_ll_rx_start(g_ble_phy_data.rxdptr, g_ble_phy_data.phy_chan,
                              &g_ble_phy_data.rxhdr);
@@ -279,7 +295,6 @@ ble_phy_isr(void)
 
         /* Construct BLE header before handing up */
         ble_hdr = &g_ble_phy_data.rxhdr;
-        ble_hdr->rxinfo.flags = 0;
         /* XXX: dummy rssi */
         ble_hdr->rxinfo.rssi = -77 + g_ble_phy_data.rx_pwr_compensation;
         ble_hdr->rxinfo.channel = g_ble_phy_data.phy_chan;
@@ -304,6 +319,60 @@ ble_phy_isr(void)
     ++g_ble_phy_stats.phy_isrs;
 }
 
+/**
+ * Emulates end of the current transmission. If the PHY was set to go from
+ * transmit to receive, it is left in the receive state.
+ *
+ * @return int 0: success; PHY error code otherwise
+ */
+int
+ble_phy_sim_tx_end(void)
+{
+    if (g_ble_phy_data.phy_state != BLE_PHY_STATE_TX) {
+        return BLE_PHY_ERR_RADIO_STATE;
+    }
+
+    g_xcvr_data.irq_status |= BLE_XCVR_IRQ_F_TX_END;
+    ble_phy_isr();
+
+    return 0;
+}
+
+/**
+ * Emulates reception of a PDU on the current channel. The PDU is handed to
+ * the Link Layer the same way a radio interrupt would do it, i.e. with rx
+ * start and rx end processed in interrupt context. If a transmission is
+ * in progress it is ended first.
+ *
+ * @param pdu Pointer to PDU, starting with the 2 byte PDU header
+ * @param len Length of the PDU (including header)
+ *
+ * @return int 0: success; PHY error code otherwise
+ */
+int
+ble_phy_sim_rx(const uint8_t *pdu, uint16_t len)
+{
+    if (len > BLE_PHY_MAX_PDU_LEN) {
+        return BLE_PHY_ERR_INV_PARAM;
+    }
+
+    if (g_ble_phy_data.phy_state == BLE_PHY_STATE_TX) {
+        ble_phy_sim_tx_end();
+    }
+
+    if (g_ble_phy_data.phy_state != BLE_PHY_STATE_RX) {
+        return BLE_PHY_ERR_RADIO_STATE;
+    }
+
+    memcpy(g_ble_phy_rx_buf, pdu, len);
+    g_ble_phy_data.rxdptr = (uint8_t *)g_ble_phy_rx_buf;
+
+    g_xcvr_data.irq_status |= BLE_XCVR_IRQ_F_RX_START | BLE_XCVR_IRQ_F_RX_END;
+    ble_phy_isr();
+
+    return 0;
+}
+
 /**
  * ble phy init
  *
@@ -349,6 +418,7 @@ ble_phy_restart_rx(void)
 void
 ble_phy_encrypt_enable(const uint8_t *key)
 {
+    g_ble_phy_data.phy_encrypted = 1;
 }
 
 void
@@ -369,6 +439,7 @@ ble_phy_encrypt_counter_set(uint64_t counter, uint8_t dir_bit)
 void
 ble_phy_encrypt_disable(void)
 {
+    g_ble_phy_data.phy_encrypted = 0;
 }
 #endif
 
@@ -433,20 +504,23 @@ ble_phy_tx(ble_phy_tx_pducb_t pducb, void *pducb_arg, uint8_t end_trans)
         return BLE_PHY_ERR_RADIO_STATE;
     }
 
-    /* Select tx address */
-    if (g_ble_phy_data.phy_chan < BLE_PHY_NUM_DATA_CHANS) {
-        /* XXX: fix this */
-        assert(0);
-    } else {
-    }
-
     /* Set the PHY transition */
     g_ble_phy_data.phy_transition = end_trans;
 
     /* Set phy state to transmitting and count packet statistics */
     g_ble_phy_data.phy_state = BLE_PHY_STATE_TX;
     ++g_ble_phy_stats.tx_good;
-    g_ble_phy_stats.tx_bytes += pducb(g_ble_phy_tx_buf, pducb_arg, &hdr_byte) +
+    g_ble_phy_data.phy_tx_pyld_len = pducb(g_ble_phy_tx_buf +
+                                           BLE_LL_PDU_HDR_LEN,
+                                           pducb_arg, &hdr_byte);
+    g_ble_phy_tx_buf[0] = hdr_byte;
+    g_ble_phy_tx_buf[1] = g_ble_phy_data.phy_tx_pyld_len;
+#if MYNEWT_VAL(BLE_LL_CFG_FEAT_LE_ENCRYPTION)
+    if (g_ble_phy_data.phy_encrypted && g_ble_phy_data.phy_tx_pyld_len) {
+        g_ble_phy_stats.tx_bytes += BLE_LL_DATA_MIC_LEN;
+    }
+#endif
+    g_ble_phy_stats.tx_bytes += g_ble_phy_data.phy_tx_pyld_len +
                                 BLE_LL_PDU_HDR_LEN;
     rc = BLE_ERR_SUCCESS;
 
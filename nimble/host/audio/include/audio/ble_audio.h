@@ -1033,6 +1033,43 @@ struct ble_audio_base {
     STAILQ_HEAD(, ble_audio_big_subgroup) subs;
 };
 
+/**
+ * Serialize BASE to the format used in Basic Audio Announcement data.
+ *
+ * @param[in] base              BASE to serialize.
+ * @param[out] buf              Buffer to write BASE data to.
+ * @param[in] buf_size          Size of the buffer.
+ * @param[out] out_len          Length of the BASE data written.
+ *
+ * @return                      0 on success;
+ *                              BLE_HS_EMSGSIZE if BASE does not fit buffer;
+ *                              BLE_HS_EINVAL if parameters are invalid.
+ */
+int ble_audio_base_build(const struct ble_audio_base *base, uint8_t *buf,
+                         uint8_t buf_size, uint8_t *out_len);
+
+/**
+ * Replace Metadata of a subgroup in serialized BASE data. Only octets that
+ * differ are rewritten; following subgroups and BISes are moved only if
+ * Metadata length changes.
+ *
+ * @param[in,out] buf           BASE data.
+ * @param[in,out] len           Length of BASE data, updated on success.
+ * @param[in] buf_size          Size of the buffer.
+ * @param[in] subgroup_idx      Index of the subgroup in BASE.
+ * @param[in] metadata          New Metadata LTVs.
+ * @param[in] metadata_len      New Metadata length.
+ *
+ * @return                      0 on success;
+ *                              BLE_HS_EALREADY if Metadata is unchanged;
+ *                              BLE_HS_ENOENT if there is no such subgroup;
+ *                              BLE_HS_EMSGSIZE if BASE would not fit buffer;
+ *                              Other nonzero on malformed BASE data.
+ */
+int ble_audio_base_metadata_set(uint8_t *buf, uint8_t *len, uint8_t buf_size,
+                                uint8_t subgroup_idx, const uint8_t *metadata,
+                                uint8_t metadata_len);
+
 static inline const char *
 ble_audio_broadcast_sink_sync_state_str(enum ble_audio_broadcast_sink_sync_state state)
 {
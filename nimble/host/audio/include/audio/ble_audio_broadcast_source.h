@@ -172,6 +172,34 @@ int ble_audio_broadcast_destroy(uint8_t adv_instance);
 int ble_audio_broadcast_update(const struct ble_broadcast_update_params
                                *params);
 
+/**
+ * @brief Update subgroup Metadata of given BASE configuration
+ *
+ * This function updates Metadata in BASE and periodic advertising data.
+ * Only changed Metadata is rewritten in cached BASE and periodic advertising
+ * data is not updated at all if Metadata did not change, so it is cheap to
+ * call often.
+ *
+ * @param[in] adv_instance      Advertising instance used by broadcast.
+ * @param[in] subgroup_idx      Index of the subgroup in BASE.
+ * @param[in] metadata          New Metadata LTVs. Metadata is not copied
+ *                              and shall be valid for the lifetime of the
+ *                              broadcast or until next update.
+ * @param[in] metadata_len      New Metadata length.
+ *
+ * @return                      0 on success;
+ *                              BLE_HS_ENOENT if there is no such broadcast
+ *                              or subgroup;
+ *                              BLE_HS_EINVAL if Metadata is malformed;
+ *                              BLE_HS_EMSGSIZE if BASE would not fit
+ *                              advertising data;
+ *                              Other nonzero on failure.
+ */
+int ble_audio_broadcast_metadata_update(uint8_t adv_instance,
+                                        uint8_t subgroup_idx,
+                                        uint8_t *metadata,
+                                        uint8_t metadata_len);
+
 /** BIG Subgroup parameters */
 struct ble_broadcast_subgroup_params {
     /** Subgroup level Codec information */
@@ -0,0 +1,236 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef H_BLE_AUDIO_SINK_PIPELINE_
+#define H_BLE_AUDIO_SINK_PIPELINE_
+
+/**
+ * @file ble_audio_sink_pipeline.h
+ *
+ * @brief Bluetooth LE Audio Broadcast Sink media pipeline
+ *
+ * Pipeline stores received ISO SDUs in per BIS jitter buffer, ordered by SDU
+ * timestamp (or sequence number if timestamp is not available), decodes
+ * codec frames with LC3 and provides interleaved PCM samples at steady rate.
+ * Missing or errored SDUs are concealed by LC3 packet loss concealment.
+ *
+ * @defgroup ble_audio_sink_pipeline Bluetooth LE Audio Sink Pipeline
+ * @ingroup bt_host
+ * @{
+ */
+
+#include <stdint.h>
+#include "syscfg/syscfg.h"
+#include "host/ble_iso.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct ble_audio_sink_pipeline;
+
+/** BIS configuration of the pipeline */
+struct ble_audio_sink_pipeline_bis {
+    /** Index of first PCM channel received over this BIS */
+    uint8_t chan_idx;
+
+    /**
+     * Number of PCM channels received over this BIS. Each channel is
+     * received as separate codec frame in the same SDU.
+     */
+    uint8_t chan_cnt;
+};
+
+/** Pipeline parameters */
+struct ble_audio_sink_pipeline_params {
+    /** PCM sampling frequency in Hz */
+    uint32_t pcm_sample_rate;
+
+    /** Number of interleaved PCM channels */
+    uint8_t pcm_chan_cnt;
+
+    /** LC3 sampling frequency in Hz */
+    uint32_t sample_rate;
+
+    /** LC3 frame duration in microseconds, 7500 or 10000 */
+    uint16_t frame_duration;
+
+    /**
+     * SDU interval in microseconds, used to order SDUs by timestamp. If 0,
+     * frame duration is used.
+     */
+    uint32_t sdu_interval;
+
+    /**
+     * Resample decoded PCM to PCM sampling frequency, also if both are equal
+     * so drift between ISO and PCM clocks is compensated. Requires
+     * BLE_AUDIO_SINK_PIPELINE_RESAMPLE.
+     */
+    uint8_t resample;
+
+    /** Number of BISes */
+    uint8_t bis_cnt;
+
+    /** BIS configurations, @p bis_cnt entries */
+    const struct ble_audio_sink_pipeline_bis *bis;
+};
+
+/** Pipeline statistics */
+struct ble_audio_sink_pipeline_stats {
+    /** Number of codec frame intervals decoded */
+    uint32_t frames;
+
+    /** Number of SDUs stored in jitter buffer */
+    uint32_t sdus;
+
+    /** Number of SDUs received after their playout time */
+    uint32_t late;
+
+    /** Number of SDUs dropped from full jitter buffer */
+    uint32_t overflows;
+
+    /** Number of SDUs missing at their playout time */
+    uint32_t lost;
+
+    /** Number of SDUs received with error status */
+    uint32_t errors;
+
+    /** Number of codec frames concealed by packet loss concealment */
+    uint32_t plc;
+
+    /** Number of reads served with silence before playout started */
+    uint32_t underruns;
+
+    /** Current jitter buffer fill level, in SDUs */
+    uint16_t fill;
+
+    /** Current resampling ratio, times 1000000 */
+    uint32_t ratio_ppm;
+};
+
+/**
+ * Creates pipeline.
+ *
+ * @param[in] params            Pipeline parameters.
+ * @param[out] pipeline         On success, created pipeline.
+ *
+ * @return                      0 on success;
+ *                              BLE_HS_EINVAL if parameters are invalid;
+ *                              BLE_HS_ENOTSUP if resampling is not supported;
+ *                              BLE_HS_ENOMEM if no more pipelines available.
+ */
+int ble_audio_sink_pipeline_create(
+    const struct ble_audio_sink_pipeline_params *params,
+    struct ble_audio_sink_pipeline **pipeline);
+
+/**
+ * Destroys pipeline. Frees all SDUs held in jitter buffer.
+ *
+ * @param pipeline              Pipeline to destroy.
+ */
+void ble_audio_sink_pipeline_destroy(struct ble_audio_sink_pipeline *pipeline);
+
+/**
+ * Sets BIS connection handle. SDUs are accepted only from BISes with handle
+ * set, channels of other BISes are silent.
+ *
+ * @param pipeline              The pipeline.
+ * @param bis_idx               Index of BIS in pipeline parameters.
+ * @param conn_handle           BIS connection handle, BLE_HS_CONN_HANDLE_NONE
+ *                                  to stop receiving.
+ *
+ * @return                      0 on success;
+ *                              BLE_HS_EINVAL if BIS index is invalid.
+ */
+int ble_audio_sink_pipeline_bis_handle_set(
+    struct ble_audio_sink_pipeline *pipeline, uint8_t bis_idx,
+    uint16_t conn_handle);
+
+/**
+ * Stores received SDU in jitter buffer.
+ *
+ * @param pipeline              The pipeline.
+ * @param conn_handle           BIS connection handle SDU was received on.
+ * @param info                  SDU data info.
+ * @param om                    SDU data. Ownership is always taken by
+ *                                  pipeline.
+ *
+ * @return                      0 on success;
+ *                              BLE_HS_ENOENT if BIS is not part of pipeline;
+ *                              BLE_HS_ETIMEOUT if SDU is too late to play.
+ */
+int ble_audio_sink_pipeline_rx(struct ble_audio_sink_pipeline *pipeline,
+                               uint16_t conn_handle,
+                               const struct ble_iso_rx_data_info *info,
+                               struct os_mbuf *om);
+
+/**
+ * ISO event handler which can be passed, with pipeline as argument, to
+ * ble_iso_data_path_setup() for BISes of the pipeline.
+ *
+ * @param event                 ISO event.
+ * @param arg                   The pipeline.
+ *
+ * @return                      0.
+ */
+int ble_audio_sink_pipeline_iso_event(struct ble_iso_event *event, void *arg);
+
+/**
+ * Reads decoded PCM samples. Always provides requested number of frames,
+ * silence before playout starts and concealed audio when SDUs are missing,
+ * so shall be called at PCM sink rate, e.g. from audio output task.
+ *
+ * @param pipeline              The pipeline.
+ * @param pcm                   Buffer for interleaved 16-bit PCM samples.
+ * @param frames                Number of frames to read. Frame consists of
+ *                                  one sample of each channel.
+ *
+ * @return                      Number of frames read.
+ */
+uint16_t ble_audio_sink_pipeline_read(struct ble_audio_sink_pipeline *pipeline,
+                                      int16_t *pcm, uint16_t frames);
+
+/**
+ * Retrieves pipeline statistics.
+ *
+ * @param pipeline              The pipeline.
+ * @param stats                 Statistics are written here.
+ */
+void ble_audio_sink_pipeline_stats_get(
+    struct ble_audio_sink_pipeline *pipeline,
+    struct ble_audio_sink_pipeline_stats *stats);
+
+/**
+ * @brief Initialize Sink Pipeline
+ *
+ * This function is restricted to be called by sysinit.
+ *
+ * @return Returns 0 on success, or a non-zero error code otherwise.
+ */
+int ble_audio_sink_pipeline_init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* H_BLE_AUDIO_SINK_PIPELINE_ */
@@ -0,0 +1,209 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef H_BLE_AUDIO_SOURCE_PIPELINE_
+#define H_BLE_AUDIO_SOURCE_PIPELINE_
+
+/**
+ * @file ble_audio_source_pipeline.h
+ *
+ * @brief Bluetooth LE Audio Broadcast Source media pipeline
+ *
+ * Pipeline pulls PCM samples from source, optionally resamples them, encodes
+ * each channel with LC3 and sends codec frames as ISO SDUs over BISes.
+ *
+ * @defgroup ble_audio_source_pipeline Bluetooth LE Audio Source Pipeline
+ * @ingroup bt_host
+ * @{
+ */
+
+#include <stdint.h>
+#include "syscfg/syscfg.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct ble_audio_source_pipeline;
+
+/** PCM source of the pipeline */
+struct ble_audio_pcm_source {
+    /**
+     * Reads interleaved 16-bit PCM samples.
+     *
+     * @param source            The source.
+     * @param pcm               Buffer to read samples to.
+     * @param max_frames        Maximum number of frames to read. Frame
+     *                              consists of one sample of each channel.
+     *
+     * @return                  Number of frames read.
+     */
+    uint16_t (*read)(struct ble_audio_pcm_source *source, int16_t *pcm,
+                     uint16_t max_frames);
+};
+
+/** BIS configuration of the pipeline */
+struct ble_audio_source_pipeline_bis {
+    /** Index of first PCM channel sent over this BIS */
+    uint8_t chan_idx;
+
+    /**
+     * Number of PCM channels sent over this BIS. Each channel is sent as
+     * separate codec frame in the same SDU. Channels of different BISes
+     * must not overlap.
+     */
+    uint8_t chan_cnt;
+};
+
+/** Pipeline parameters */
+struct ble_audio_source_pipeline_params {
+    /** PCM source */
+    struct ble_audio_pcm_source *source;
+
+    /** PCM sampling frequency in Hz */
+    uint32_t pcm_sample_rate;
+
+    /** Number of interleaved PCM channels */
+    uint8_t pcm_chan_cnt;
+
+    /** LC3 sampling frequency in Hz */
+    uint32_t sample_rate;
+
+    /** LC3 frame duration in microseconds, 7500 or 10000 */
+    uint16_t frame_duration;
+
+    /** Number of octets per LC3 codec frame */
+    uint16_t octets_per_frame;
+
+    /**
+     * Resample PCM to LC3 sampling frequency, also if both are equal so
+     * ratio can be adjusted at runtime. Requires
+     * BLE_AUDIO_SOURCE_PIPELINE_RESAMPLE.
+     */
+    uint8_t resample;
+
+    /** Number of BISes */
+    uint8_t bis_cnt;
+
+    /** BIS configurations, @p bis_cnt entries */
+    const struct ble_audio_source_pipeline_bis *bis;
+};
+
+/** Pipeline statistics */
+struct ble_audio_source_pipeline_stats {
+    /** Number of codec frame intervals processed */
+    uint32_t frames;
+
+    /** Number of SDUs passed to ISO */
+    uint32_t sdus;
+
+    /** Number of SDUs which could not be encoded or sent */
+    uint32_t errors;
+};
+
+/**
+ * Creates pipeline.
+ *
+ * @param[in] params            Pipeline parameters.
+ * @param[out] pipeline         On success, created pipeline.
+ *
+ * @return                      0 on success;
+ *                              BLE_HS_EINVAL if parameters are invalid;
+ *                              BLE_HS_ENOMEM if no more pipelines available.
+ */
+int ble_audio_source_pipeline_create(
+    const struct ble_audio_source_pipeline_params *params,
+    struct ble_audio_source_pipeline **pipeline);
+
+/**
+ * Destroys pipeline.
+ *
+ * @param pipeline              Pipeline to destroy.
+ */
+void ble_audio_source_pipeline_destroy(
+    struct ble_audio_source_pipeline *pipeline);
+
+/**
+ * Sets BIS connection handle. SDUs are sent only over BISes with handle set.
+ *
+ * @param pipeline              The pipeline.
+ * @param bis_idx               Index of BIS in pipeline parameters.
+ * @param conn_handle           BIS connection handle, BLE_HS_CONN_HANDLE_NONE
+ *                                  to stop sending.
+ *
+ * @return                      0 on success;
+ *                              BLE_HS_EINVAL if BIS index is invalid.
+ */
+int ble_audio_source_pipeline_bis_handle_set(
+    struct ble_audio_source_pipeline *pipeline, uint8_t bis_idx,
+    uint16_t conn_handle);
+
+/**
+ * Sets resampling ratio, i.e. output to input sampling frequency ratio. Can
+ * be used to compensate drift between PCM source and ISO clocks.
+ *
+ * @param pipeline              The pipeline.
+ * @param ratio                 Resampling ratio.
+ *
+ * @return                      0 on success;
+ *                              BLE_HS_ENOTSUP if pipeline does not resample.
+ */
+int ble_audio_source_pipeline_resample_ratio_set(
+    struct ble_audio_source_pipeline *pipeline, double ratio);
+
+/**
+ * Reads available PCM samples from source and sends all complete codec
+ * frames. Shall be called whenever source has new samples, or periodically
+ * at least once per frame duration.
+ *
+ * @param pipeline              The pipeline.
+ *
+ * @return                      Number of codec frame intervals sent.
+ */
+int ble_audio_source_pipeline_process(
+    struct ble_audio_source_pipeline *pipeline);
+
+/**
+ * Retrieves pipeline statistics.
+ *
+ * @param pipeline              The pipeline.
+ * @param stats                 Statistics are written here.
+ */
+void ble_audio_source_pipeline_stats_get(
+    struct ble_audio_source_pipeline *pipeline,
+    struct ble_audio_source_pipeline_stats *stats);
+
+/**
+ * @brief Initialize Source Pipeline
+ *
+ * This function is restricted to be called by sysinit.
+ *
+ * @return Returns 0 on success, or a non-zero error code otherwise.
+ */
+int ble_audio_source_pipeline_init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* H_BLE_AUDIO_SOURCE_PIPELINE_ */
@@ -527,3 +527,168 @@ ble_audio_base_bis_iter(struct ble_audio_base_iter *bis_iter,
 
     return 0;
 }
+
+static int
+ble_audio_base_put(uint8_t *buf, uint8_t buf_size, uint8_t *offset,
+                   const uint8_t *data, uint8_t data_len)
+{
+    if (buf_size - *offset < data_len) {
+        return BLE_HS_EMSGSIZE;
+    }
+
+    if (data_len > 0) {
+        memcpy(&buf[*offset], data, data_len);
+        *offset += data_len;
+    }
+
+    return 0;
+}
+
+int
+ble_audio_base_build(const struct ble_audio_base *base, uint8_t *buf,
+                     uint8_t buf_size, uint8_t *out_len)
+{
+    struct ble_audio_big_subgroup *subgroup;
+    struct ble_audio_bis *bis;
+    uint8_t hdr[7];
+    uint8_t offset = 0;
+    int rc;
+
+    if (base == NULL || buf == NULL || out_len == NULL) {
+        return BLE_HS_EINVAL;
+    }
+
+    /* Presentation_Delay + Num_Subgroups */
+    put_le24(hdr, base->presentation_delay);
+    hdr[3] = base->num_subgroups;
+    rc = ble_audio_base_put(buf, buf_size, &offset, hdr, 4);
+    if (rc != 0) {
+        return rc;
+    }
+
+    STAILQ_FOREACH(subgroup, &base->subs, next) {
+        /* Num_BIS + Codec_ID + Codec_Specific_Configuration_Length */
+        hdr[0] = subgroup->bis_cnt;
+        hdr[1] = subgroup->codec_id.format;
+        put_le16(&hdr[2], subgroup->codec_id.company_id);
+        put_le16(&hdr[4], subgroup->codec_id.vendor_specific);
+        hdr[6] = subgroup->codec_spec_config_len;
+        rc = ble_audio_base_put(buf, buf_size, &offset, hdr, 7);
+        if (rc != 0) {
+            return rc;
+        }
+
+        rc = ble_audio_base_put(buf, buf_size, &offset,
+                                subgroup->codec_spec_config,
+                                subgroup->codec_spec_config_len);
+        if (rc != 0) {
+            return rc;
+        }
+
+        rc = ble_audio_base_put(buf, buf_size, &offset,
+                                &subgroup->metadata_len, 1);
+        if (rc != 0) {
+            return rc;
+        }
+
+        rc = ble_audio_base_put(buf, buf_size, &offset, subgroup->metadata,
+                                subgroup->metadata_len);
+        if (rc != 0) {
+            return rc;
+        }
+
+        STAILQ_FOREACH(bis, &subgroup->bises, next) {
+            hdr[0] = bis->idx;
+            hdr[1] = bis->codec_spec_config_len;
+            rc = ble_audio_base_put(buf, buf_size, &offset, hdr, 2);
+            if (rc != 0) {
+                return rc;
+            }
+
+            rc = ble_audio_base_put(buf, buf_size, &offset,
+                                    bis->codec_spec_config,
+                                    bis->codec_spec_config_len);
+            if (rc != 0) {
+                return rc;
+            }
+        }
+    }
+
+    *out_len = offset;
+
+    return 0;
+}
+
+int
+ble_audio_base_metadata_set(uint8_t *buf, uint8_t *len, uint8_t buf_size,
+                            uint8_t subgroup_idx, const uint8_t *metadata,
+                            uint8_t metadata_len)
+{
+    struct ble_audio_base_subgroup subgroup;
+    struct ble_audio_base_group group;
+    struct ble_audio_base_iter subgroup_iter;
+    uint8_t *old_md;
+    uint8_t old_len;
+    uint8_t offset;
+    uint8_t first;
+    uint8_t last;
+    uint8_t tail;
+    int rc;
+    int i;
+
+    if (len == NULL || (metadata == NULL && metadata_len > 0)) {
+        return BLE_HS_EINVAL;
+    }
+
+    rc = ble_audio_base_parse(buf, *len, &group, &subgroup_iter);
+    if (rc != 0) {
+        return rc;
+    }
+
+    if (subgroup_idx >= group.num_subgroups) {
+        return BLE_HS_ENOENT;
+    }
+
+    for (i = 0; i <= subgroup_idx; i++) {
+        rc = ble_audio_base_subgroup_iter(&subgroup_iter, &subgroup, NULL);
+        if (rc != 0) {
+            return rc;
+        }
+    }
+
+    /* Metadata_Length precedes Metadata */
+    offset = subgroup.codec_spec_config + subgroup.codec_spec_config_len - buf;
+    old_md = &buf[offset + 1];
+    old_len = subgroup.metadata_len;
+
+    if (old_len == metadata_len) {
+        if (metadata_len == 0 || memcmp(old_md, metadata, metadata_len) == 0) {
+            return BLE_HS_EALREADY;
+        }
+
+        /* Rewrite only the span that differs, i.e. changed LTVs */
+        for (first = 0; old_md[first] == metadata[first]; first++) {
+        }
+        for (last = metadata_len; old_md[last - 1] == metadata[last - 1];
+             last--) {
+        }
+        memcpy(&old_md[first], &metadata[first], last - first);
+
+        return 0;
+    }
+
+    if (buf_size - *len + old_len < metadata_len) {
+        return BLE_HS_EMSGSIZE;
+    }
+
+    /* Shift following subgroups and BISes to new metadata end */
+    tail = *len - (offset + 1 + old_len);
+    memmove(&old_md[metadata_len], &old_md[old_len], tail);
+    if (metadata_len > 0) {
+        memcpy(old_md, metadata, metadata_len);
+    }
+    buf[offset] = metadata_len;
+    *len = *len - old_len + metadata_len;
+
+    return 0;
+}
@@ -24,17 +24,31 @@
 
 #if MYNEWT_VAL(BLE_AUDIO)
 #if MYNEWT_VAL(BLE_ISO_BROADCAST_SOURCE)
+#ifndef min
+#define min(a, b) ((a) < (b) ? (a) : (b))
+#endif
+
+/* AD structure length covers AD type, service data covers UUID and BASE */
+#define BROADCAST_BASE_MAX_LEN \
+    (min(MYNEWT_VAL(BLE_EXT_ADV_MAX_SIZE), UINT8_MAX - 1) - 2)
+
 struct ble_audio_broadcast {
-    SLIST_ENTRY(ble_audio_broadcast) next;
     uint8_t big_handle;
     uint8_t adv_instance;
     struct ble_audio_base *base;
     struct ble_iso_big_params *big_params;
     ble_audio_broadcast_destroy_fn *destroy_cb;
     void *args;
+
+    /* Basic Audio Announcement service data (UUID + BASE), kept so that
+     * metadata updates rewrite only changed LTVs
+     */
+    uint8_t per_svc_data[BROADCAST_BASE_MAX_LEN + 2];
+    uint8_t per_svc_data_len;
 };
 
-static SLIST_HEAD(, ble_audio_broadcast) ble_audio_broadcasts;
+/* Broadcasts indexed by advertising instance */
+static struct ble_audio_broadcast *ble_audio_broadcasts[BLE_ADV_INSTANCES];
 static struct os_mempool ble_audio_broadcast_pool;
 static os_membuf_t ble_audio_broadcast_mem[
     OS_MEMPOOL_SIZE(MYNEWT_VAL(BLE_ISO_MAX_BIGS),
@@ -59,45 +73,136 @@ broadcast_bis_idx_ok(uint8_t bis_idx, struct ble_audio_base *base)
 }
 
 static bool
-broadcast_ltv_ok(uint8_t total_len, uint8_t *data)
+broadcast_ltv_ok(uint8_t total_len, const uint8_t *data)
 {
-    if (total_len == 0 && data == NULL) {
+    uint16_t sum_len = 0;
+
+    if (total_len == 0) {
         return true;
     }
-    uint8_t len = data[0];
-    uint8_t sum_len = 0;
+
+    if (data == NULL) {
+        return false;
+    }
 
     while (total_len > sum_len) {
-        sum_len += len + 1;
-        len = data[sum_len];
+        /* LTV length shall not exceed data left */
+        if (data[sum_len] + 1 > total_len - sum_len) {
+            return false;
+        }
+
+        sum_len += data[sum_len] + 1;
     }
 
-    return total_len == sum_len;
+    return true;
 }
 
 static struct ble_audio_broadcast *
 ble_audio_broadcast_find(uint8_t adv_instance)
 {
-    struct ble_audio_broadcast *broadcast;
+    if (adv_instance >= BLE_ADV_INSTANCES) {
+        return NULL;
+    }
+
+    return ble_audio_broadcasts[adv_instance];
+}
+
+static int
+ble_audio_broadcast_base_validate(struct ble_audio_base *base)
+{
+    struct ble_audio_big_subgroup *subgroup;
+    struct ble_audio_bis *bis;
+
+    if (base->num_subgroups == 0) {
+        /**
+         * BAP specification 3.7.2.2 Basic Audio Announcements:
+         * Rule 1: There shall be at least one subgroup.
+         */
+        BLE_HS_LOG_ERROR("No subgroups in BASE!\n");
+        return BLE_HS_EINVAL;
+    }
+
+    STAILQ_FOREACH(subgroup, &base->subs, next) {
+        if (subgroup->bis_cnt == 0) {
+            /**
+             * BAP specification 3.7.2.2 Basic Audio Announcements:
+             * Rule 2: There shall be at least one BIS per subgroup.
+             */
+            BLE_HS_LOG_ERROR("No BIS in BIG!\n");
+            return BLE_HS_EINVAL;
+        }
 
-    SLIST_FOREACH(broadcast, &ble_audio_broadcasts, next) {
-        if (broadcast->adv_instance == adv_instance) {
-            return broadcast;
+        if (!broadcast_ltv_ok(subgroup->metadata_len, subgroup->metadata)) {
+            BLE_HS_LOG_ERROR("Invalid Metadata!\n");
+            return BLE_HS_EINVAL;
+        }
+
+        if (!broadcast_ltv_ok(subgroup->codec_spec_config_len, subgroup->codec_spec_config)) {
+            BLE_HS_LOG_ERROR("Invalid Codec Configuration in subgroup!\n");
+            return BLE_HS_EINVAL;
+        }
+
+        STAILQ_FOREACH(bis, &subgroup->bises, next) {
+            if (!broadcast_bis_idx_ok(bis->idx, base)) {
+                /**
+                 * BAP specification 3.7.2.2 Basic Audio Announcements:
+                 * Rule 3: Every BIS in the BIG, denoted by its BIS_index
+                 * value, shall only be present in one subgroup.
+                 */
+                BLE_HS_LOG_ERROR("Duplicated BIS index!\n");
+                return BLE_HS_EINVAL;
+            }
+
+            if (!broadcast_ltv_ok(bis->codec_spec_config_len,
+                                  bis->codec_spec_config)) {
+                BLE_HS_LOG_ERROR("Invalid Codec Configuration in BIS!\n");
+                return BLE_HS_EINVAL;
+            }
         }
     }
 
-    return NULL;
+    return 0;
 }
 
-static struct ble_audio_broadcast *
-ble_audio_broadcast_find_last()
+static int
+ble_audio_broadcast_per_adv_set(struct ble_audio_broadcast *broadcast)
 {
-    struct ble_audio_broadcast *broadcast;
+    ble_uuid16_t audio_announcement_uuid[1] = {
+        BLE_UUID16_INIT(BLE_BROADCAST_AUDIO_ANNOUNCEMENT_SVC_UUID)
+    };
+    struct ble_hs_adv_fields per_adv_fields = {
+        .uuids16 = audio_announcement_uuid,
+        .num_uuids16 = 1,
+        .uuids16_is_complete = 1,
+        .svc_data_uuid16 = broadcast->per_svc_data,
+        .svc_data_uuid16_len = broadcast->per_svc_data_len,
+    };
+    struct os_mbuf *adv_data;
+    int rc;
 
-    SLIST_FOREACH(broadcast, &ble_audio_broadcasts, next) {
+    adv_data = os_msys_get_pkthdr(BLE_HCI_MAX_EXT_ADV_DATA_LEN, 0);
+    if (!adv_data) {
+        BLE_HS_LOG_ERROR("No memory\n");
+        return BLE_HS_ENOMEM;
     }
 
-    return broadcast;
+    rc = ble_hs_adv_set_fields_mbuf(&per_adv_fields, adv_data);
+    if (rc) {
+        BLE_HS_LOG_ERROR("Failed to set periodic advertising fields"
+                         "(rc=%d)\n", rc);
+        os_mbuf_free_chain(adv_data);
+        return rc;
+    }
+
+    /* Data is consumed regardless of result */
+    rc = ble_gap_periodic_adv_set_data(broadcast->adv_instance, adv_data,
+                                       NULL);
+    if (rc) {
+        BLE_HS_LOG_ERROR("Failed to set periodic advertising data"
+                         "(rc=%d)\n", rc);
+    }
+
+    return rc;
 }
 
 int
@@ -107,20 +212,15 @@ ble_audio_broadcast_create(const struct ble_broadcast_create_params *params,
                            ble_gap_event_fn *gap_cb)
 {
     int rc;
-    uint8_t offset = 2;
+    uint8_t base_len;
     uint8_t service_data[5] = {0x52, 0x18 };
-    uint8_t per_svc_data[MYNEWT_VAL(BLE_EXT_ADV_MAX_SIZE)] = { 0x51, 0x18 };
-    struct ble_audio_big_subgroup *subgroup;
-    struct ble_audio_bis *bis;
     struct ble_hs_adv_fields adv_fields = {
         .broadcast_name = (uint8_t *) params->name,
         .broadcast_name_len = params->name != NULL ? strlen(params->name) : 0,
         .svc_data_uuid16 = service_data,
         .svc_data_uuid16_len = sizeof(service_data),
     };
-    struct ble_hs_adv_fields per_adv_fields = { 0 };
     struct os_mbuf *adv_data;
-    ble_uuid16_t audio_announcement_uuid[1];
     uint8_t broadcast_id[3];
     struct ble_audio_broadcast *broadcast;
 
@@ -129,7 +229,8 @@ ble_audio_broadcast_create(const struct ble_broadcast_create_params *params,
         return BLE_HS_EINVAL;
     }
 
-    if (strlen(params->name) < 4 || strlen(params->name) > 32) {
+    if (params->name != NULL &&
+        (strlen(params->name) < 4 || strlen(params->name) > 32)) {
         return BLE_HS_EINVAL;
     }
 
@@ -140,10 +241,19 @@ ble_audio_broadcast_create(const struct ble_broadcast_create_params *params,
         return BLE_HS_EALREADY;
     }
 
-    ble_hs_hci_rand(broadcast_id, 3);
-    params->base->broadcast_id = get_le24(broadcast_id);
+    rc = ble_audio_broadcast_base_validate(params->base);
+    if (rc) {
+        return rc;
+    }
 
     broadcast = os_memblock_get(&ble_audio_broadcast_pool);
+    if (!broadcast) {
+        BLE_HS_LOG_ERROR("No memory\n");
+        return BLE_HS_ENOMEM;
+    }
+
+    ble_hs_hci_rand(broadcast_id, 3);
+    params->base->broadcast_id = get_le24(broadcast_id);
 
     broadcast->adv_instance = params->adv_instance;
     broadcast->base = params->base;
@@ -151,106 +261,32 @@ ble_audio_broadcast_create(const struct ble_broadcast_create_params *params,
     broadcast->destroy_cb = destroy_cb;
     broadcast->args = args;
 
-    if (SLIST_EMPTY(&ble_audio_broadcasts)) {
-        SLIST_INSERT_HEAD(&ble_audio_broadcasts, broadcast, next);
-    } else {
-        SLIST_INSERT_AFTER(ble_audio_broadcast_find_last(), broadcast, next);
-    }
-
-    if (params->base->num_subgroups == 0) {
-        /**
-         * BAP specification 3.7.2.2 Basic Audio Announcements:
-         * Rule 1: There shall be at least one subgroup.
-         */
-        BLE_HS_LOG_ERROR("No subgroups in BASE!\n");
-        return BLE_HS_EINVAL;
+    put_le16(broadcast->per_svc_data,
+             BLE_BROADCAST_AUDIO_ANNOUNCEMENT_SVC_UUID);
+    rc = ble_audio_base_build(params->base, &broadcast->per_svc_data[2],
+                              BROADCAST_BASE_MAX_LEN,
+                              &base_len);
+    if (rc) {
+        BLE_HS_LOG_ERROR("BASE does not fit periodic advertising data\n");
+        goto err;
     }
+    broadcast->per_svc_data_len = base_len + 2;
 
     put_le24(&service_data[2], broadcast->base->broadcast_id);
-    put_le24(&per_svc_data[offset], params->base->presentation_delay);
-    offset += 3;
-    per_svc_data[offset] = params->base->num_subgroups;
-    offset++;
-
-    STAILQ_FOREACH(subgroup, &params->base->subs, next) {
-        if (subgroup->bis_cnt == 0) {
-            /**
-             * BAP specification 3.7.2.2 Basic Audio Announcements:
-             * Rule 2: There shall be at least one BIS per subgroup.
-             */
-            BLE_HS_LOG_ERROR("No BIS in BIG!\n");
-            return BLE_HS_EINVAL;
-        }
-
-        if (!broadcast_ltv_ok(subgroup->metadata_len, subgroup->metadata)) {
-            BLE_HS_LOG_ERROR("Invalid Metadata!\n");
-            return BLE_HS_EINVAL;
-        }
-
-        if (!broadcast_ltv_ok(subgroup->codec_spec_config_len, subgroup->codec_spec_config)) {
-            BLE_HS_LOG_ERROR("Invalid Codec Configuration in subgroup!\n");
-            return BLE_HS_EINVAL;
-        }
-
-        per_svc_data[offset] = subgroup->bis_cnt;
-        offset++;
-        memcpy(&per_svc_data[offset], &subgroup->codec_id, 5);
-        offset += 5;
-        per_svc_data[offset] = subgroup->codec_spec_config_len;
-        offset++;
-        memcpy(&per_svc_data[offset], &subgroup->codec_spec_config,
-               subgroup->codec_spec_config_len);
-        offset += subgroup->codec_spec_config_len;
-        per_svc_data[offset] = subgroup->metadata_len;
-        offset++;
-        memcpy(&per_svc_data[offset], &subgroup->metadata,
-               subgroup->metadata_len);
-        offset += subgroup->metadata_len;
-        STAILQ_FOREACH(bis, &subgroup->bises, next) {
-            if (!broadcast_bis_idx_ok(bis->idx, params->base)) {
-                /**
-                 * BAP specification 3.7.2.2 Basic Audio Announcements:
-                 * Rule 3: Every BIS in the BIG, denoted by its BIS_index
-                 * value, shall only be present in one subgroup.
-                 */
-                BLE_HS_LOG_ERROR("Duplicated BIS index!\n");
-                return BLE_HS_EINVAL;
-            }
-
-            if (!broadcast_ltv_ok(bis->codec_spec_config_len,
-                                  bis->codec_spec_config)) {
-                BLE_HS_LOG_ERROR("Invalid Codec Configuration in BIS!\n");
-                return BLE_HS_EINVAL;
-            }
-            per_svc_data[offset] = bis->idx;
-            offset++;
-            per_svc_data[offset] = bis->codec_spec_config_len;
-            offset++;
-            memcpy(&per_svc_data[offset], bis->codec_spec_config,
-                   bis->codec_spec_config_len);
-            offset += bis->codec_spec_config_len;
-        }
-    }
-
-    audio_announcement_uuid[0] = (ble_uuid16_t) BLE_UUID16_INIT(BLE_BROADCAST_AUDIO_ANNOUNCEMENT_SVC_UUID);
-    per_adv_fields.uuids16 = audio_announcement_uuid;
-    per_adv_fields.num_uuids16 = 1;
-    per_adv_fields.uuids16_is_complete = 1;
-    per_adv_fields.svc_data_uuid16 = per_svc_data;
-    per_adv_fields.svc_data_uuid16_len = offset;
 
     rc = ble_gap_ext_adv_configure(params->adv_instance,
                                    params->extended_params, 0,
                                    gap_cb, NULL);
     if (rc) {
         BLE_HS_LOG_ERROR("Could not configure the broadcast (rc=%d)\n", rc);
-        return 0;
+        goto err;
     }
 
     adv_data = os_msys_get_pkthdr(BLE_HCI_MAX_EXT_ADV_DATA_LEN, 0);
     if (!adv_data) {
         BLE_HS_LOG_ERROR("No memory\n");
-        return BLE_HS_ENOMEM;
+        rc = BLE_HS_ENOMEM;
+        goto err;
     }
 
     /* Set ext advertising data */
@@ -258,7 +294,8 @@ ble_audio_broadcast_create(const struct ble_broadcast_create_params *params,
     if (rc) {
         BLE_HS_LOG_ERROR("Failed to set extended advertising fields"
                          "(rc=%d)\n", rc);
-        return rc;
+        os_mbuf_free_chain(adv_data);
+        goto err;
     }
 
     os_mbuf_append(adv_data, params->svc_data, params->svc_data_len);
@@ -267,36 +304,27 @@ ble_audio_broadcast_create(const struct ble_broadcast_create_params *params,
     if (rc) {
         BLE_HS_LOG_ERROR("Failed to set extended advertising data"
                          "(rc=%d)\n", rc);
-        return rc;
-    }
-
-    /* Clear buffer */
-    adv_data = os_msys_get_pkthdr(BLE_HCI_MAX_EXT_ADV_DATA_LEN, 0);
-    if (!adv_data) {
-        BLE_HS_LOG_ERROR("No memory\n");
-        return BLE_HS_ENOMEM;
+        goto err;
     }
 
     rc = ble_gap_periodic_adv_configure(params->adv_instance, params->periodic_params);
     if (rc) {
         BLE_HS_LOG_ERROR("failed to configure periodic advertising"
                          "(rc=%d)\n", rc);
-        return rc;
+        goto err;
     }
 
-    rc = ble_hs_adv_set_fields_mbuf(&per_adv_fields, adv_data);
+    rc = ble_audio_broadcast_per_adv_set(broadcast);
     if (rc) {
-        BLE_HS_LOG_ERROR("Failed to set periodic advertising fields"
-                         "(rc=%d)\n", rc);
-        return rc;
+        goto err;
     }
 
-    rc = ble_gap_periodic_adv_set_data(params->adv_instance, adv_data, NULL);
-    if (rc) {
-        BLE_HS_LOG_ERROR("Failed to set periodic advertising data"
-                         "(rc=%d)\n", rc);
-    }
+    ble_audio_broadcasts[params->adv_instance] = broadcast;
 
+    return 0;
+
+err:
+    os_memblock_put(&ble_audio_broadcast_pool, broadcast);
     return rc;
 }
 
@@ -387,8 +415,8 @@ ble_audio_broadcast_destroy(uint8_t adv_instance)
         return rc;
     }
 
+    ble_audio_broadcasts[adv_instance] = NULL;
     os_memblock_put(&ble_audio_broadcast_pool, broadcast);
-    SLIST_REMOVE(&ble_audio_broadcasts, broadcast, ble_audio_broadcast, next);
 
     return 0;
 }
@@ -432,6 +460,58 @@ ble_audio_broadcast_update(const struct ble_broadcast_update_params *params)
     return 0;
 }
 
+int
+ble_audio_broadcast_metadata_update(uint8_t adv_instance,
+                                    uint8_t subgroup_idx,
+                                    uint8_t *metadata, uint8_t metadata_len)
+{
+    struct ble_audio_big_subgroup *subgroup;
+    struct ble_audio_broadcast *broadcast;
+    uint8_t base_len;
+    uint8_t i = 0;
+    int rc;
+
+    broadcast = ble_audio_broadcast_find(adv_instance);
+    if (!broadcast) {
+        return BLE_HS_ENOENT;
+    }
+
+    STAILQ_FOREACH(subgroup, &broadcast->base->subs, next) {
+        if (i == subgroup_idx) {
+            break;
+        }
+        i++;
+    }
+
+    if (!subgroup) {
+        return BLE_HS_ENOENT;
+    }
+
+    if (!broadcast_ltv_ok(metadata_len, metadata)) {
+        BLE_HS_LOG_ERROR("Invalid Metadata!\n");
+        return BLE_HS_EINVAL;
+    }
+
+    base_len = broadcast->per_svc_data_len - 2;
+    rc = ble_audio_base_metadata_set(&broadcast->per_svc_data[2], &base_len,
+                                     BROADCAST_BASE_MAX_LEN,
+                                     subgroup_idx, metadata, metadata_len);
+    if (rc == BLE_HS_EALREADY) {
+        /* Nothing changed, keep current periodic advertising data */
+        subgroup->metadata = metadata;
+        return 0;
+    }
+    if (rc) {
+        return rc;
+    }
+
+    subgroup->metadata = metadata;
+    subgroup->metadata_len = metadata_len;
+    broadcast->per_svc_data_len = base_len + 2;
+
+    return ble_audio_broadcast_per_adv_set(broadcast);
+}
+
 int
 ble_audio_broadcast_build_sub(struct ble_audio_base *base,
                               struct ble_audio_big_subgroup *sub,
@@ -483,7 +563,7 @@ ble_audio_broadcast_init(void)
 {
     int rc;
 
-    SLIST_INIT(&ble_audio_broadcasts);
+    memset(ble_audio_broadcasts, 0, sizeof(ble_audio_broadcasts));
 
     rc = os_mempool_init(&ble_audio_broadcast_pool,
                          MYNEWT_VAL(BLE_ISO_MAX_BIGS),
@@ -0,0 +1,728 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "syscfg/syscfg.h"
+
+#if MYNEWT_VAL(BLE_AUDIO_SINK_PIPELINE)
+#include <string.h>
+#include <lc3.h>
+#include "os/os.h"
+#include "os/os_mbuf.h"
+#include "sysinit/sysinit.h"
+#include "host/ble_hs.h"
+#include "host/ble_iso.h"
+#include "audio/ble_audio_sink_pipeline.h"
+
+#if MYNEWT_VAL(BLE_AUDIO_SINK_PIPELINE_RESAMPLE)
+#include <samplerate.h>
+#endif
+
+#define PIPELINE_CHAN_MAX   MYNEWT_VAL(BLE_AUDIO_SINK_PIPELINE_CHAN_MAX)
+#define PIPELINE_BIS_MAX    MYNEWT_VAL(BLE_AUDIO_SINK_PIPELINE_BIS_MAX)
+#define PIPELINE_JB_DEPTH   MYNEWT_VAL(BLE_AUDIO_SINK_PIPELINE_JB_DEPTH)
+#define PIPELINE_JB_TARGET  MYNEWT_VAL(BLE_AUDIO_SINK_PIPELINE_JB_TARGET)
+#define PIPELINE_PCM_FRAMES MYNEWT_VAL(BLE_AUDIO_SINK_PIPELINE_PCM_FRAMES)
+
+#define min(a, b) ((a) < (b) ? (a) : (b))
+
+#if PIPELINE_JB_TARGET >= PIPELINE_JB_DEPTH
+#error "BLE_AUDIO_SINK_PIPELINE_JB_TARGET shall be less than JB_DEPTH"
+#endif
+
+/*
+ * Drift compensation: resampling ratio is corrected proportionally to
+ * deviation of averaged jitter buffer fill level from target, up to 0.5%.
+ */
+#define PIPELINE_DRIFT_GAIN     0.0005
+#define PIPELINE_DRIFT_MAX      0.005
+
+struct pipeline_slot {
+    struct os_mbuf *om;
+    uint32_t idx;
+    uint8_t status;
+};
+
+struct pipeline_bis {
+    struct ble_audio_sink_pipeline_bis cfg;
+    uint16_t conn_handle;
+
+    /* Jitter buffer, SDU of frame index i is stored in slot i % depth */
+    struct pipeline_slot slots[PIPELINE_JB_DEPTH];
+};
+
+struct ble_audio_sink_pipeline {
+    uint8_t chan_cnt;
+    uint16_t frame_samples;
+    uint32_t sdu_interval;
+
+    uint8_t bis_cnt;
+    struct pipeline_bis bis[PIPELINE_BIS_MAX];
+
+    /*
+     * Frame index of received SDU is derived from last accepted SDU, so
+     * wrapping timestamps and sequence numbers need no special handling.
+     */
+    bool synced;
+    bool started;
+    bool anchor_ts_valid;
+    uint32_t anchor_ts;
+    uint16_t anchor_seq;
+    uint32_t anchor_idx;
+
+    /* Next frame to decode and one past newest frame received */
+    uint32_t play_idx;
+    uint32_t end_idx;
+
+    /* Consecutive frames with no SDU on any BIS */
+    uint8_t lost_run;
+
+    lc3_decoder_t decoders[PIPELINE_CHAN_MAX];
+    lc3_decoder_mem_48k_t decoder_mem[PIPELINE_CHAN_MAX];
+
+    /* Used if codec frame is not contiguous in mbuf */
+    uint8_t frame_buf[LC3_MAX_FRAME_BYTES];
+
+    /* Interleaved PCM ready for reading, valid between start and end */
+    int16_t pcm[PIPELINE_PCM_FRAMES * PIPELINE_CHAN_MAX];
+    uint16_t pcm_start;
+    uint16_t pcm_end;
+
+#if MYNEWT_VAL(BLE_AUDIO_SINK_PIPELINE_RESAMPLE)
+    SRC_STATE *resampler;
+    double ratio_base;
+    double ratio;
+    /* Averaged fill level, in 1/16 of SDU */
+    int32_t fill_avg;
+    int16_t dec[PIPELINE_PCM_FRAMES * PIPELINE_CHAN_MAX];
+    uint16_t dec_cnt;
+    float in_float[PIPELINE_PCM_FRAMES * PIPELINE_CHAN_MAX];
+    float out_float[PIPELINE_PCM_FRAMES * PIPELINE_CHAN_MAX];
+#endif
+
+    struct ble_audio_sink_pipeline_stats stats;
+};
+
+static struct os_mempool pipeline_pool;
+static os_membuf_t pipeline_mem[
+    OS_MEMPOOL_SIZE(MYNEWT_VAL(BLE_AUDIO_SINK_PIPELINE_MAX),
+                    sizeof(struct ble_audio_sink_pipeline))];
+
+static struct pipeline_bis *
+pipeline_bis_find(struct ble_audio_sink_pipeline *pipeline,
+                  uint16_t conn_handle)
+{
+    uint8_t i;
+
+    if (conn_handle == BLE_HS_CONN_HANDLE_NONE) {
+        return NULL;
+    }
+
+    for (i = 0; i < pipeline->bis_cnt; i++) {
+        if (pipeline->bis[i].conn_handle == conn_handle) {
+            return &pipeline->bis[i];
+        }
+    }
+
+    return NULL;
+}
+
+static void
+pipeline_slot_free(struct pipeline_slot *slot)
+{
+    if (slot->om != NULL) {
+        os_mbuf_free_chain(slot->om);
+        slot->om = NULL;
+    }
+}
+
+/* Shall be called with interrupts disabled */
+static void
+pipeline_reset(struct ble_audio_sink_pipeline *pipeline)
+{
+    uint8_t i;
+    uint8_t j;
+
+    for (i = 0; i < pipeline->bis_cnt; i++) {
+        for (j = 0; j < PIPELINE_JB_DEPTH; j++) {
+            pipeline_slot_free(&pipeline->bis[i].slots[j]);
+        }
+    }
+
+    pipeline->synced = false;
+    pipeline->started = false;
+    pipeline->lost_run = 0;
+}
+
+/*
+ * Drops oldest frames, shall be called with interrupts disabled. Mbufs of
+ * dropped frames are stored in drop to be freed after critical section, number
+ * of stored mbufs is returned.
+ */
+static uint16_t
+pipeline_skip(struct ble_audio_sink_pipeline *pipeline, uint32_t cnt,
+              struct os_mbuf **drop)
+{
+    struct pipeline_slot *slot;
+    uint16_t drop_cnt = 0;
+    uint32_t idx;
+    uint8_t i;
+
+    /* If whole buffer is skipped each slot is checked only once */
+    for (idx = pipeline->play_idx;
+         idx != pipeline->play_idx + min(cnt, PIPELINE_JB_DEPTH); idx++) {
+        for (i = 0; i < pipeline->bis_cnt; i++) {
+            slot = &pipeline->bis[i].slots[idx % PIPELINE_JB_DEPTH];
+            if (slot->om != NULL &&
+                slot->idx - pipeline->play_idx < cnt) {
+                drop[drop_cnt++] = slot->om;
+                slot->om = NULL;
+                pipeline->stats.overflows++;
+            }
+        }
+    }
+
+    pipeline->play_idx += cnt;
+    if ((int32_t)(pipeline->end_idx - pipeline->play_idx) < 0) {
+        pipeline->end_idx = pipeline->play_idx;
+    }
+
+    return drop_cnt;
+}
+
+static int32_t
+pipeline_ts_frames(struct ble_audio_sink_pipeline *pipeline, int32_t diff)
+{
+    int32_t half = pipeline->sdu_interval / 2;
+
+    /* Rounded to nearest interval, tolerates timestamp jitter */
+    if (diff >= 0) {
+        return (diff + half) / (int32_t)pipeline->sdu_interval;
+    }
+
+    return -((-diff + half) / (int32_t)pipeline->sdu_interval);
+}
+
+/* Shall be called with interrupts disabled */
+static uint32_t
+pipeline_sdu_idx(struct ble_audio_sink_pipeline *pipeline,
+                 const struct ble_iso_rx_data_info *info)
+{
+    int32_t diff;
+
+    if (!pipeline->synced) {
+        pipeline->synced = true;
+        pipeline->end_idx = pipeline->play_idx;
+        return pipeline->play_idx;
+    }
+
+    if (info->ts_valid && pipeline->anchor_ts_valid) {
+        diff = pipeline_ts_frames(pipeline,
+                                  (int32_t)(info->ts - pipeline->anchor_ts));
+    } else {
+        diff = (int16_t)(info->seq_num - pipeline->anchor_seq);
+    }
+
+    return pipeline->anchor_idx + diff;
+}
+
+int
+ble_audio_sink_pipeline_rx(struct ble_audio_sink_pipeline *pipeline,
+                           uint16_t conn_handle,
+                           const struct ble_iso_rx_data_info *info,
+                           struct os_mbuf *om)
+{
+    struct os_mbuf *drop[PIPELINE_BIS_MAX * PIPELINE_JB_DEPTH + 1];
+    struct pipeline_slot *slot;
+    struct pipeline_bis *bis;
+    uint16_t drop_cnt = 0;
+    uint32_t idx;
+    int32_t off;
+    os_sr_t sr;
+    int rc = 0;
+
+    bis = pipeline_bis_find(pipeline, conn_handle);
+    if (bis == NULL) {
+        os_mbuf_free_chain(om);
+        return BLE_HS_ENOENT;
+    }
+
+    OS_ENTER_CRITICAL(sr);
+
+    idx = pipeline_sdu_idx(pipeline, info);
+    off = idx - pipeline->play_idx;
+
+    if (off < 0) {
+        pipeline->stats.late++;
+        drop[drop_cnt++] = om;
+        rc = BLE_HS_ETIMEOUT;
+        goto done;
+    }
+
+    /* Reader is behind, make room by dropping oldest frames */
+    if (off >= PIPELINE_JB_DEPTH) {
+        drop_cnt = pipeline_skip(pipeline, off - PIPELINE_JB_DEPTH + 1, drop);
+    }
+
+    /* Duplicate SDU replaces previous one */
+    slot = &bis->slots[idx % PIPELINE_JB_DEPTH];
+    if (slot->om != NULL) {
+        drop[drop_cnt++] = slot->om;
+    }
+    slot->om = om;
+    slot->idx = idx;
+    slot->status = info->status;
+
+    if ((int32_t)(idx + 1 - pipeline->end_idx) > 0) {
+        pipeline->end_idx = idx + 1;
+    }
+
+    pipeline->anchor_idx = idx;
+    pipeline->anchor_seq = info->seq_num;
+    pipeline->anchor_ts = info->ts;
+    pipeline->anchor_ts_valid = info->ts_valid;
+
+    pipeline->stats.sdus++;
+
+done:
+    OS_EXIT_CRITICAL(sr);
+
+    while (drop_cnt > 0) {
+        os_mbuf_free_chain(drop[--drop_cnt]);
+    }
+
+    return rc;
+}
+
+int
+ble_audio_sink_pipeline_iso_event(struct ble_iso_event *event, void *arg)
+{
+    struct ble_audio_sink_pipeline *pipeline = arg;
+
+    if (event->type == BLE_ISO_EVENT_ISO_RX) {
+        ble_audio_sink_pipeline_rx(pipeline, event->iso_rx.conn_handle,
+                                   event->iso_rx.info, event->iso_rx.om);
+    }
+
+    return 0;
+}
+
+static void
+pipeline_bis_decode(struct ble_audio_sink_pipeline *pipeline,
+                    struct pipeline_bis *bis, struct os_mbuf *om,
+                    uint8_t status, int16_t *pcm)
+{
+    const uint8_t *data;
+    uint16_t frame_len = 0;
+    uint16_t off;
+    uint8_t ch;
+    int rc;
+
+    if (om != NULL && status != BLE_ISO_DATA_STATUS_VALID) {
+        pipeline->stats.errors++;
+    }
+
+    if (om != NULL) {
+        frame_len = OS_MBUF_PKTLEN(om) / bis->cfg.chan_cnt;
+    }
+
+    for (ch = 0; ch < bis->cfg.chan_cnt; ch++) {
+        data = NULL;
+
+        if (om != NULL && status == BLE_ISO_DATA_STATUS_VALID &&
+            frame_len > 0 && frame_len <= LC3_MAX_FRAME_BYTES) {
+            off = ch * frame_len;
+
+            /* Decode directly from mbuf if codec frame is contiguous */
+            if (om->om_len >= off + frame_len) {
+                data = om->om_data + off;
+            } else if (os_mbuf_copydata(om, off, frame_len,
+                                        pipeline->frame_buf) == 0) {
+                data = pipeline->frame_buf;
+            }
+        }
+
+        /* Decoder conceals frame if there is no data or it is corrupted */
+        rc = lc3_decode(pipeline->decoders[bis->cfg.chan_idx + ch], data,
+                        frame_len, LC3_PCM_FORMAT_S16,
+                        pcm + bis->cfg.chan_idx + ch, pipeline->chan_cnt);
+        if (rc != 0) {
+            pipeline->stats.plc++;
+        }
+    }
+}
+
+static void
+pipeline_frame_decode(struct ble_audio_sink_pipeline *pipeline, int16_t *pcm)
+{
+    struct os_mbuf *om[PIPELINE_BIS_MAX];
+    uint8_t status[PIPELINE_BIS_MAX];
+    struct pipeline_slot *slot;
+    uint8_t received = 0;
+    int32_t fill;
+    uint8_t i;
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+
+    fill = pipeline->end_idx - pipeline->play_idx;
+
+    for (i = 0; i < pipeline->bis_cnt; i++) {
+        slot = &pipeline->bis[i].slots[pipeline->play_idx % PIPELINE_JB_DEPTH];
+        om[i] = NULL;
+        status[i] = BLE_ISO_DATA_STATUS_LOST;
+
+        if (slot->om != NULL && slot->idx == pipeline->play_idx) {
+            om[i] = slot->om;
+            status[i] = slot->status;
+            slot->om = NULL;
+            received++;
+        }
+    }
+
+    pipeline->play_idx++;
+
+    OS_EXIT_CRITICAL(sr);
+
+    /* Channels of BISes which are not received stay silent */
+    memset(pcm, 0, pipeline->frame_samples * pipeline->chan_cnt *
+                   sizeof(pcm[0]));
+
+    for (i = 0; i < pipeline->bis_cnt; i++) {
+        if (pipeline->bis[i].conn_handle == BLE_HS_CONN_HANDLE_NONE) {
+            continue;
+        }
+
+        if (om[i] == NULL) {
+            pipeline->stats.lost++;
+        }
+
+        pipeline_bis_decode(pipeline, &pipeline->bis[i], om[i], status[i],
+                            pcm);
+
+        if (om[i] != NULL) {
+            os_mbuf_free_chain(om[i]);
+        }
+    }
+
+    pipeline->stats.frames++;
+    pipeline->stats.fill = fill > 0 ? fill : 0;
+
+#if MYNEWT_VAL(BLE_AUDIO_SINK_PIPELINE_RESAMPLE)
+    if (pipeline->resampler != NULL) {
+        double corr;
+
+        pipeline->fill_avg += (fill * 16 - pipeline->fill_avg) / 16;
+        corr = (pipeline->fill_avg / 16.0 - PIPELINE_JB_TARGET) *
+               PIPELINE_DRIFT_GAIN;
+        if (corr > PIPELINE_DRIFT_MAX) {
+            corr = PIPELINE_DRIFT_MAX;
+        } else if (corr < -PIPELINE_DRIFT_MAX) {
+            corr = -PIPELINE_DRIFT_MAX;
+        }
+
+        /* Buffer filling up means ISO is faster, so consume more input */
+        pipeline->ratio = pipeline->ratio_base * (1.0 - corr);
+    }
+#endif
+
+    /* Stream is gone, wait for new SDUs and buffer them before playout */
+    if (received == 0) {
+        if (++pipeline->lost_run >= PIPELINE_JB_DEPTH) {
+            OS_ENTER_CRITICAL(sr);
+            pipeline_reset(pipeline);
+            OS_EXIT_CRITICAL(sr);
+        }
+    } else {
+        pipeline->lost_run = 0;
+    }
+}
+
+#if MYNEWT_VAL(BLE_AUDIO_SINK_PIPELINE_RESAMPLE)
+static void
+pipeline_fill_resampled(struct ble_audio_sink_pipeline *pipeline)
+{
+    uint16_t used;
+    SRC_DATA sd;
+    int rc;
+
+    if (pipeline->dec_cnt + pipeline->frame_samples <= PIPELINE_PCM_FRAMES) {
+        pipeline_frame_decode(pipeline,
+                              &pipeline->dec[pipeline->dec_cnt *
+                                             pipeline->chan_cnt]);
+        pipeline->dec_cnt += pipeline->frame_samples;
+    }
+
+    src_short_to_float_array(pipeline->dec, pipeline->in_float,
+                             pipeline->dec_cnt * pipeline->chan_cnt);
+
+    memset(&sd, 0, sizeof(sd));
+    sd.data_in = pipeline->in_float;
+    sd.data_out = pipeline->out_float;
+    sd.input_frames = pipeline->dec_cnt;
+    sd.output_frames = PIPELINE_PCM_FRAMES;
+    sd.src_ratio = pipeline->ratio;
+
+    rc = src_process(pipeline->resampler, &sd);
+    if (rc != 0) {
+        pipeline->dec_cnt = 0;
+        return;
+    }
+
+    src_float_to_short_array(pipeline->out_float, pipeline->pcm,
+                             sd.output_frames_gen * pipeline->chan_cnt);
+    pipeline->pcm_end = sd.output_frames_gen;
+
+    used = sd.input_frames_used;
+    memmove(pipeline->dec, &pipeline->dec[used * pipeline->chan_cnt],
+            (pipeline->dec_cnt - used) * pipeline->chan_cnt *
+            sizeof(pipeline->dec[0]));
+    pipeline->dec_cnt -= used;
+}
+#endif
+
+static void
+pipeline_fill(struct ble_audio_sink_pipeline *pipeline)
+{
+    pipeline->pcm_start = 0;
+    pipeline->pcm_end = 0;
+
+#if MYNEWT_VAL(BLE_AUDIO_SINK_PIPELINE_RESAMPLE)
+    if (pipeline->resampler != NULL) {
+        pipeline_fill_resampled(pipeline);
+        return;
+    }
+#endif
+
+    pipeline_frame_decode(pipeline, pipeline->pcm);
+    pipeline->pcm_end = pipeline->frame_samples;
+}
+
+static bool
+pipeline_playing(struct ble_audio_sink_pipeline *pipeline)
+{
+    bool playing;
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+
+    if (!pipeline->started && pipeline->synced &&
+        (int32_t)(pipeline->end_idx - pipeline->play_idx) >=
+        PIPELINE_JB_TARGET) {
+        pipeline->started = true;
+        pipeline->lost_run = 0;
+    }
+
+    playing = pipeline->started;
+
+    OS_EXIT_CRITICAL(sr);
+
+    return playing;
+}
+
+uint16_t
+ble_audio_sink_pipeline_read(struct ble_audio_sink_pipeline *pipeline,
+                             int16_t *pcm, uint16_t frames)
+{
+    uint16_t done = 0;
+    uint16_t len;
+
+    while (done < frames) {
+        if (pipeline->pcm_start == pipeline->pcm_end) {
+            if (!pipeline_playing(pipeline)) {
+                memset(&pcm[done * pipeline->chan_cnt], 0,
+                       (frames - done) * pipeline->chan_cnt * sizeof(pcm[0]));
+                pipeline->stats.underruns++;
+                break;
+            }
+
+            pipeline_fill(pipeline);
+            continue;
+        }
+
+        len = min(frames - done, pipeline->pcm_end - pipeline->pcm_start);
+        memcpy(&pcm[done * pipeline->chan_cnt],
+               &pipeline->pcm[pipeline->pcm_start * pipeline->chan_cnt],
+               len * pipeline->chan_cnt * sizeof(pcm[0]));
+        pipeline->pcm_start += len;
+        done += len;
+    }
+
+    return frames;
+}
+
+int
+ble_audio_sink_pipeline_create(
+    const struct ble_audio_sink_pipeline_params *params,
+    struct ble_audio_sink_pipeline **pipeline)
+{
+    struct ble_audio_sink_pipeline *p;
+    uint32_t decoder_rate;
+    uint8_t i;
+    int rc;
+
+    if (params->pcm_chan_cnt == 0 ||
+        params->pcm_chan_cnt > PIPELINE_CHAN_MAX ||
+        params->bis_cnt > PIPELINE_BIS_MAX) {
+        return BLE_HS_EINVAL;
+    }
+
+#if !MYNEWT_VAL(BLE_AUDIO_SINK_PIPELINE_RESAMPLE)
+    if (params->resample) {
+        return BLE_HS_ENOTSUP;
+    }
+#endif
+
+    for (i = 0; i < params->bis_cnt; i++) {
+        if (params->bis[i].chan_cnt == 0 ||
+            params->bis[i].chan_idx + params->bis[i].chan_cnt >
+            params->pcm_chan_cnt) {
+            return BLE_HS_EINVAL;
+        }
+    }
+
+    /* Resampler takes PCM at LC3 sampling frequency */
+    decoder_rate = params->resample ? params->sample_rate :
+                                      params->pcm_sample_rate;
+
+    rc = lc3_frame_samples(params->frame_duration, decoder_rate);
+    if (rc <= 0 || rc > PIPELINE_PCM_FRAMES) {
+        return BLE_HS_EINVAL;
+    }
+
+    p = os_memblock_get(&pipeline_pool);
+    if (p == NULL) {
+        return BLE_HS_ENOMEM;
+    }
+
+    memset(p, 0, sizeof(*p));
+    p->chan_cnt = params->pcm_chan_cnt;
+    p->frame_samples = rc;
+    p->sdu_interval = params->sdu_interval ? params->sdu_interval :
+                                             params->frame_duration;
+    p->bis_cnt = params->bis_cnt;
+
+    for (i = 0; i < params->bis_cnt; i++) {
+        p->bis[i].cfg = params->bis[i];
+        p->bis[i].conn_handle = BLE_HS_CONN_HANDLE_NONE;
+    }
+
+    for (i = 0; i < p->chan_cnt; i++) {
+        p->decoders[i] = lc3_setup_decoder(params->frame_duration,
+                                           params->sample_rate, decoder_rate,
+                                           &p->decoder_mem[i]);
+        if (p->decoders[i] == NULL) {
+            os_memblock_put(&pipeline_pool, p);
+            return BLE_HS_EINVAL;
+        }
+    }
+
+#if MYNEWT_VAL(BLE_AUDIO_SINK_PIPELINE_RESAMPLE)
+    if (params->resample) {
+        p->ratio_base = (double)params->pcm_sample_rate / params->sample_rate;
+        p->ratio = p->ratio_base;
+        p->fill_avg = PIPELINE_JB_TARGET * 16;
+        p->resampler = src_new(SRC_SINC_FASTEST, p->chan_cnt, &rc);
+        if (p->resampler == NULL) {
+            os_memblock_put(&pipeline_pool, p);
+            return BLE_HS_ENOMEM;
+        }
+    }
+#endif
+
+    *pipeline = p;
+
+    return 0;
+}
+
+void
+ble_audio_sink_pipeline_destroy(struct ble_audio_sink_pipeline *pipeline)
+{
+    os_sr_t sr;
+
+    OS_ENTER_CRITICAL(sr);
+    pipeline_reset(pipeline);
+    OS_EXIT_CRITICAL(sr);
+
+#if MYNEWT_VAL(BLE_AUDIO_SINK_PIPELINE_RESAMPLE)
+    if (pipeline->resampler != NULL) {
+        src_delete(pipeline->resampler);
+    }
+#endif
+
+    os_memblock_put(&pipeline_pool, pipeline);
+}
+
+int
+ble_audio_sink_pipeline_bis_handle_set(
+    struct ble_audio_sink_pipeline *pipeline, uint8_t bis_idx,
+    uint16_t conn_handle)
+{
+    struct pipeline_bis *bis;
+    os_sr_t sr;
+    uint8_t i;
+
+    if (bis_idx >= pipeline->bis_cnt) {
+        return BLE_HS_EINVAL;
+    }
+
+    bis = &pipeline->bis[bis_idx];
+
+    OS_ENTER_CRITICAL(sr);
+    for (i = 0; i < PIPELINE_JB_DEPTH; i++) {
+        pipeline_slot_free(&bis->slots[i]);
+    }
+    bis->conn_handle = conn_handle;
+    OS_EXIT_CRITICAL(sr);
+
+    return 0;
+}
+
+void
+ble_audio_sink_pipeline_stats_get(struct ble_audio_sink_pipeline *pipeline,
+                                  struct ble_audio_sink_pipeline_stats *stats)
+{
+    *stats = pipeline->stats;
+
+#if MYNEWT_VAL(BLE_AUDIO_SINK_PIPELINE_RESAMPLE)
+    if (pipeline->resampler != NULL) {
+        stats->ratio_ppm = pipeline->ratio * 1000000;
+        return;
+    }
+#endif
+
+    stats->ratio_ppm = 1000000;
+}
+
+int
+ble_audio_sink_pipeline_init(void)
+{
+    int rc;
+
+    /* Ensure this function only gets called by sysinit. */
+    SYSINIT_ASSERT_ACTIVE();
+
+    rc = os_mempool_init(&pipeline_pool,
+                         MYNEWT_VAL(BLE_AUDIO_SINK_PIPELINE_MAX),
+                         sizeof(struct ble_audio_sink_pipeline),
+                         pipeline_mem, "ble_audio_sink_pipeline_pool");
+    SYSINIT_PANIC_ASSERT(rc == 0);
+
+    return 0;
+}
+#endif /* BLE_AUDIO_SINK_PIPELINE */
@@ -0,0 +1,613 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include "syscfg/syscfg.h"
+
+#if MYNEWT_VAL(BLE_AUDIO_SOURCE_PIPELINE)
+#include <string.h>
+#include <lc3.h>
+#include "os/os.h"
+#include "os/os_mbuf.h"
+#include "sysinit/sysinit.h"
+#include "host/ble_hs.h"
+#include "host/ble_iso.h"
+#include "audio/ble_audio_source_pipeline.h"
+
+#if MYNEWT_VAL(BLE_AUDIO_SOURCE_PIPELINE_RESAMPLE)
+#include <samplerate.h>
+#endif
+
+#if MYNEWT_VAL(BLE_AUDIO_SOURCE_PIPELINE_WORKERS) > 0
+#include <pthread.h>
+#endif
+
+#define PIPELINE_CHAN_MAX   MYNEWT_VAL(BLE_AUDIO_SOURCE_PIPELINE_CHAN_MAX)
+#define PIPELINE_BIS_MAX    MYNEWT_VAL(BLE_AUDIO_SOURCE_PIPELINE_BIS_MAX)
+#define PIPELINE_PCM_FRAMES MYNEWT_VAL(BLE_AUDIO_SOURCE_PIPELINE_PCM_FRAMES)
+#define PIPELINE_WORKERS    MYNEWT_VAL(BLE_AUDIO_SOURCE_PIPELINE_WORKERS)
+
+struct pipeline_bis {
+    struct ble_audio_source_pipeline_bis cfg;
+    uint16_t conn_handle;
+
+    /* SDU being encoded in current frame interval */
+    struct os_mbuf *om;
+    uint8_t *sdu;
+};
+
+#if PIPELINE_WORKERS > 0
+struct pipeline_worker {
+    struct ble_audio_source_pipeline *pipeline;
+    pthread_t thread;
+    uint8_t idx;
+};
+#endif
+
+struct ble_audio_source_pipeline {
+    struct ble_audio_pcm_source *source;
+    uint8_t chan_cnt;
+    uint16_t octets_per_frame;
+    uint16_t frame_samples;
+    uint16_t seq_num;
+
+    uint8_t bis_cnt;
+    struct pipeline_bis bis[PIPELINE_BIS_MAX];
+
+    lc3_encoder_t encoders[PIPELINE_CHAN_MAX];
+    lc3_encoder_mem_48k_t encoder_mem[PIPELINE_CHAN_MAX];
+
+    /* Interleaved PCM ready for encoding, valid between start and end */
+    int16_t pcm[PIPELINE_PCM_FRAMES * PIPELINE_CHAN_MAX];
+    uint16_t pcm_start;
+    uint16_t pcm_end;
+
+#if MYNEWT_VAL(BLE_AUDIO_SOURCE_PIPELINE_RESAMPLE)
+    SRC_STATE *resampler;
+    double ratio;
+    int16_t in[PIPELINE_PCM_FRAMES * PIPELINE_CHAN_MAX];
+    uint16_t in_cnt;
+    float in_float[PIPELINE_PCM_FRAMES * PIPELINE_CHAN_MAX];
+    float out_float[PIPELINE_PCM_FRAMES * PIPELINE_CHAN_MAX];
+#endif
+
+#if PIPELINE_WORKERS > 0
+    struct pipeline_worker workers[PIPELINE_WORKERS];
+    pthread_mutex_t lock;
+    pthread_cond_t job_cond;
+    pthread_cond_t done_cond;
+    const int16_t *job_pcm;
+    uint32_t job_gen;
+    uint8_t job_done;
+    bool stop;
+#endif
+
+    struct ble_audio_source_pipeline_stats stats;
+};
+
+static struct os_mempool pipeline_pool;
+static os_membuf_t pipeline_mem[
+    OS_MEMPOOL_SIZE(MYNEWT_VAL(BLE_AUDIO_SOURCE_PIPELINE_MAX),
+                    sizeof(struct ble_audio_source_pipeline))];
+
+static void
+pipeline_bis_encode(struct ble_audio_source_pipeline *pipeline,
+                    struct pipeline_bis *bis, const int16_t *pcm)
+{
+    uint8_t ch;
+    int rc;
+
+    for (ch = 0; ch < bis->cfg.chan_cnt; ch++) {
+        rc = lc3_encode(pipeline->encoders[bis->cfg.chan_idx + ch],
+                        LC3_PCM_FORMAT_S16, pcm + bis->cfg.chan_idx + ch,
+                        pipeline->chan_cnt, pipeline->octets_per_frame,
+                        bis->sdu + ch * pipeline->octets_per_frame);
+        if (rc != 0) {
+            /* Silence instead of dropping SDU, keeps peer in sync */
+            memset(bis->sdu + ch * pipeline->octets_per_frame, 0,
+                   pipeline->octets_per_frame);
+        }
+    }
+}
+
+#if PIPELINE_WORKERS > 0
+/* BISes are statically distributed between calling thread (0) and workers */
+static void
+pipeline_encode_share(struct ble_audio_source_pipeline *pipeline,
+                      const int16_t *pcm, uint8_t share)
+{
+    uint8_t i;
+
+    for (i = share; i < pipeline->bis_cnt; i += PIPELINE_WORKERS + 1) {
+        if (pipeline->bis[i].om != NULL) {
+            pipeline_bis_encode(pipeline, &pipeline->bis[i], pcm);
+        }
+    }
+}
+
+static void *
+pipeline_worker_func(void *arg)
+{
+    struct pipeline_worker *worker = arg;
+    struct ble_audio_source_pipeline *pipeline = worker->pipeline;
+    uint32_t gen = 0;
+
+    while (1) {
+        pthread_mutex_lock(&pipeline->lock);
+        while (pipeline->job_gen == gen && !pipeline->stop) {
+            pthread_cond_wait(&pipeline->job_cond, &pipeline->lock);
+        }
+        if (pipeline->stop) {
+            pthread_mutex_unlock(&pipeline->lock);
+            break;
+        }
+        gen = pipeline->job_gen;
+        pthread_mutex_unlock(&pipeline->lock);
+
+        pipeline_encode_share(pipeline, pipeline->job_pcm, worker->idx + 1);
+
+        pthread_mutex_lock(&pipeline->lock);
+        pipeline->job_done++;
+        pthread_cond_signal(&pipeline->done_cond);
+        pthread_mutex_unlock(&pipeline->lock);
+    }
+
+    return NULL;
+}
+
+static void pipeline_workers_stop(struct ble_audio_source_pipeline *pipeline,
+                                  uint8_t cnt);
+
+static int
+pipeline_workers_start(struct ble_audio_source_pipeline *pipeline)
+{
+    uint8_t i;
+    int rc;
+
+    pthread_mutex_init(&pipeline->lock, NULL);
+    pthread_cond_init(&pipeline->job_cond, NULL);
+    pthread_cond_init(&pipeline->done_cond, NULL);
+
+    for (i = 0; i < PIPELINE_WORKERS; i++) {
+        pipeline->workers[i].pipeline = pipeline;
+        pipeline->workers[i].idx = i;
+
+        rc = pthread_create(&pipeline->workers[i].thread, NULL,
+                            pipeline_worker_func, &pipeline->workers[i]);
+        if (rc != 0) {
+            pipeline_workers_stop(pipeline, i);
+            return BLE_HS_ENOMEM;
+        }
+    }
+
+    return 0;
+}
+
+static void
+pipeline_workers_stop(struct ble_audio_source_pipeline *pipeline, uint8_t cnt)
+{
+    uint8_t i;
+
+    pthread_mutex_lock(&pipeline->lock);
+    pipeline->stop = true;
+    pthread_cond_broadcast(&pipeline->job_cond);
+    pthread_mutex_unlock(&pipeline->lock);
+
+    for (i = 0; i < cnt; i++) {
+        pthread_join(pipeline->workers[i].thread, NULL);
+    }
+
+    pthread_cond_destroy(&pipeline->done_cond);
+    pthread_cond_destroy(&pipeline->job_cond);
+    pthread_mutex_destroy(&pipeline->lock);
+}
+
+static void
+pipeline_encode(struct ble_audio_source_pipeline *pipeline,
+                const int16_t *pcm)
+{
+    pthread_mutex_lock(&pipeline->lock);
+    pipeline->job_pcm = pcm;
+    pipeline->job_done = 0;
+    pipeline->job_gen++;
+    pthread_cond_broadcast(&pipeline->job_cond);
+    pthread_mutex_unlock(&pipeline->lock);
+
+    pipeline_encode_share(pipeline, pcm, 0);
+
+    pthread_mutex_lock(&pipeline->lock);
+    while (pipeline->job_done < PIPELINE_WORKERS) {
+        pthread_cond_wait(&pipeline->done_cond, &pipeline->lock);
+    }
+    pthread_mutex_unlock(&pipeline->lock);
+}
+#else
+static void
+pipeline_encode(struct ble_audio_source_pipeline *pipeline,
+                const int16_t *pcm)
+{
+    uint8_t i;
+
+    for (i = 0; i < pipeline->bis_cnt; i++) {
+        if (pipeline->bis[i].om != NULL) {
+            pipeline_bis_encode(pipeline, &pipeline->bis[i], pcm);
+        }
+    }
+}
+#endif
+
+static void
+pipeline_frame_send(struct ble_audio_source_pipeline *pipeline,
+                    const int16_t *pcm)
+{
+    struct ble_iso_tx_data_info info = { 0 };
+    struct pipeline_bis *bis;
+    uint16_t sdu_len;
+    uint8_t i;
+    int rc;
+
+    /* Buffers are allocated here, so encoding does not touch mbuf pools */
+    for (i = 0; i < pipeline->bis_cnt; i++) {
+        bis = &pipeline->bis[i];
+        bis->om = NULL;
+
+        if (bis->conn_handle == BLE_HS_CONN_HANDLE_NONE) {
+            continue;
+        }
+
+        sdu_len = bis->cfg.chan_cnt * pipeline->octets_per_frame;
+
+        bis->om = ble_hs_mbuf_iso_pkt();
+        if (bis->om == NULL) {
+            pipeline->stats.errors++;
+            continue;
+        }
+
+        /* Codec frames are encoded directly into SDU buffer */
+        bis->sdu = os_mbuf_extend(bis->om, sdu_len);
+        if (bis->sdu == NULL) {
+            os_mbuf_free_chain(bis->om);
+            bis->om = NULL;
+            pipeline->stats.errors++;
+        }
+    }
+
+    pipeline_encode(pipeline, pcm);
+
+    /* All BISes carry the same sequence number for the same interval */
+    info.seq_num = pipeline->seq_num++;
+    info.seq_num_valid = 1;
+
+    for (i = 0; i < pipeline->bis_cnt; i++) {
+        bis = &pipeline->bis[i];
+        if (bis->om == NULL) {
+            continue;
+        }
+
+        rc = ble_iso_tx_mbuf(bis->conn_handle, bis->om, &info);
+        bis->om = NULL;
+        if (rc != 0) {
+            pipeline->stats.errors++;
+        } else {
+            pipeline->stats.sdus++;
+        }
+    }
+
+    pipeline->stats.frames++;
+}
+
+static uint16_t
+pipeline_space(struct ble_audio_source_pipeline *pipeline)
+{
+    uint16_t len;
+
+    /* Move unprocessed samples to the front, if it gives enough space */
+    if (pipeline->pcm_end + pipeline->frame_samples > PIPELINE_PCM_FRAMES &&
+        pipeline->pcm_start > 0) {
+        len = pipeline->pcm_end - pipeline->pcm_start;
+        memmove(pipeline->pcm,
+                &pipeline->pcm[pipeline->pcm_start * pipeline->chan_cnt],
+                len * pipeline->chan_cnt * sizeof(pipeline->pcm[0]));
+        pipeline->pcm_start = 0;
+        pipeline->pcm_end = len;
+    }
+
+    return PIPELINE_PCM_FRAMES - pipeline->pcm_end;
+}
+
+#if MYNEWT_VAL(BLE_AUDIO_SOURCE_PIPELINE_RESAMPLE)
+static void
+pipeline_fill_resampled(struct ble_audio_source_pipeline *pipeline,
+                        uint16_t space)
+{
+    uint16_t max_in;
+    uint16_t used;
+    SRC_DATA sd;
+    int rc;
+
+    /* Do not read more than resampler could output */
+    max_in = space / pipeline->ratio;
+    if (max_in > PIPELINE_PCM_FRAMES) {
+        max_in = PIPELINE_PCM_FRAMES;
+    }
+
+    if (pipeline->in_cnt < max_in) {
+        pipeline->in_cnt += pipeline->source->read(pipeline->source,
+                                &pipeline->in[pipeline->in_cnt *
+                                              pipeline->chan_cnt],
+                                max_in - pipeline->in_cnt);
+    }
+
+    if (pipeline->in_cnt == 0) {
+        return;
+    }
+
+    src_short_to_float_array(pipeline->in, pipeline->in_float,
+                             pipeline->in_cnt * pipeline->chan_cnt);
+
+    memset(&sd, 0, sizeof(sd));
+    sd.data_in = pipeline->in_float;
+    sd.data_out = pipeline->out_float;
+    sd.input_frames = pipeline->in_cnt;
+    sd.output_frames = space;
+    sd.src_ratio = pipeline->ratio;
+
+    rc = src_process(pipeline->resampler, &sd);
+    if (rc != 0) {
+        pipeline->in_cnt = 0;
+        return;
+    }
+
+    src_float_to_short_array(pipeline->out_float,
+                             &pipeline->pcm[pipeline->pcm_end *
+                                            pipeline->chan_cnt],
+                             sd.output_frames_gen * pipeline->chan_cnt);
+    pipeline->pcm_end += sd.output_frames_gen;
+
+    used = sd.input_frames_used;
+    memmove(pipeline->in, &pipeline->in[used * pipeline->chan_cnt],
+            (pipeline->in_cnt - used) * pipeline->chan_cnt *
+            sizeof(pipeline->in[0]));
+    pipeline->in_cnt -= used;
+}
+#endif
+
+static void
+pipeline_fill(struct ble_audio_source_pipeline *pipeline)
+{
+    uint16_t space;
+
+    space = pipeline_space(pipeline);
+    if (space == 0) {
+        return;
+    }
+
+#if MYNEWT_VAL(BLE_AUDIO_SOURCE_PIPELINE_RESAMPLE)
+    if (pipeline->resampler != NULL) {
+        pipeline_fill_resampled(pipeline, space);
+        return;
+    }
+#endif
+
+    pipeline->pcm_end += pipeline->source->read(pipeline->source,
+                            &pipeline->pcm[pipeline->pcm_end *
+                                           pipeline->chan_cnt],
+                            space);
+}
+
+int
+ble_audio_source_pipeline_process(struct ble_audio_source_pipeline *pipeline)
+{
+    int frames = 0;
+
+    pipeline_fill(pipeline);
+
+    while (pipeline->pcm_end - pipeline->pcm_start >= pipeline->frame_samples) {
+        pipeline_frame_send(pipeline,
+                            &pipeline->pcm[pipeline->pcm_start *
+                                           pipeline->chan_cnt]);
+        pipeline->pcm_start += pipeline->frame_samples;
+        frames++;
+
+        /* Source may have more samples than fit in buffer at once */
+        if (pipeline->pcm_end - pipeline->pcm_start <
+            pipeline->frame_samples) {
+            pipeline_fill(pipeline);
+        }
+    }
+
+    return frames;
+}
+
+int
+ble_audio_source_pipeline_create(
+    const struct ble_audio_source_pipeline_params *params,
+    struct ble_audio_source_pipeline **pipeline)
+{
+    struct ble_audio_source_pipeline *p;
+    uint32_t encoder_rate;
+    uint8_t i;
+    uint8_t j;
+    int rc;
+
+    if (params->source == NULL || params->source->read == NULL ||
+        params->pcm_chan_cnt == 0 ||
+        params->pcm_chan_cnt > PIPELINE_CHAN_MAX ||
+        params->bis_cnt > PIPELINE_BIS_MAX ||
+        params->octets_per_frame == 0) {
+        return BLE_HS_EINVAL;
+    }
+
+#if !MYNEWT_VAL(BLE_AUDIO_SOURCE_PIPELINE_RESAMPLE)
+    if (params->resample) {
+        return BLE_HS_ENOTSUP;
+    }
+#endif
+
+    for (i = 0; i < params->bis_cnt; i++) {
+        if (params->bis[i].chan_cnt == 0 ||
+            params->bis[i].chan_idx + params->bis[i].chan_cnt >
+            params->pcm_chan_cnt) {
+            return BLE_HS_EINVAL;
+        }
+
+        /* Each PCM channel is encoded for single BIS only */
+        for (j = 0; j < i; j++) {
+            if (params->bis[i].chan_idx <
+                params->bis[j].chan_idx + params->bis[j].chan_cnt &&
+                params->bis[j].chan_idx <
+                params->bis[i].chan_idx + params->bis[i].chan_cnt) {
+                return BLE_HS_EINVAL;
+            }
+        }
+    }
+
+    /* Resampler outputs PCM at LC3 sampling frequency */
+    encoder_rate = params->resample ? params->sample_rate :
+                                      params->pcm_sample_rate;
+
+    rc = lc3_frame_samples(params->frame_duration, encoder_rate);
+    if (rc <= 0 || rc > PIPELINE_PCM_FRAMES) {
+        return BLE_HS_EINVAL;
+    }
+
+    p = os_memblock_get(&pipeline_pool);
+    if (p == NULL) {
+        return BLE_HS_ENOMEM;
+    }
+
+    memset(p, 0, sizeof(*p));
+    p->source = params->source;
+    p->chan_cnt = params->pcm_chan_cnt;
+    p->octets_per_frame = params->octets_per_frame;
+    p->frame_samples = rc;
+    p->bis_cnt = params->bis_cnt;
+
+    for (i = 0; i < params->bis_cnt; i++) {
+        p->bis[i].cfg = params->bis[i];
+        p->bis[i].conn_handle = BLE_HS_CONN_HANDLE_NONE;
+    }
+
+    for (i = 0; i < p->chan_cnt; i++) {
+        p->encoders[i] = lc3_setup_encoder(params->frame_duration,
+                                           params->sample_rate, encoder_rate,
+                                           &p->encoder_mem[i]);
+        if (p->encoders[i] == NULL) {
+            os_memblock_put(&pipeline_pool, p);
+            return BLE_HS_EINVAL;
+        }
+    }
+
+#if MYNEWT_VAL(BLE_AUDIO_SOURCE_PIPELINE_RESAMPLE)
+    if (params->resample) {
+        p->ratio = (double)params->sample_rate / params->pcm_sample_rate;
+        p->resampler = src_new(SRC_SINC_FASTEST, p->chan_cnt, &rc);
+        if (p->resampler == NULL) {
+            os_memblock_put(&pipeline_pool, p);
+            return BLE_HS_ENOMEM;
+        }
+    }
+#endif
+
+#if PIPELINE_WORKERS > 0
+    rc = pipeline_workers_start(p);
+    if (rc != 0) {
+#if MYNEWT_VAL(BLE_AUDIO_SOURCE_PIPELINE_RESAMPLE)
+        if (p->resampler != NULL) {
+            src_delete(p->resampler);
+        }
+#endif
+        os_memblock_put(&pipeline_pool, p);
+        return rc;
+    }
+#endif
+
+    *pipeline = p;
+
+    return 0;
+}
+
+void
+ble_audio_source_pipeline_destroy(struct ble_audio_source_pipeline *pipeline)
+{
+#if PIPELINE_WORKERS > 0
+    pipeline_workers_stop(pipeline, PIPELINE_WORKERS);
+#endif
+
+#if MYNEWT_VAL(BLE_AUDIO_SOURCE_PIPELINE_RESAMPLE)
+    if (pipeline->resampler != NULL) {
+        src_delete(pipeline->resampler);
+    }
+#endif
+
+    os_memblock_put(&pipeline_pool, pipeline);
+}
+
+int
+ble_audio_source_pipeline_bis_handle_set(
+    struct ble_audio_source_pipeline *pipeline, uint8_t bis_idx,
+    uint16_t conn_handle)
+{
+    if (bis_idx >= pipeline->bis_cnt) {
+        return BLE_HS_EINVAL;
+    }
+
+    pipeline->bis[bis_idx].conn_handle = conn_handle;
+
+    return 0;
+}
+
+int
+ble_audio_source_pipeline_resample_ratio_set(
+    struct ble_audio_source_pipeline *pipeline, double ratio)
+{
+#if MYNEWT_VAL(BLE_AUDIO_SOURCE_PIPELINE_RESAMPLE)
+    if (pipeline->resampler != NULL) {
+        pipeline->ratio = ratio;
+        return 0;
+    }
+#endif
+
+    return BLE_HS_ENOTSUP;
+}
+
+void
+ble_audio_source_pipeline_stats_get(
+    struct ble_audio_source_pipeline *pipeline,
+    struct ble_audio_source_pipeline_stats *stats)
+{
+    *stats = pipeline->stats;
+}
+
+int
+ble_audio_source_pipeline_init(void)
+{
+    int rc;
+
+    /* Ensure this function only gets called by sysinit. */
+    SYSINIT_ASSERT_ACTIVE();
+
+    rc = os_mempool_init(&pipeline_pool,
+                         MYNEWT_VAL(BLE_AUDIO_SOURCE_PIPELINE_MAX),
+                         sizeof(struct ble_audio_source_pipeline),
+                         pipeline_mem, "ble_audio_source_pipeline_pool");
+    SYSINIT_PANIC_ASSERT(rc == 0);
+
+    return 0;
+}
+#endif /* BLE_AUDIO_SOURCE_PIPELINE */
@@ -17,16 +17,27 @@
  * under the License.
  */
 
+#include "syscfg/syscfg.h"
 #include "sysinit/sysinit.h"
 #include "testutil/testutil.h"
 
 TEST_SUITE_DECL(ble_audio_base_parse_test_suite);
+TEST_SUITE_DECL(ble_audio_base_build_test_suite);
 TEST_CASE_DECL(ble_audio_listener_register_test);
+TEST_CASE_DECL(ble_audio_broadcast_source_test_malformed_ltv);
+#if MYNEWT_VAL(BLE_AUDIO_TEST_LC3_BENCH)
+TEST_CASE_DECL(ble_audio_lc3_bench_test);
+#endif
 
 TEST_SUITE(ble_audio_test)
 {
     ble_audio_base_parse_test_suite();
+    ble_audio_base_build_test_suite();
     ble_audio_listener_register_test();
+    ble_audio_broadcast_source_test_malformed_ltv();
+#if MYNEWT_VAL(BLE_AUDIO_TEST_LC3_BENCH)
+    ble_audio_lc3_bench_test();
+#endif
 }
 
 int
@@ -0,0 +1,367 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#include <string.h>
+
+#include "testutil/testutil.h"
+
+#include "host/ble_hs.h"
+#include "audio/ble_audio.h"
+
+#define STRESS_BROADCASTS           8
+#define STRESS_SUBGROUPS            3
+#define STRESS_BISES                2
+#define STRESS_UPDATES              4000
+#define STRESS_BASE_SIZE            200
+#define STRESS_METADATA_MAX         32
+
+struct stress_broadcast {
+    struct ble_audio_base base;
+    struct ble_audio_big_subgroup subs[STRESS_SUBGROUPS];
+    struct ble_audio_bis bises[STRESS_SUBGROUPS][STRESS_BISES];
+    uint8_t metadata[STRESS_SUBGROUPS][2][STRESS_METADATA_MAX];
+    uint8_t data[STRESS_BASE_SIZE];
+    uint8_t data_len;
+};
+
+static struct stress_broadcast stress_broadcasts[STRESS_BROADCASTS];
+
+/* 48 kHz, 10 ms, 100 octets */
+static uint8_t stress_sub_codec_config[] = {
+    0x02, 0x01, 0x08,
+    0x02, 0x02, 0x02,
+    0x03, 0x04, 0x64, 0x00,
+};
+
+/* Audio_Channel_Allocation: FL, FR */
+static uint8_t stress_bis_codec_config[STRESS_BISES][6] = {
+    { 0x05, 0x03, 0x01, 0x00, 0x00, 0x00 },
+    { 0x05, 0x03, 0x02, 0x00, 0x00, 0x00 },
+};
+
+static const char *stress_languages[] = {
+    "eng", "spa", "fra", "deu", "ita", "pol", "jpn", "zho",
+};
+
+static uint32_t stress_seed;
+
+static uint32_t
+stress_rand(void)
+{
+    /* xorshift32, deterministic so that failures are reproducible */
+    stress_seed ^= stress_seed << 13;
+    stress_seed ^= stress_seed >> 17;
+    stress_seed ^= stress_seed << 5;
+
+    return stress_seed;
+}
+
+static uint8_t
+stress_metadata_gen(uint8_t *md)
+{
+    const char *lang;
+    uint8_t len = 0;
+    uint8_t info_len;
+    uint8_t i;
+
+    if (stress_rand() & 1) {
+        /* Streaming_Audio_Contexts */
+        md[len++] = 0x03;
+        md[len++] = 0x02;
+        put_le16(&md[len], 1 << (stress_rand() % 12));
+        len += 2;
+    }
+
+    if (stress_rand() & 1) {
+        /* Language */
+        lang = stress_languages[stress_rand() % 8];
+        md[len++] = 0x04;
+        md[len++] = 0x04;
+        memcpy(&md[len], lang, 3);
+        len += 3;
+    }
+
+    if (stress_rand() & 1) {
+        /* Parental_Rating */
+        md[len++] = 0x02;
+        md[len++] = 0x06;
+        md[len++] = stress_rand() % 16;
+    }
+
+    if (stress_rand() & 1) {
+        /* Program_Info */
+        info_len = stress_rand() % 14;
+        md[len++] = info_len + 1;
+        md[len++] = 0x03;
+        for (i = 0; i < info_len; i++) {
+            md[len++] = 'a' + stress_rand() % 26;
+        }
+    }
+
+    return len;
+}
+
+static void
+stress_broadcast_init(struct stress_broadcast *b)
+{
+    struct ble_audio_big_subgroup *sub;
+    struct ble_audio_bis *bis;
+    uint8_t bis_idx = 0;
+    uint8_t i;
+    uint8_t j;
+    int rc;
+
+    memset(b, 0, sizeof(*b));
+    b->base.presentation_delay = 40000;
+    STAILQ_INIT(&b->base.subs);
+
+    for (i = 0; i < STRESS_SUBGROUPS; i++) {
+        sub = &b->subs[i];
+        sub->codec_id.format = BLE_AUDIO_CODEC_FORMAT_LC3;
+        sub->codec_spec_config = stress_sub_codec_config;
+        sub->codec_spec_config_len = sizeof(stress_sub_codec_config);
+        sub->metadata = b->metadata[i][0];
+        sub->metadata_len = stress_metadata_gen(sub->metadata);
+        STAILQ_INIT(&sub->bises);
+
+        for (j = 0; j < STRESS_BISES; j++) {
+            bis = &b->bises[i][j];
+            bis->idx = ++bis_idx;
+            bis->codec_spec_config = stress_bis_codec_config[j];
+            bis->codec_spec_config_len = sizeof(stress_bis_codec_config[j]);
+            STAILQ_INSERT_TAIL(&sub->bises, bis, next);
+            sub->bis_cnt++;
+        }
+
+        STAILQ_INSERT_TAIL(&b->base.subs, sub, next);
+        b->base.num_subgroups++;
+    }
+
+    rc = ble_audio_base_build(&b->base, b->data, sizeof(b->data),
+                              &b->data_len);
+    TEST_ASSERT_FATAL(rc == 0);
+}
+
+static void
+stress_broadcast_check(struct stress_broadcast *b)
+{
+    struct ble_audio_base_subgroup subgroup;
+    struct ble_audio_base_group group;
+    struct ble_audio_base_bis bis;
+    struct ble_audio_base_iter subgroup_iter;
+    struct ble_audio_base_iter bis_iter;
+    uint8_t ref[STRESS_BASE_SIZE];
+    uint8_t ref_len;
+    uint8_t i;
+    uint8_t j;
+    int rc;
+
+    /* Incrementally updated BASE shall match BASE built from scratch */
+    rc = ble_audio_base_build(&b->base, ref, sizeof(ref), &ref_len);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT_FATAL(ref_len == b->data_len);
+    TEST_ASSERT_FATAL(memcmp(ref, b->data, ref_len) == 0);
+
+    rc = ble_audio_base_parse(b->data, b->data_len, &group, &subgroup_iter);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT_FATAL(group.presentation_delay == 40000);
+    TEST_ASSERT_FATAL(group.num_subgroups == STRESS_SUBGROUPS);
+
+    for (i = 0; i < STRESS_SUBGROUPS; i++) {
+        rc = ble_audio_base_subgroup_iter(&subgroup_iter, &subgroup,
+                                          &bis_iter);
+        TEST_ASSERT_FATAL(rc == 0);
+        TEST_ASSERT_FATAL(subgroup.num_bis == STRESS_BISES);
+        TEST_ASSERT_FATAL(subgroup.codec_id.format ==
+                          BLE_AUDIO_CODEC_FORMAT_LC3);
+        TEST_ASSERT_FATAL(subgroup.metadata_len == b->subs[i].metadata_len);
+        TEST_ASSERT_FATAL(subgroup.metadata_len == 0 ||
+                          memcmp(subgroup.metadata, b->subs[i].metadata,
+                                 subgroup.metadata_len) == 0);
+
+        for (j = 0; j < STRESS_BISES; j++) {
+            rc = ble_audio_base_bis_iter(&bis_iter, &bis);
+            TEST_ASSERT_FATAL(rc == 0);
+            TEST_ASSERT_FATAL(bis.index == b->bises[i][j].idx);
+        }
+    }
+}
+
+TEST_CASE_SELF(ble_audio_base_build_test)
+{
+    static const uint8_t expected[] = {
+        0x40, 0x9c, 0x00, /* Presentation_Delay: 40 ms */
+        0x01, /* Num_Subgroups */
+        0x01, /* Num_BIS[0] */
+        0x06, 0x00, 0x00, 0x00, 0x00, /* Codec_ID[0]: LC3 */
+        0x0a, /* Codec_Specific_Configuration_Length[0] */
+        0x02, 0x01, 0x08,
+        0x02, 0x02, 0x02,
+        0x03, 0x04, 0x64, 0x00,
+        0x05, /* Metadata_Length[0] */
+        0x04, 0x04, 0x65, 0x6e, 0x67, /* Language: English */
+        0x01, /* BIS_index[0[0]] */
+        0x06, /* Codec_Specific_Configuration_Length[0[0]] */
+        0x05, 0x03, 0x01, 0x00, 0x00, 0x00,
+    };
+    uint8_t metadata[] = { 0x04, 0x04, 0x65, 0x6e, 0x67 };
+    uint8_t metadata_spa[] = { 0x04, 0x04, 0x73, 0x70, 0x61 };
+    struct ble_audio_big_subgroup sub = {
+        .bis_cnt = 1,
+        .codec_id.format = BLE_AUDIO_CODEC_FORMAT_LC3,
+        .codec_spec_config = stress_sub_codec_config,
+        .codec_spec_config_len = sizeof(stress_sub_codec_config),
+        .metadata = metadata,
+        .metadata_len = sizeof(metadata),
+    };
+    struct ble_audio_bis bis = {
+        .idx = 1,
+        .codec_spec_config = stress_bis_codec_config[0],
+        .codec_spec_config_len = sizeof(stress_bis_codec_config[0]),
+    };
+    struct ble_audio_base base = {
+        .presentation_delay = 40000,
+        .num_subgroups = 1,
+    };
+    uint8_t data[sizeof(expected)];
+    uint8_t len;
+    int rc;
+
+    STAILQ_INIT(&base.subs);
+    STAILQ_INIT(&sub.bises);
+    STAILQ_INSERT_TAIL(&sub.bises, &bis, next);
+    STAILQ_INSERT_TAIL(&base.subs, &sub, next);
+
+    rc = ble_audio_base_build(&base, data, sizeof(data), &len);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(len == sizeof(expected));
+    TEST_ASSERT(memcmp(data, expected, len) == 0);
+
+    rc = ble_audio_base_build(&base, data, sizeof(data) - 1, &len);
+    TEST_ASSERT(rc == BLE_HS_EMSGSIZE);
+
+    rc = ble_audio_base_build(&base, data, sizeof(data), &len);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    /* Same Metadata */
+    rc = ble_audio_base_metadata_set(data, &len, sizeof(data), 0, metadata,
+                                     sizeof(metadata));
+    TEST_ASSERT(rc == BLE_HS_EALREADY);
+
+    /* No such subgroup */
+    rc = ble_audio_base_metadata_set(data, &len, sizeof(data), 1, metadata,
+                                     sizeof(metadata));
+    TEST_ASSERT(rc == BLE_HS_ENOENT);
+
+    /* Longer Metadata does not fit */
+    rc = ble_audio_base_metadata_set(data, &len, sizeof(data), 0, expected,
+                                     sizeof(metadata) + 1);
+    TEST_ASSERT(rc == BLE_HS_EMSGSIZE);
+    TEST_ASSERT(len == sizeof(expected));
+    TEST_ASSERT(memcmp(data, expected, len) == 0);
+
+    /* Same length, different Language */
+    rc = ble_audio_base_metadata_set(data, &len, sizeof(data), 0,
+                                     metadata_spa, sizeof(metadata_spa));
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(len == sizeof(expected));
+    TEST_ASSERT(memcmp(&data[22], metadata_spa, sizeof(metadata_spa)) == 0);
+    TEST_ASSERT(memcmp(&data[27], &expected[27], sizeof(expected) - 27) == 0);
+
+    /* Metadata removed, BIS moved */
+    rc = ble_audio_base_metadata_set(data, &len, sizeof(data), 0, NULL, 0);
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(len == sizeof(expected) - sizeof(metadata));
+    TEST_ASSERT(data[21] == 0);
+    TEST_ASSERT(memcmp(&data[22], &expected[27], sizeof(expected) - 27) == 0);
+
+    /* Metadata restored */
+    rc = ble_audio_base_metadata_set(data, &len, sizeof(data), 0, metadata,
+                                     sizeof(metadata));
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(len == sizeof(expected));
+    TEST_ASSERT(memcmp(data, expected, len) == 0);
+}
+
+TEST_CASE_SELF(ble_audio_base_metadata_stress_test)
+{
+    struct ble_audio_big_subgroup *sub;
+    struct stress_broadcast *b;
+    uint8_t *md;
+    uint8_t md_len;
+    uint32_t unchanged = 0;
+    uint32_t resized = 0;
+    uint8_t sub_idx;
+    uint8_t cur;
+    int rc;
+    int i;
+
+    stress_seed = 0x2545f491;
+
+    for (i = 0; i < STRESS_BROADCASTS; i++) {
+        stress_broadcast_init(&stress_broadcasts[i]);
+        stress_broadcast_check(&stress_broadcasts[i]);
+    }
+
+    for (i = 0; i < STRESS_UPDATES; i++) {
+        b = &stress_broadcasts[stress_rand() % STRESS_BROADCASTS];
+        sub_idx = stress_rand() % STRESS_SUBGROUPS;
+        sub = &b->subs[sub_idx];
+
+        /* Subgroup Metadata alternates between two buffers */
+        cur = sub->metadata == b->metadata[sub_idx][0] ? 0 : 1;
+        md = b->metadata[sub_idx][!cur];
+
+        if (stress_rand() % 8 == 0) {
+            memcpy(md, sub->metadata, sub->metadata_len);
+            md_len = sub->metadata_len;
+        } else {
+            md_len = stress_metadata_gen(md);
+        }
+
+        rc = ble_audio_base_metadata_set(b->data, &b->data_len,
+                                         sizeof(b->data), sub_idx, md,
+                                         md_len);
+        if (md_len == sub->metadata_len &&
+            memcmp(md, sub->metadata, md_len) == 0) {
+            TEST_ASSERT_FATAL(rc == BLE_HS_EALREADY);
+            unchanged++;
+        } else {
+            TEST_ASSERT_FATAL(rc == 0);
+            if (md_len != sub->metadata_len) {
+                resized++;
+            }
+        }
+
+        sub->metadata = md;
+        sub->metadata_len = md_len;
+
+        stress_broadcast_check(b);
+    }
+
+    TEST_ASSERT(unchanged > 0);
+    TEST_ASSERT(resized > 0);
+}
+
+TEST_SUITE(ble_audio_base_build_test_suite)
+{
+    ble_audio_base_build_test();
+    ble_audio_base_metadata_stress_test();
+}
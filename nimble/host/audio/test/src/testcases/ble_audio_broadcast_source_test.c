@@ -0,0 +1,93 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#include <string.h>
+
+#include "testutil/testutil.h"
+
+#include "host/ble_hs.h"
+#include "audio/ble_audio.h"
+#include "audio/ble_audio_broadcast_source.h"
+
+static struct ble_audio_base base;
+static struct ble_audio_big_subgroup subgroup;
+static struct ble_audio_bis bis;
+
+static void
+broadcast_source_base_init(void)
+{
+    memset(&base, 0, sizeof(base));
+    memset(&subgroup, 0, sizeof(subgroup));
+    memset(&bis, 0, sizeof(bis));
+
+    STAILQ_INIT(&base.subs);
+    STAILQ_INIT(&subgroup.bises);
+
+    bis.idx = 1;
+    STAILQ_INSERT_TAIL(&subgroup.bises, &bis, next);
+    subgroup.bis_cnt = 1;
+
+    STAILQ_INSERT_TAIL(&base.subs, &subgroup, next);
+    base.num_subgroups = 1;
+}
+
+static int
+broadcast_source_create(void)
+{
+    struct ble_broadcast_create_params params = {
+        .base = &base,
+        .adv_instance = 0,
+    };
+
+    return ble_audio_broadcast_create(&params, NULL, NULL, NULL);
+}
+
+TEST_CASE_SELF(ble_audio_broadcast_source_test_malformed_ltv)
+{
+    /* Length 0xff would wrap 8-bit sum of lengths back to start */
+    uint8_t ltv_wrap[] = { 0xff, 0x01 };
+    /* Second LTV runs past end of data */
+    uint8_t ltv_overrun[] = { 0x01, 0x01, 0x03, 0x02, 0x00 };
+    int rc;
+
+    broadcast_source_base_init();
+    subgroup.metadata = ltv_wrap;
+    subgroup.metadata_len = sizeof(ltv_wrap);
+    rc = broadcast_source_create();
+    TEST_ASSERT(rc == BLE_HS_EINVAL);
+
+    broadcast_source_base_init();
+    subgroup.metadata = ltv_overrun;
+    subgroup.metadata_len = sizeof(ltv_overrun);
+    rc = broadcast_source_create();
+    TEST_ASSERT(rc == BLE_HS_EINVAL);
+
+    broadcast_source_base_init();
+    subgroup.codec_spec_config = ltv_wrap;
+    subgroup.codec_spec_config_len = sizeof(ltv_wrap);
+    rc = broadcast_source_create();
+    TEST_ASSERT(rc == BLE_HS_EINVAL);
+
+    broadcast_source_base_init();
+    bis.codec_spec_config = ltv_overrun;
+    bis.codec_spec_config_len = sizeof(ltv_overrun);
+    rc = broadcast_source_create();
+    TEST_ASSERT(rc == BLE_HS_EINVAL);
+}
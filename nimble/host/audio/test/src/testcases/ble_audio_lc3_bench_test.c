@@ -0,0 +1,432 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * LC3 benchmark and regression suite. Each BAP preset configuration
+ * supported by PACS LC3 (all presets if PACS LC3 is not included) encodes
+ * and decodes generated reference PCM. Reported are encode, decode and
+ * packet loss concealment cost in microseconds per frame and real-time
+ * factor (processing time of encode and decode over audio duration).
+ *
+ * Regression checks:
+ * - encoder and decoder are deterministic, i.e. fresh instances produce
+ *   identical output,
+ * - decoded audio matches reference PCM with SNR above threshold, which
+ *   catches integration errors like wrong stride, frame size or delay,
+ * - bitstream and decoded PCM hashes are bit-exact with vectors stored in
+ *   BLE_AUDIO_TEST_LC3_BENCH_VECTORS file, if set. Vectors are written
+ *   instead of checked if BLE_AUDIO_TEST_LC3_BENCH_RECORD is enabled.
+ *   Since liblc3 is built with -ffast-math, vectors are specific to
+ *   toolchain and host, record them on the machine running the checks.
+ */
+
+#include "syscfg/syscfg.h"
+
+#if MYNEWT_VAL(BLE_AUDIO_TEST_LC3_BENCH)
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <math.h>
+#include <time.h>
+#include <lc3.h>
+#include "testutil/testutil.h"
+#include "audio/ble_audio.h"
+
+#define BENCH_DURATION_US       1000000
+#define BENCH_SNR_MIN_DB        10.0
+#define BENCH_SAMPLES_MAX       (BENCH_DURATION_US / 1000 * 48)
+#define BENCH_BYTES_MAX         (BENCH_DURATION_US / 7500 * 155)
+
+#ifndef M_PI
+#define M_PI                    3.14159265358979323846
+#endif
+
+struct bench_cfg {
+    const char *name;
+    uint32_t sample_rate;
+    uint64_t sample_rate_bit;
+    uint16_t frame_duration;
+    uint16_t octets;
+};
+
+struct bench_result {
+    uint32_t frames;
+    uint64_t enc_ns;
+    uint64_t dec_ns;
+    uint64_t plc_ns;
+    uint32_t enc_hash;
+    uint32_t dec_hash;
+    double snr;
+};
+
+/* BAP presets, Table 5.2 of Basic Audio Profile. 44.1 kHz presets are not
+ * included as liblc3 does not accept 44.1 kHz sampling rate.
+ */
+static const struct bench_cfg bench_cfgs[] = {
+    { "8_1", 8000, BLE_AUDIO_CODEC_SUPPORTED_SAMPLING_RATE_8000_HZ, 7500, 26 },
+    { "8_2", 8000, BLE_AUDIO_CODEC_SUPPORTED_SAMPLING_RATE_8000_HZ, 10000, 30 },
+    { "16_1", 16000, BLE_AUDIO_CODEC_SUPPORTED_SAMPLING_RATE_16000_HZ, 7500, 30 },
+    { "16_2", 16000, BLE_AUDIO_CODEC_SUPPORTED_SAMPLING_RATE_16000_HZ, 10000, 40 },
+    { "24_1", 24000, BLE_AUDIO_CODEC_SUPPORTED_SAMPLING_RATE_24000_HZ, 7500, 45 },
+    { "24_2", 24000, BLE_AUDIO_CODEC_SUPPORTED_SAMPLING_RATE_24000_HZ, 10000, 60 },
+    { "32_1", 32000, BLE_AUDIO_CODEC_SUPPORTED_SAMPLING_RATE_32000_HZ, 7500, 60 },
+    { "32_2", 32000, BLE_AUDIO_CODEC_SUPPORTED_SAMPLING_RATE_32000_HZ, 10000, 80 },
+    { "48_1", 48000, BLE_AUDIO_CODEC_SUPPORTED_SAMPLING_RATE_48000_HZ, 7500, 75 },
+    { "48_2", 48000, BLE_AUDIO_CODEC_SUPPORTED_SAMPLING_RATE_48000_HZ, 10000, 100 },
+    { "48_3", 48000, BLE_AUDIO_CODEC_SUPPORTED_SAMPLING_RATE_48000_HZ, 7500, 90 },
+    { "48_4", 48000, BLE_AUDIO_CODEC_SUPPORTED_SAMPLING_RATE_48000_HZ, 10000, 120 },
+    { "48_5", 48000, BLE_AUDIO_CODEC_SUPPORTED_SAMPLING_RATE_48000_HZ, 7500, 117 },
+    { "48_6", 48000, BLE_AUDIO_CODEC_SUPPORTED_SAMPLING_RATE_48000_HZ, 10000, 155 },
+};
+
+#define BENCH_CFG_CNT   (sizeof(bench_cfgs) / sizeof(bench_cfgs[0]))
+
+static int16_t bench_pcm[BENCH_SAMPLES_MAX];
+static int16_t bench_out[BENCH_SAMPLES_MAX];
+static uint8_t bench_bytes[BENCH_BYTES_MAX];
+static uint8_t bench_bytes2[BENCH_BYTES_MAX];
+static lc3_encoder_mem_48k_t bench_enc_mem;
+static lc3_decoder_mem_48k_t bench_dec_mem;
+
+static uint64_t
+bench_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* FNV-1a */
+static uint32_t
+bench_hash(const void *data, size_t len)
+{
+    const uint8_t *p = data;
+    uint32_t h = 2166136261;
+
+    while (len--) {
+        h = (h ^ *p++) * 16777619;
+    }
+
+    return h;
+}
+
+#if defined(MYNEWT_VAL_BLE_SVC_AUDIO_PACS_LC3_SRC_SAMPLING_FREQUENCIES)
+static bool
+bench_caps_match(const struct bench_cfg *cfg, uint64_t freqs, uint16_t durs,
+                 uint16_t min_octets, uint16_t max_octets)
+{
+    uint16_t dur_bit;
+
+    dur_bit = cfg->frame_duration == 7500 ?
+              BLE_AUDIO_CODEC_SUPPORTED_FRAME_DURATION_7_5_MS :
+              BLE_AUDIO_CODEC_SUPPORTED_FRAME_DURATION_10_MS;
+
+    return (freqs & cfg->sample_rate_bit) && (durs & dur_bit) &&
+           cfg->octets >= min_octets && cfg->octets <= max_octets;
+}
+#endif
+
+static bool
+bench_cfg_supported(const struct bench_cfg *cfg)
+{
+#if defined(MYNEWT_VAL_BLE_SVC_AUDIO_PACS_LC3_SRC_SAMPLING_FREQUENCIES)
+    return bench_caps_match(cfg,
+               MYNEWT_VAL(BLE_SVC_AUDIO_PACS_LC3_SRC_SAMPLING_FREQUENCIES),
+               MYNEWT_VAL(BLE_SVC_AUDIO_PACS_LC3_SRC_FRAME_DURATIONS),
+               MYNEWT_VAL(BLE_SVC_AUDIO_PACS_LC3_SRC_MIN_OCTETS_PER_CODEC_FRAME),
+               MYNEWT_VAL(BLE_SVC_AUDIO_PACS_LC3_SRC_MAX_OCTETS_PER_CODEC_FRAME)) ||
+           bench_caps_match(cfg,
+               MYNEWT_VAL(BLE_SVC_AUDIO_PACS_LC3_SNK_SAMPLING_FREQUENCIES),
+               MYNEWT_VAL(BLE_SVC_AUDIO_PACS_LC3_SNK_FRAME_DURATIONS),
+               MYNEWT_VAL(BLE_SVC_AUDIO_PACS_LC3_SNK_MIN_OCTETS_PER_CODEC_FRAME),
+               MYNEWT_VAL(BLE_SVC_AUDIO_PACS_LC3_SNK_MAX_OCTETS_PER_CODEC_FRAME));
+#else
+    return true;
+#endif
+}
+
+/*
+ * Reference PCM: two tones with slowly changing level and some noise, so
+ * both tonal and noise coding paths are exercised.
+ */
+static void
+bench_pcm_generate(uint32_t sample_rate, uint32_t samples)
+{
+    uint32_t seed = 0x1234567;
+    double t;
+    double v;
+    uint32_t i;
+
+    for (i = 0; i < samples; i++) {
+        t = (double)i / sample_rate;
+        seed = seed * 1103515245 + 12345;
+
+        v = 8000 * sin(2 * M_PI * 440 * t) * (0.6 + 0.4 * sin(2 * M_PI * t)) +
+            3000 * sin(2 * M_PI * 1750 * t) +
+            (int16_t)(seed >> 16) / 64;
+
+        bench_pcm[i] = v;
+    }
+}
+
+static void
+bench_encode(const struct bench_cfg *cfg, uint16_t frame_samples,
+             uint8_t *bytes, struct bench_result *res)
+{
+    lc3_encoder_t enc;
+    uint64_t start;
+    uint32_t i;
+    int rc;
+
+    enc = lc3_setup_encoder(cfg->frame_duration, cfg->sample_rate, 0,
+                            &bench_enc_mem);
+    TEST_ASSERT_FATAL(enc != NULL);
+
+    start = bench_ns();
+    for (i = 0; i < res->frames; i++) {
+        rc = lc3_encode(enc, LC3_PCM_FORMAT_S16,
+                        &bench_pcm[i * frame_samples], 1, cfg->octets,
+                        &bytes[i * cfg->octets]);
+        TEST_ASSERT_FATAL(rc == 0);
+    }
+    res->enc_ns = bench_ns() - start;
+}
+
+static void
+bench_decode(const struct bench_cfg *cfg, uint16_t frame_samples,
+             struct bench_result *res)
+{
+    lc3_decoder_t dec;
+    uint64_t start;
+    uint32_t i;
+    int rc;
+
+    dec = lc3_setup_decoder(cfg->frame_duration, cfg->sample_rate, 0,
+                            &bench_dec_mem);
+    TEST_ASSERT_FATAL(dec != NULL);
+
+    start = bench_ns();
+    for (i = 0; i < res->frames; i++) {
+        rc = lc3_decode(dec, &bench_bytes[i * cfg->octets], cfg->octets,
+                        LC3_PCM_FORMAT_S16, &bench_out[i * frame_samples], 1);
+        TEST_ASSERT_FATAL(rc == 0);
+    }
+    res->dec_ns = bench_ns() - start;
+}
+
+static void
+bench_plc(const struct bench_cfg *cfg, uint16_t frame_samples,
+          struct bench_result *res)
+{
+    static int16_t pcm[480];
+    lc3_decoder_t dec;
+    uint64_t start;
+    uint32_t i;
+    int rc;
+
+    dec = lc3_setup_decoder(cfg->frame_duration, cfg->sample_rate, 0,
+                            &bench_dec_mem);
+    TEST_ASSERT_FATAL(dec != NULL);
+
+    /* Conceal every other frame, PLC works from previously decoded one */
+    start = 0;
+    for (i = 0; i < res->frames; i++) {
+        if (i & 1) {
+            start -= bench_ns();
+            rc = lc3_decode(dec, NULL, 0, LC3_PCM_FORMAT_S16, pcm, 1);
+            start += bench_ns();
+            TEST_ASSERT_FATAL(rc == 1);
+        } else {
+            rc = lc3_decode(dec, &bench_bytes[i * cfg->octets], cfg->octets,
+                            LC3_PCM_FORMAT_S16, pcm, 1);
+            TEST_ASSERT_FATAL(rc == 0);
+        }
+    }
+    res->plc_ns = start;
+}
+
+static double
+bench_snr(uint32_t samples, int delay)
+{
+    double signal = 0;
+    double noise = 0;
+    double d;
+    uint32_t i;
+
+    for (i = delay; i < samples; i++) {
+        signal += (double)bench_pcm[i - delay] * bench_pcm[i - delay];
+        d = (double)bench_out[i] - bench_pcm[i - delay];
+        noise += d * d;
+    }
+
+    if (noise == 0) {
+        return INFINITY;
+    }
+
+    return 10 * log10(signal / noise);
+}
+
+static void
+bench_run(const struct bench_cfg *cfg, struct bench_result *res)
+{
+    uint16_t frame_samples;
+    uint32_t samples;
+    int rc;
+
+    rc = lc3_frame_samples(cfg->frame_duration, cfg->sample_rate);
+    TEST_ASSERT_FATAL(rc > 0);
+    frame_samples = rc;
+
+    memset(res, 0, sizeof(*res));
+    res->frames = BENCH_DURATION_US / cfg->frame_duration;
+    samples = res->frames * frame_samples;
+    TEST_ASSERT_FATAL(samples <= BENCH_SAMPLES_MAX);
+    TEST_ASSERT_FATAL(res->frames * cfg->octets <= BENCH_BYTES_MAX);
+
+    bench_pcm_generate(cfg->sample_rate, samples);
+
+    bench_encode(cfg, frame_samples, bench_bytes, res);
+    bench_decode(cfg, frame_samples, res);
+    bench_plc(cfg, frame_samples, res);
+
+    res->enc_hash = bench_hash(bench_bytes, res->frames * cfg->octets);
+    res->dec_hash = bench_hash(bench_out, samples * sizeof(bench_out[0]));
+    res->snr = bench_snr(samples, lc3_delay_samples(cfg->frame_duration,
+                                                     cfg->sample_rate));
+
+    /* Fresh encoder shall produce the same bitstream */
+    bench_encode(cfg, frame_samples, bench_bytes2, res);
+    TEST_ASSERT(memcmp(bench_bytes, bench_bytes2,
+                       res->frames * cfg->octets) == 0);
+
+    /* ...and fresh decoder the same PCM */
+    bench_decode(cfg, frame_samples, res);
+    TEST_ASSERT(bench_hash(bench_out, samples * sizeof(bench_out[0])) ==
+                res->dec_hash);
+}
+
+static void
+bench_vectors_check(const struct bench_result *results, bool *run)
+{
+    const char *path = MYNEWT_VAL(BLE_AUDIO_TEST_LC3_BENCH_VECTORS);
+#if !MYNEWT_VAL(BLE_AUDIO_TEST_LC3_BENCH_RECORD)
+    uint32_t enc_hash;
+    uint32_t dec_hash;
+    char name[16];
+#endif
+    FILE *f;
+    unsigned int i;
+
+    if (path[0] == '\0') {
+        printf("  no vectors file, bit-exactness not checked\n");
+        return;
+    }
+
+#if MYNEWT_VAL(BLE_AUDIO_TEST_LC3_BENCH_RECORD)
+    f = fopen(path, "w");
+    TEST_ASSERT_FATAL(f != NULL);
+
+    for (i = 0; i < BENCH_CFG_CNT; i++) {
+        if (run[i]) {
+            fprintf(f, "%s %08" PRIx32 " %08" PRIx32 "\n", bench_cfgs[i].name,
+                    results[i].enc_hash, results[i].dec_hash);
+        }
+    }
+
+    fclose(f);
+    printf("  vectors recorded to %s\n", path);
+#else
+    f = fopen(path, "r");
+    TEST_ASSERT_FATAL(f != NULL);
+
+    while (fscanf(f, "%15s %" SCNx32 " %" SCNx32, name, &enc_hash,
+                  &dec_hash) == 3) {
+        for (i = 0; i < BENCH_CFG_CNT; i++) {
+            if (!run[i] || strcmp(name, bench_cfgs[i].name) != 0) {
+                continue;
+            }
+
+            if (results[i].enc_hash != enc_hash ||
+                results[i].dec_hash != dec_hash) {
+                printf("  %s: mismatch, bitstream %08" PRIx32 " (expected "
+                       "%08" PRIx32 ") pcm %08" PRIx32 " (expected %08"
+                       PRIx32 ")\n", name, results[i].enc_hash, enc_hash,
+                       results[i].dec_hash, dec_hash);
+                TEST_ASSERT(0);
+            }
+
+            /* Each configuration shall have its vector checked once */
+            run[i] = false;
+        }
+    }
+
+    fclose(f);
+
+    for (i = 0; i < BENCH_CFG_CNT; i++) {
+        if (run[i]) {
+            printf("  %s: no vector in %s\n", bench_cfgs[i].name, path);
+            TEST_ASSERT(0);
+        }
+    }
+#endif
+}
+
+TEST_CASE_SELF(ble_audio_lc3_bench_test)
+{
+    static struct bench_result results[BENCH_CFG_CNT];
+    bool run[BENCH_CFG_CNT];
+    const struct bench_cfg *cfg;
+    struct bench_result *res;
+    double rtf;
+    unsigned int i;
+
+    printf("ble_audio_lc3_bench: %d ms of audio per config, us/frame\n",
+           BENCH_DURATION_US / 1000);
+    printf("  %-6s %7s %5s %8s %8s %8s %7s %6s\n", "preset", "rate",
+           "dur", "encode", "decode", "plc", "rtf", "snr");
+
+    for (i = 0; i < BENCH_CFG_CNT; i++) {
+        cfg = &bench_cfgs[i];
+        res = &results[i];
+
+        run[i] = bench_cfg_supported(cfg);
+        if (!run[i]) {
+            continue;
+        }
+
+        bench_run(cfg, res);
+
+        rtf = (double)(res->enc_ns + res->dec_ns) /
+              ((uint64_t)res->frames * cfg->frame_duration * 1000);
+
+        printf("  %-6s %7" PRIu32 " %5u %8.1f %8.1f %8.1f %7.4f %6.1f\n",
+               cfg->name, cfg->sample_rate, cfg->frame_duration,
+               res->enc_ns / 1000.0 / res->frames,
+               res->dec_ns / 1000.0 / res->frames,
+               res->plc_ns / 1000.0 / (res->frames / 2), rtf, res->snr);
+
+        TEST_ASSERT(res->snr >= BENCH_SNR_MIN_DB);
+    }
+
+    bench_vectors_check(results, run);
+}
+#endif /* BLE_AUDIO_TEST_LC3_BENCH */
@@ -2254,6 +2254,83 @@ int ble_gap_wl_set(const ble_addr_t *addrs, uint8_t white_list_count);
  */
 int ble_gap_wl_read_size(uint8_t *size);
 
+#if MYNEWT_VAL(BLE_GAP_BG_CONN_MAX_PEERS)
+/**
+ * Starts background connection establishment. The host keeps connections to
+ * all peers added with ble_gap_bg_conn_peer_add() by initiating to the
+ * controller's white list and re-arming after each connection and
+ * disconnection, so that all disconnected peers are connected in parallel. If
+ * there are more disconnected peers than white list entries, peers are
+ * rotated in the white list every BLE_GAP_BG_CONN_ROTATE_MS.
+ *
+ * While background connection is active, the host owns the white list and it
+ * shall not be modified by the application. Other master procedures (connect,
+ * discovery) may still be started; background connect procedure is cancelled
+ * to make room for them and resumes when they are done. Background connect
+ * procedure is not cancelled by ble_gap_conn_cancel(), use
+ * ble_gap_bg_conn_stop() instead.
+ *
+ * @param own_addr_type         The type of address the stack should use for
+ *                                  itself during connection establishment.
+ *                                      - BLE_OWN_ADDR_PUBLIC
+ *                                      - BLE_OWN_ADDR_RANDOM
+ *                                      - BLE_OWN_ADDR_RPA_PUBLIC_DEFAULT
+ *                                      - BLE_OWN_ADDR_RPA_RANDOM_DEFAULT
+ * @param params                Additional arguments specifying the particulars
+ *                                  of the connect procedure.  Specify null for
+ *                                  default values.
+ * @param cb                    The callback to associate with connections
+ *                                  established in background.  It receives
+ *                                  BLE_GAP_EVENT_CONNECT on success and all
+ *                                  subsequent events of the connection.
+ * @param cb_arg                The optional argument to pass to the callback
+ *                                  function.
+ *
+ * @return                      0 on success;
+ *                              BLE_HS_EALREADY if background connection is
+ *                                  already active;
+ *                              Other nonzero on error.
+ */
+int ble_gap_bg_conn_start(uint8_t own_addr_type,
+                          const struct ble_gap_conn_params *params,
+                          ble_gap_event_fn *cb, void *cb_arg);
+
+/**
+ * Stops background connection establishment. Established connections are not
+ * terminated and keep reporting events to the background connection callback.
+ * Initiating is cancelled asynchronously, so a connect procedure may still be
+ * reported as active for a short while after return.
+ *
+ * @return                      0 on success;
+ *                              BLE_HS_EALREADY if background connection is
+ *                                  not active.
+ */
+int ble_gap_bg_conn_stop(void);
+
+/**
+ * Adds a peer to the set of peers to keep connected in background.
+ *
+ * @param addr                  The identity address of the peer.
+ *
+ * @return                      0 on success;
+ *                              BLE_HS_EALREADY if peer is already in the set;
+ *                              BLE_HS_ENOMEM if the set is full;
+ *                              BLE_HS_EINVAL if address type is invalid.
+ */
+int ble_gap_bg_conn_peer_add(const ble_addr_t *addr);
+
+/**
+ * Removes a peer from the set of peers to keep connected in background. If
+ * the peer is connected, the connection is not terminated.
+ *
+ * @param addr                  The identity address of the peer.
+ *
+ * @return                      0 on success;
+ *                              BLE_HS_ENOENT if peer is not in the set.
+ */
+int ble_gap_bg_conn_peer_remove(const ble_addr_t *addr);
+#endif
+
 /**
  * Initiates a connection parameter update procedure.
  *
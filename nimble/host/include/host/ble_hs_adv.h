@@ -28,6 +28,8 @@
  */
 
 #include <inttypes.h>
+#include "syscfg/syscfg.h"
+#include "nimble/ble.h"
 #include "host/ble_uuid.h"
 
 #ifdef __cplusplus
@@ -370,6 +372,134 @@ int ble_hs_adv_parse_fields(struct ble_hs_adv_fields *adv_fields,
 int ble_hs_adv_parse(const uint8_t *data, uint8_t length,
                      ble_hs_adv_parse_func_t func, void *user_data);
 
+#if MYNEWT_VAL(BLE_HS_ADV_FILTER_MAX_RULES)
+/**
+ * @defgroup ble_hs_adv_filter Advertising Report Filter
+ * @{
+ */
+
+/** Filter rule matching a service UUID. */
+#define BLE_HS_ADV_FILTER_TYPE_UUID             1
+
+/** Filter rule matching manufacturer specific data. */
+#define BLE_HS_ADV_FILTER_TYPE_MFG              2
+
+/** Filter rule matching a prefix of complete or shortened local name. */
+#define BLE_HS_ADV_FILTER_TYPE_NAME             3
+
+/** Filter rule matching a range of advertiser addresses. */
+#define BLE_HS_ADV_FILTER_TYPE_ADDR             4
+
+/** Max length of manufacturer data (excluding company ID) or name prefix. */
+#define BLE_HS_ADV_FILTER_PREFIX_MAX_LEN        16
+
+/** Don't filter reports on RSSI. */
+#define BLE_HS_ADV_FILTER_RSSI_ANY              (-128)
+
+/** Advertising report filter rule. */
+struct ble_hs_adv_filter_rule {
+    /** One of BLE_HS_ADV_FILTER_TYPE_* values. */
+    uint8_t type;
+
+    union {
+        /**
+         * BLE_HS_ADV_FILTER_TYPE_UUID: UUID in complete or incomplete list of
+         * service UUIDs, or in service data. UUID is matched in its own size
+         * only, e.g. 16-bit UUID is not matched against 128-bit UUIDs.
+         */
+        const ble_uuid_t *uuid;
+
+        /** BLE_HS_ADV_FILTER_TYPE_MFG */
+        struct {
+            /** Company identifier. */
+            uint16_t company_id;
+
+            /** Prefix of data following company identifier, may be NULL. */
+            const uint8_t *data;
+
+            /** Length of data prefix. */
+            uint8_t data_len;
+        } mfg;
+
+        /** BLE_HS_ADV_FILTER_TYPE_NAME */
+        struct {
+            /** Name prefix, not null terminated. */
+            const char *prefix;
+
+            /** Length of name prefix. */
+            uint8_t prefix_len;
+        } name;
+
+        /**
+         * BLE_HS_ADV_FILTER_TYPE_ADDR: Address in inclusive range. Both
+         * addresses shall be of the same type.
+         */
+        struct {
+            /** Lowest matching address. */
+            ble_addr_t min;
+
+            /** Highest matching address. */
+            ble_addr_t max;
+        } addr;
+    };
+};
+
+/** Advertising report filter parameters. */
+struct ble_hs_adv_filter_params {
+    /**
+     * Filter rules. Report matches if it matches any of the rules or if there
+     * are no rules.
+     */
+    const struct ble_hs_adv_filter_rule *rules;
+
+    /** Number of filter rules. */
+    uint8_t num_rules;
+
+    /**
+     * Reports with lower RSSI are dropped. BLE_HS_ADV_FILTER_RSSI_ANY to
+     * accept any RSSI.
+     */
+    int8_t rssi_min;
+};
+
+/**
+ * Sets the filter applied to advertising reports before they are reported to
+ * the application as BLE_GAP_EVENT_DISC and BLE_GAP_EVENT_EXT_DISC events.
+ * Rules are matched against raw advertising data as reports are received, so
+ * non-matching reports are dropped without being parsed by the application.
+ *
+ * Scan responses and subsequent fragments of extended advertising data are
+ * reported if the preceding report from the same advertiser matched, as they
+ * usually don't repeat the fields that are matched. Subsequent fragments of
+ * extended advertising data which first fragment was dropped are dropped as
+ * well.
+ *
+ * Rules are copied, so they don't need to be valid after return. Setting a
+ * filter clears filter statistics.
+ *
+ * @param params                Filter parameters; NULL to disable filtering.
+ *
+ * @return                      0 on success;
+ *                              BLE_HS_ENOMEM if there are too many rules;
+ *                              BLE_HS_EINVAL if a rule is invalid.
+ */
+int ble_hs_adv_filter_set(const struct ble_hs_adv_filter_params *params);
+
+/**
+ * Reads advertising report filter statistics.
+ *
+ * @param out_hits              On success, number of reports which were
+ *                                  reported to the application.
+ * @param out_misses            On success, number of reports which were
+ *                                  dropped by the filter.
+ */
+void ble_hs_adv_filter_stats(uint32_t *out_hits, uint32_t *out_misses);
+
+/**
+ * @}
+ */
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -45,6 +45,15 @@ struct os_mbuf;
  */
 struct os_mbuf *ble_hs_mbuf_att_pkt(void);
 
+/**
+ * Allocates an mbuf suitable for an ISO SDU.  The resulting packet has
+ * sufficient leading space for HCI ISO data headers, so it can be passed to
+ * ble_iso_tx_mbuf() without copying.
+ *
+ * @return An empty mbuf on success, NULL on error.
+ */
+struct os_mbuf *ble_hs_mbuf_iso_pkt(void);
+
 /**
  * Allocates an mbuf and fills it with the contents of the specified flat
  * buffer.
@@ -53,6 +53,9 @@
 /** ISO event: ISO Data received */
 #define BLE_ISO_EVENT_ISO_RX                                4
 
+/** ISO event: ISO Data transmission completed */
+#define BLE_ISO_EVENT_ISO_TX_COMPLETE                       5
+
 /** @} */
 
 /** @brief Broadcast Isochronous Group (BIG) description */
@@ -142,6 +145,85 @@ struct ble_iso_rx_data_info {
     uint16_t ts_valid : 1;
 };
 
+/** @brief Transmitted ISO data info structure */
+struct ble_iso_tx_data_info {
+    /**
+     * SDU synchronization reference in microseconds. Sent only if
+     * @ref ble_iso_tx_data_info.ts_valid is set
+     */
+    uint32_t ts;
+
+    /**
+     * Packet sequence number. Used only if
+     * @ref ble_iso_tx_data_info.seq_num_valid is set, otherwise next sequence
+     * number of the connection is used.
+     */
+    uint16_t seq_num;
+
+    /** Timestamp is valid */
+    uint16_t ts_valid : 1;
+
+    /** Sequence number is valid */
+    uint16_t seq_num_valid : 1;
+};
+
+/** @brief ISO data transmission statistics */
+struct ble_iso_tx_stats {
+    /** Sequence number to be used for the next SDU */
+    uint16_t seq_num;
+
+    /** Number of HCI ISO Data packets not yet completed by controller */
+    uint16_t outstanding;
+
+    /** Number of HCI ISO Data packets completed by controller */
+    uint32_t completed;
+
+    /** Time in milliseconds last completed packet spent in controller */
+    uint32_t latency_last;
+
+    /** Maximum time in milliseconds a packet spent in controller */
+    uint32_t latency_max;
+
+    /** Number of SDUs waiting in host TX queue */
+    uint8_t queued;
+
+    /** Maximum number of SDUs waiting in host TX queue */
+    uint8_t queued_max;
+
+    /** Number of SDUs dropped because they were stale or queue was full */
+    uint32_t dropped;
+
+    /** Time in milliseconds last SDU spent in host TX queue */
+    uint32_t wait_last;
+
+    /** Maximum time in milliseconds an SDU spent in host TX queue */
+    uint32_t wait_max;
+
+    /** Mean deviation of time in milliseconds SDUs spend in host TX queue */
+    uint32_t jitter;
+};
+
+/** @brief ISO data reception statistics */
+struct ble_iso_rx_stats {
+    /** Number of SDUs passed to application */
+    uint32_t sdus;
+
+    /** Number of HCI ISO Data packets received */
+    uint32_t frags;
+
+    /** Number of SDU octets passed to application */
+    uint32_t bytes;
+
+    /**
+     * Number of SDUs passed to application with
+     * @ref BLE_ISO_DATA_STATUS_LOST status because of missing fragments
+     */
+    uint32_t incomplete;
+
+    /** Number of HCI ISO Data packets discarded as malformed */
+    uint32_t invalid;
+};
+
 /**
  * Represents a ISO-related event.  When such an event occurs, the host
  * notifies the application by passing an instance of this structure to an
@@ -198,9 +280,35 @@ struct ble_iso_event {
          */
         struct {
             uint16_t conn_handle;
+
+            /** SDU timestamp, sequence number, length and status */
             const struct ble_iso_rx_data_info *info;
+
+            /**
+             * SDU data, chain of received HCI ISO Data packet buffers with
+             * headers stripped. Ownership is passed to application, which
+             * shall free it.
+             */
             struct os_mbuf *om;
         } iso_rx;
+
+        /**
+         * Represents completion of ISO Data transmission by controller.
+         * Valid for the following event types:
+         *     o BLE_ISO_EVENT_ISO_TX_COMPLETE
+         */
+        struct {
+            uint16_t conn_handle;
+
+            /** Number of HCI ISO Data packets completed */
+            uint16_t num_pkts;
+
+            /** Number of HCI ISO Data packets still outstanding */
+            uint16_t outstanding;
+
+            /** Time in milliseconds last completed packet spent in controller */
+            uint32_t latency;
+        } iso_tx_complete;
     };
 };
 
@@ -437,8 +545,9 @@ struct ble_iso_data_path_setup_params {
     const uint8_t *codec_config;
 
     /**
-     * The ISO Data callback. Must be set if @p data_path_id is HCI.
-     * Received ISO data is reported through this callback.
+     * The ISO Data callback. Must be set if @p data_path_id is HCI and
+     * @p data_path_dir includes RX. Received ISO data and completion of
+     * transmitted ISO data are reported through this callback.
      */
     ble_iso_event_fn *cb;
 
@@ -495,6 +604,55 @@ int ble_iso_data_path_remove(const struct ble_iso_data_path_remove_params *param
  */
 int ble_iso_tx(uint16_t conn_handle, void *data, uint16_t data_len);
 
+/**
+ * Initiates the transmission of isochronous data from mbuf.
+ *
+ * ISO data headers are put in leading space of the mbuf, so mbuf allocated
+ * with ble_hs_mbuf_iso_pkt() is sent without copying data. SDUs larger than
+ * transport ISO buffer are fragmented. Completion of each HCI ISO Data packet
+ * is reported with BLE_ISO_EVENT_ISO_TX_COMPLETE event.
+ *
+ * If BLE_ISO_TX_QUEUE_SIZE is non-zero, SDUs are queued in host and passed to
+ * controller only when there are less than BLE_ISO_TX_MAX_OUTSTANDING packets
+ * pending. SDUs which waited for longer than BLE_ISO_TX_QUEUE_MAX_LATENCY
+ * are dropped.
+ *
+ * @param conn_handle           The connection over which to execute the procedure.
+ * @param om                    The SDU to be transmitted. Consumed in all
+ *                                  cases.
+ * @param info                  Optional timestamp and sequence number of the
+ *                                  SDU. If NULL, next sequence number of the
+ *                                  connection is used and no timestamp is
+ *                                  sent.
+ *
+ * @return                      0 on success;
+ *                              an error code on failure.
+ */
+int ble_iso_tx_mbuf(uint16_t conn_handle, struct os_mbuf *om,
+                    const struct ble_iso_tx_data_info *info);
+
+/**
+ * Retrieves ISO data transmission statistics of the connection.
+ *
+ * @param conn_handle           The CIS or BIS connection handle.
+ * @param stats                 On success, statistics are written here.
+ *
+ * @return                      0 on success;
+ *                              BLE_HS_ENOTCONN if no such connection.
+ */
+int ble_iso_tx_stats_get(uint16_t conn_handle, struct ble_iso_tx_stats *stats);
+
+/**
+ * Retrieves ISO data reception statistics of the connection.
+ *
+ * @param conn_handle           The CIS or BIS connection handle.
+ * @param stats                 On success, statistics are written here.
+ *
+ * @return                      0 on success;
+ *                              BLE_HS_ENOTCONN if no such connection.
+ */
+int ble_iso_rx_stats_get(uint16_t conn_handle, struct ble_iso_rx_stats *stats);
+
 /**
  * Initializes memory for ISO.
  *
@@ -405,6 +405,12 @@ void bt_conn_get_info(struct ble_hs_conn *conn, struct ble_gap_conn_desc *desc);
 int bt_rand(void *buf, size_t len);
 const char * bt_hex(const void *buf, size_t len);
 int bt_encrypt_be(const uint8_t *key, const uint8_t *plaintext, uint8_t *enc_data);
+void bt_mesh_aes_key_cache_invalidate(const uint8_t key[16]);
+void bt_mesh_aes_key_cache_clear(void);
+#if MYNEWT_VAL(BLE_MESH_AES_TTABLE)
+void bt_mesh_aes_ttable_encrypt(const unsigned int rk[44],
+				const uint8_t in[16], uint8_t out[16]);
+#endif
 int bt_ccm_decrypt(const uint8_t key[16], uint8_t nonce[13], const uint8_t *enc_data,
 		   size_t len, const uint8_t *aad, size_t aad_len,
 		   uint8_t *plaintext, size_t mic_size);
@@ -520,6 +526,7 @@ static inline unsigned int find_msb_set(uint32_t op)
 #define CONFIG_BT_MESH_APP_KEY_COUNT             MYNEWT_VAL(BLE_MESH_APP_KEY_COUNT)
 #define CONFIG_BT_MESH_SUBNET_COUNT              MYNEWT_VAL(BLE_MESH_SUBNET_COUNT)
 #define CONFIG_BT_MESH_STORE_TIMEOUT             MYNEWT_VAL(BLE_MESH_STORE_TIMEOUT)
+#define CONFIG_BT_MESH_STORE_BATCH_DELAY         MYNEWT_VAL(BLE_MESH_STORE_BATCH_DELAY)
 #define CONFIG_BT_MESH_IV_UPDATE_SEQ_LIMIT       MYNEWT_VAL(BLE_MESH_IV_UPDATE_SEQ_LIMIT)
 #define CONFIG_BT_MESH_IVU_DIVIDER               MYNEWT_VAL(BLE_MESH_IVU_DIVIDER)
 #define CONFIG_BT_DEVICE_NAME                    MYNEWT_VAL(BLE_MESH_DEVICE_NAME)
@@ -616,7 +623,9 @@ char *settings_str_from_bytes(const void *vp, int vp_len,
 
 #define snprintk snprintf
 #define BT_SETTINGS_SIZE(in_size) ((((((in_size) - 1) / 3) * 4) + 4) + 1)
-#define settings_save_one conf_save_one
+/* Writes go through mesh settings, so they can be counted */
+int bt_mesh_settings_save_one(const char *name, char *val);
+#define settings_save_one bt_mesh_settings_save_one
 
 #else
 
@@ -48,8 +48,26 @@ struct mod_pub_val {
 		 cred:1;
 };
 
+#define OP_TABLE_SIZE MYNEWT_VAL(BLE_MESH_ACCESS_OP_TABLE_SIZE)
+
+/* Opcode dispatch entry. For each opcode and element only the first model
+ * (in composition order) handling it is present, same as linear lookup done
+ * by find_op().
+ */
+struct op_table_entry {
+	uint32_t opcode;
+	struct bt_mesh_model *model;
+	const struct bt_mesh_model_op *op;
+};
+
 static const struct bt_mesh_comp *dev_comp;
 static uint16_t dev_primary_addr;
+#if OP_TABLE_SIZE > 0
+/* Sorted by opcode and element index, valid only if op_table_used is set */
+static struct op_table_entry op_table[OP_TABLE_SIZE];
+static uint16_t op_table_count;
+static bool op_table_used;
+#endif
 static void (*msg_cb)(uint32_t opcode, struct bt_mesh_msg_ctx *ctx, struct os_mbuf *buf);
 
 void bt_mesh_model_foreach(void (*func)(struct bt_mesh_model *mod,
@@ -357,6 +375,110 @@ static void mod_init(struct bt_mesh_model *mod, struct bt_mesh_elem *elem,
 	}
 }
 
+#if OP_TABLE_SIZE > 0
+static int op_table_cmp(const void *a, const void *b)
+{
+	const struct op_table_entry *ea = a;
+	const struct op_table_entry *eb = b;
+
+	if (ea->opcode != eb->opcode) {
+		return ea->opcode < eb->opcode ? -1 : 1;
+	}
+
+	if (ea->model->elem_idx != eb->model->elem_idx) {
+		return ea->model->elem_idx < eb->model->elem_idx ? -1 : 1;
+	}
+
+	/* Opcode length selects single model list so mod_idx is unique */
+	if (ea->model->mod_idx != eb->model->mod_idx) {
+		return ea->model->mod_idx < eb->model->mod_idx ? -1 : 1;
+	}
+
+	return ea->op < eb->op ? -1 : (ea->op > eb->op);
+}
+
+static void op_table_add(struct bt_mesh_model *mod, struct bt_mesh_elem *elem,
+			 bool vnd, bool primary, void *user_data)
+{
+	const struct bt_mesh_model_op *op;
+
+	for (op = mod->op; op && op->func; op++) {
+		/* Vendor models only handle vendor opcodes and vice versa */
+		if ((BT_MESH_MODEL_OP_LEN(op->opcode) < 3) == vnd) {
+			continue;
+		}
+
+		/* Same company check as in find_op() */
+		if (CONFIG_BT_MESH_MODEL_VND_MSG_CID_FORCE && vnd &&
+		    (op->opcode & 0xffff) != mod->vnd.company) {
+			continue;
+		}
+
+		if (op_table_count == ARRAY_SIZE(op_table)) {
+			op_table_used = false;
+			return;
+		}
+
+		op_table[op_table_count].opcode = op->opcode;
+		op_table[op_table_count].model = mod;
+		op_table[op_table_count].op = op;
+		op_table_count++;
+	}
+}
+
+static void op_table_build(void)
+{
+	uint16_t i, j;
+
+	op_table_count = 0U;
+	op_table_used = true;
+
+	bt_mesh_model_foreach(op_table_add, NULL);
+
+	if (!op_table_used) {
+		BT_WARN("Too many opcodes for dispatch table, using linear "
+			"lookup");
+		return;
+	}
+
+	qsort(op_table, op_table_count, sizeof(op_table[0]), op_table_cmp);
+
+	/* Keep only first model of each element handling given opcode */
+	for (i = 0U, j = 0U; i < op_table_count; i++) {
+		if (j > 0 && op_table[j - 1].opcode == op_table[i].opcode &&
+		    op_table[j - 1].model->elem_idx ==
+		    op_table[i].model->elem_idx) {
+			continue;
+		}
+
+		op_table[j++] = op_table[i];
+	}
+
+	op_table_count = j;
+
+	BT_DBG("%u opcodes in dispatch table", op_table_count);
+}
+
+/* Returns index of first entry for given opcode or op_table_count */
+static uint16_t op_table_find(uint32_t opcode)
+{
+	uint16_t lo = 0U;
+	uint16_t hi = op_table_count;
+	uint16_t mid;
+
+	while (lo < hi) {
+		mid = (lo + hi) / 2U;
+		if (op_table[mid].opcode < opcode) {
+			lo = mid + 1U;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return lo;
+}
+#endif
+
 int bt_mesh_comp_register(const struct bt_mesh_comp *comp)
 {
 	int err;
@@ -371,6 +493,12 @@ int bt_mesh_comp_register(const struct bt_mesh_comp *comp)
 	err = 0;
 	bt_mesh_model_foreach(mod_init, &err);
 
+#if OP_TABLE_SIZE > 0
+	if (!err) {
+		op_table_build();
+	}
+#endif
+
 	return err;
 }
 
@@ -666,27 +794,58 @@ static int get_opcode(struct os_mbuf *buf, uint32_t *opcode)
 	CODE_UNREACHABLE;
 }
 
-void bt_mesh_model_recv(struct bt_mesh_net_rx *rx, struct os_mbuf *buf)
+static void model_recv(struct bt_mesh_net_rx *rx, struct os_mbuf *buf,
+		       struct bt_mesh_model *model,
+		       const struct bt_mesh_model_op *op, uint32_t opcode)
+{
+	struct net_buf_simple_state state;
+
+	if (!bt_mesh_model_has_key(model, rx->ctx.app_idx)) {
+		return;
+	}
+
+	if (!model_has_dst(model, rx->ctx.recv_dst)) {
+		return;
+	}
+
+	if ((op->len >= 0) && (buf->om_len < (size_t)op->len)) {
+		BT_ERR("Too short message for OpCode 0x%08x", opcode);
+		return;
+	} else if ((op->len < 0) && (buf->om_len != (size_t)(-op->len))) {
+		BT_ERR("Invalid message size for OpCode 0x%08x",
+		       opcode);
+		return;
+	}
+
+	/* The callback will likely parse the buffer, so
+	 * store the parsing state in case multiple models
+	 * receive the message.
+	 */
+	net_buf_simple_save(buf, &state);
+	(void)op->func(model, &rx->ctx, buf);
+	net_buf_simple_restore(buf, &state);
+}
+
+static void model_dispatch(struct bt_mesh_net_rx *rx, struct os_mbuf *buf,
+			   uint32_t opcode)
 {
 	struct bt_mesh_model *model;
 	const struct bt_mesh_model_op *op;
-	uint32_t opcode;
 	int i;
 
-	BT_DBG("app_idx 0x%04x src 0x%04x dst 0x%04x", rx->ctx.app_idx,
-	       rx->ctx.addr, rx->ctx.recv_dst);
-	BT_DBG("len %u: %s", buf->om_len, bt_hex(buf->om_data, buf->om_len));
+#if OP_TABLE_SIZE > 0
+	if (op_table_used) {
+		for (i = op_table_find(opcode);
+		     i < op_table_count && op_table[i].opcode == opcode; i++) {
+			model_recv(rx, buf, op_table[i].model, op_table[i].op,
+				   opcode);
+		}
 
-	if (get_opcode(buf, &opcode) < 0) {
-		BT_WARN("Unable to decode OpCode");
 		return;
 	}
-
-	BT_DBG("OpCode 0x%08x", (unsigned) opcode);
+#endif
 
 	for (i = 0; i < dev_comp->elem_count; i++) {
-		struct net_buf_simple_state state;
-
 		op = find_op(&dev_comp->elem[i], opcode, &model);
 
 		if (!op) {
@@ -694,32 +853,27 @@ void bt_mesh_model_recv(struct bt_mesh_net_rx *rx, struct os_mbuf *buf)
 			continue;
 		}
 
-		if (!bt_mesh_model_has_key(model, rx->ctx.app_idx)) {
-				continue;
-			}
+		model_recv(rx, buf, model, op, opcode);
+	}
+}
 
-		if (!model_has_dst(model, rx->ctx.recv_dst)) {
-			continue;
-		}
+void bt_mesh_model_recv(struct bt_mesh_net_rx *rx, struct os_mbuf *buf)
+{
+	uint32_t opcode;
 
-		if ((op->len >= 0) && (buf->om_len < (size_t)op->len)) {
-			BT_ERR("Too short message for OpCode 0x%08x", opcode);
-			continue;
-		} else if ((op->len < 0) && (buf->om_len != (size_t)(-op->len))) {
-			BT_ERR("Invalid message size for OpCode 0x%08x",
-			       opcode);
-			continue;
-		}
+	BT_DBG("app_idx 0x%04x src 0x%04x dst 0x%04x", rx->ctx.app_idx,
+	       rx->ctx.addr, rx->ctx.recv_dst);
+	BT_DBG("len %u: %s", buf->om_len, bt_hex(buf->om_data, buf->om_len));
 
-		/* The callback will likely parse the buffer, so
-		 * store the parsing state in case multiple models
-		 * receive the message.
-		 */
-		net_buf_simple_save(buf, &state);
-		(void)op->func(model, &rx->ctx, buf);
-		net_buf_simple_restore(buf, &state);
+	if (get_opcode(buf, &opcode) < 0) {
+		BT_WARN("Unable to decode OpCode");
+		return;
 	}
 
+	BT_DBG("OpCode 0x%08x", (unsigned) opcode);
+
+	model_dispatch(rx, buf, opcode);
+
 	if (MYNEWT_VAL(BLE_MESH_ACCESS_LAYER_MSG) && msg_cb) {
 		msg_cb(opcode, &rx->ctx, buf);
 	}
@@ -38,6 +38,9 @@ extern uint8_t g_mesh_addr_type;
 
 struct os_mbuf_pool adv_os_mbuf_pool;
 struct ble_npl_eventq bt_mesh_adv_queue;
+#if MYNEWT_VAL(BLE_MESH_ADV_EXT)
+struct ble_npl_eventq bt_mesh_relay_queue;
+#endif
 
 os_membuf_t adv_buf_mem[OS_MEMPOOL_SIZE(
         MYNEWT_VAL(BLE_MESH_ADV_BUF_COUNT),
@@ -100,6 +103,16 @@ void bt_mesh_adv_send(struct os_mbuf *buf, const struct bt_mesh_send_cb *cb,
 	BT_MESH_ADV(buf)->cb_data = cb_data;
 	BT_MESH_ADV(buf)->busy = 1;
 
+#if MYNEWT_VAL(BLE_MESH_ADV_EXT)
+	BT_MESH_ADV(buf)->queued = k_uptime_get_32();
+
+	if (BT_MESH_ADV(buf)->tag == BT_MESH_RELAY_ADV) {
+		net_buf_put(&bt_mesh_relay_queue, net_buf_ref(buf));
+		bt_mesh_adv_buf_relay_ready();
+		return;
+	}
+#endif
+
 	net_buf_put(&bt_mesh_adv_queue, net_buf_ref(buf));
 	bt_mesh_adv_buf_ready();
 }
@@ -32,6 +32,12 @@ extern struct os_mbuf_pool adv_os_mbuf_pool;
 extern struct ble_npl_eventq bt_mesh_adv_queue;
 extern struct os_mempool adv_buf_mempool;
 extern os_membuf_t adv_buf_mem[];
+#if MYNEWT_VAL(BLE_MESH_ADV_EXT)
+/* Relayed messages are queued separately so they can be sent through
+ * dedicated advertising sets without delaying local traffic.
+ */
+extern struct ble_npl_eventq bt_mesh_relay_queue;
+#endif
 
 enum bt_mesh_adv_type
 {
@@ -43,6 +49,14 @@ enum bt_mesh_adv_type
 	BT_MESH_ADV_TYPES,
 };
 
+enum bt_mesh_adv_tag
+{
+	BT_MESH_LOCAL_ADV,
+	BT_MESH_RELAY_ADV,
+
+	BT_MESH_ADV_TAGS,
+};
+
 typedef void (*bt_mesh_adv_func_t)(struct os_mbuf *buf, uint16_t duration,
 				   int err, void *user_data);
 
@@ -65,7 +79,8 @@ struct bt_mesh_adv {
 
 	uint8_t      type:2,
 		     started:1,
-		     busy:1;
+		     busy:1,
+		     tag:1;
 
 	uint8_t      xmit;
 
@@ -73,6 +88,11 @@ struct bt_mesh_adv {
 
 	int ref_cnt;
 	struct ble_npl_event ev;
+
+#if MYNEWT_VAL(BLE_MESH_ADV_EXT)
+	/* Time when buffer was queued for sending, in ms */
+	uint32_t queued;
+#endif
 };
 
 typedef struct bt_mesh_adv *(*bt_mesh_adv_alloc_t)(int id);
@@ -100,6 +120,29 @@ int bt_mesh_adv_enable(void);
 
 void bt_mesh_adv_buf_ready(void);
 
+#if MYNEWT_VAL(BLE_MESH_ADV_EXT)
+struct bt_mesh_adv_ext_stats {
+	/** Number of messages sent */
+	uint32_t tx;
+	/** Total time messages waited for an advertising set, in ms */
+	uint32_t wait_total;
+	/** Longest time a message waited for an advertising set, in ms */
+	uint32_t wait_max;
+};
+
+void bt_mesh_adv_buf_relay_ready(void);
+
+/** @brief Get extended advertiser statistics for local or relayed traffic.
+ *
+ *  @param tag   BT_MESH_LOCAL_ADV or BT_MESH_RELAY_ADV.
+ *  @param stats Statistics output.
+ *
+ *  @return 0 on success, or (negative) error code on failure.
+ */
+int bt_mesh_adv_ext_stats_get(enum bt_mesh_adv_tag tag,
+			      struct bt_mesh_adv_ext_stats *stats);
+#endif
+
 int bt_mesh_adv_start(const struct ble_gap_adv_params *param, int32_t duration,
 		      const struct bt_data *ad, size_t ad_len,
 		      const struct bt_data *sd, size_t sd_len);
@@ -20,14 +20,28 @@
 #if MYNEWT_VAL(BLE_MESH_ADV_EXT)
 /* Convert from ms to 0.625ms units */
 #define ADV_INT_FAST_MS    20
-#define BT_ID_DEFAULT      0
 
-static struct ble_gap_ext_adv_params adv_param = {
-	.itvl_min = BT_MESH_ADV_SCAN_UNIT(ADV_INT_FAST_MS),
-	.itvl_max = BT_MESH_ADV_SCAN_UNIT(ADV_INT_FAST_MS),
-};
+/* Advertising sets: main set for local traffic, optional relay sets and
+ * optional separate set for GATT (proxy and PB-GATT) advertising.
+ */
+#define ADV_SET_RELAY_COUNT    MYNEWT_VAL(BLE_MESH_RELAY_ADV_SETS)
+#define ADV_SET_GATT_COUNT     (MYNEWT_VAL(BLE_MESH_GATT_SERVER) && \
+				MYNEWT_VAL(BLE_MESH_ADV_EXT_GATT_SEPARATE))
+#define ADV_SET_COUNT          (1 + ADV_SET_RELAY_COUNT + ADV_SET_GATT_COUNT)
+
+/* Note that BLE_MULTI_ADV_INSTANCES contains number of additional instances.
+ * Instance 0 is always there
+ */
+#if ADV_SET_COUNT > MYNEWT_VAL(BLE_MULTI_ADV_INSTANCES) + 1
+#error "Mesh advertising sets need more BLE_MULTI_ADV_INSTANCES"
+#endif
+
+/* Traffic served by advertising set */
+#define ADV_TAG_LOCAL      BIT(0)
+#define ADV_TAG_RELAY      BIT(1)
+#define ADV_TAG_PROXY      BIT(2)
 
-bool ext_adv_configured = false;
+extern uint8_t g_mesh_addr_type;
 
 enum {
 	/** Controller is currently advertising */
@@ -45,28 +59,42 @@ enum {
 	ADV_FLAGS_NUM
 };
 
-static struct {
+struct bt_mesh_ext_adv {
 	ATOMIC_DEFINE(flags, ADV_FLAGS_NUM);
-	struct bt_le_ext_adv *instance;
+	uint8_t tags;
+	uint8_t instance;
+	uint8_t connectable;
+	uint32_t itvl;
 	struct os_mbuf *buf;
 	int64_t timestamp;
 	struct k_work_delayable work;
-} adv;
+};
+
+static struct bt_mesh_ext_adv advs[ADV_SET_COUNT];
+static struct bt_mesh_adv_ext_stats adv_stats[BT_MESH_ADV_TAGS];
 
+#define ADV_MAIN           (&advs[0])
+#define ADV_RELAY(_i)      (&advs[1 + (_i)])
 
-static void schedule_send(void)
+#if ADV_SET_GATT_COUNT
+#define ADV_GATT           (&advs[ADV_SET_COUNT - 1])
+#else
+#define ADV_GATT           ADV_MAIN
+#endif
+
+static bool schedule_send(struct bt_mesh_ext_adv *adv)
 {
-	int64_t timestamp = adv.timestamp;
+	int64_t timestamp = adv->timestamp;
 	int64_t delta;
 
-	if (atomic_test_and_clear_bit(adv.flags, ADV_FLAG_PROXY)) {
-		ble_gap_ext_adv_stop(BT_ID_DEFAULT);
-		atomic_clear_bit(adv.flags, ADV_FLAG_ACTIVE);
+	if (atomic_test_and_clear_bit(adv->flags, ADV_FLAG_PROXY)) {
+		ble_gap_ext_adv_stop(adv->instance);
+		atomic_clear_bit(adv->flags, ADV_FLAG_ACTIVE);
 	}
 
-	if (atomic_test_bit(adv.flags, ADV_FLAG_ACTIVE) ||
-	atomic_test_and_set_bit(adv.flags, ADV_FLAG_SCHEDULED)) {
-		return;
+	if (atomic_test_bit(adv->flags, ADV_FLAG_ACTIVE) ||
+	    atomic_test_and_set_bit(adv->flags, ADV_FLAG_SCHEDULED)) {
+		return false;
 	}
 
 	/* The controller will send the next advertisement immediately.
@@ -74,37 +102,44 @@ static void schedule_send(void)
 	 * to the previous packet than what's permitted by the specification.
 	 */
 	delta = k_uptime_delta(&timestamp);
-	k_work_reschedule(&adv.work, K_MSEC(ADV_INT_FAST_MS - delta));
+	if (delta >= ADV_INT_FAST_MS) {
+		delta = ADV_INT_FAST_MS;
+	}
+
+	k_work_reschedule(&adv->work, K_MSEC(ADV_INT_FAST_MS - delta));
+
+	return true;
 }
 
 static int
 ble_mesh_ext_adv_event_handler(struct ble_gap_event *event, void *arg)
 {
+	struct bt_mesh_ext_adv *adv = arg;
 	int64_t duration;
 
 	switch (event->type) {
-	case BLE_GAP_EVENT_CONNECT:
-		if (atomic_test_and_clear_bit(adv.flags, ADV_FLAG_PROXY)) {
-			atomic_clear_bit(adv.flags, ADV_FLAG_ACTIVE);
-			schedule_send();
-		}
-		break;
 	case BLE_GAP_EVENT_ADV_COMPLETE:
 		/* Calling k_uptime_delta on a timestamp moves it to the current time.
 		 * This is essential here, as schedule_send() uses the end of the event
 		 * as a reference to avoid sending the next advertisement too soon.
 		 */
-		duration = k_uptime_delta(&adv.timestamp);
+		duration = k_uptime_delta(&adv->timestamp);
 
-		BT_DBG("Advertising stopped after %u ms", (uint32_t)duration);
+		BT_DBG("Advertising set %u stopped after %u ms", adv->instance,
+		       (uint32_t)duration);
 
-		atomic_clear_bit(adv.flags, ADV_FLAG_ACTIVE);
+		/* Proxy advertising is also completed this way when connection
+		 * gets established.
+		 */
+		atomic_clear_bit(adv->flags, ADV_FLAG_PROXY);
+		atomic_clear_bit(adv->flags, ADV_FLAG_ACTIVE);
 
-		if (!atomic_test_and_clear_bit(adv.flags, ADV_FLAG_PROXY)) {
-			net_buf_unref(adv.buf);
+		if (adv->buf) {
+			net_buf_unref(adv->buf);
+			adv->buf = NULL;
 		}
 
-		schedule_send();
+		schedule_send(adv);
 		break;
 	default:
 		return 0;
@@ -112,88 +147,127 @@ ble_mesh_ext_adv_event_handler(struct ble_gap_event *event, void *arg)
 	return 0;
 }
 
-static int adv_start(const struct ble_gap_ext_adv_params *param,
-		     uint32_t timeout,
-		     const struct bt_data *ad, size_t ad_len,
-		     const struct bt_data *sd, size_t sd_len)
+static int adv_configure(struct bt_mesh_ext_adv *adv, uint32_t itvl,
+			 bool connectable)
 {
+	struct ble_gap_ext_adv_params param = { 0 };
 	int err;
-	struct os_mbuf *ad_data;
-	struct os_mbuf *sd_data;
-
-	ad_data = os_msys_get_pkthdr(BLE_HS_ADV_MAX_SZ, 0);
-	assert(ad_data);
-	sd_data = os_msys_get_pkthdr(BLE_HS_ADV_MAX_SZ, 0);
-	assert(sd_data);
-	if (!adv.instance) {
-		BT_ERR("Mesh advertiser not enabled");
-		err = -ENODEV;
-		goto error;
+
+	if (!atomic_test_bit(adv->flags, ADV_FLAG_UPDATE_PARAMS) &&
+	    adv->itvl == itvl && adv->connectable == connectable) {
+		return 0;
 	}
 
-	if (atomic_test_and_set_bit(adv.flags, ADV_FLAG_ACTIVE)) {
-		BT_ERR("Advertiser is busy");
-		err = -EBUSY;
-		goto error;
+	param.legacy_pdu = 1;
+	param.connectable = connectable;
+	param.scannable = connectable;
+	param.itvl_min = itvl;
+	param.itvl_max = itvl;
+	param.own_addr_type = g_mesh_addr_type;
+	param.primary_phy = BLE_HCI_LE_PHY_1M;
+	param.secondary_phy = BLE_HCI_LE_PHY_1M;
+	param.tx_power = 127;
+
+	err = ble_gap_ext_adv_configure(adv->instance, &param, NULL,
+					ble_mesh_ext_adv_event_handler, adv);
+	if (err) {
+		BT_ERR("Failed updating adv params: %d", err);
+		return err;
 	}
 
-	if (atomic_test_bit(adv.flags, ADV_FLAG_UPDATE_PARAMS)) {
-		err = ble_gap_ext_adv_configure(BT_ID_DEFAULT, param, NULL,
-			       ble_mesh_ext_adv_event_handler, NULL);
-		if (err) {
-			BT_ERR("Failed updating adv params: %d", err);
-			atomic_clear_bit(adv.flags, ADV_FLAG_ACTIVE);
-			goto error;
+	adv->itvl = itvl;
+	adv->connectable = connectable;
+	atomic_clear_bit(adv->flags, ADV_FLAG_UPDATE_PARAMS);
+
+	return 0;
+}
+
+static struct os_mbuf *adv_data_get(const struct bt_data *ad, size_t ad_len)
+{
+	struct os_mbuf *data;
+	uint8_t hdr[2];
+	size_t i;
+
+	data = os_msys_get_pkthdr(BLE_HS_ADV_MAX_SZ, 0);
+	if (!data) {
+		return NULL;
+	}
+
+	for (i = 0; i < ad_len; i++) {
+		hdr[0] = ad[i].data_len + 1;
+		hdr[1] = ad[i].type;
+
+		if (os_mbuf_append(data, hdr, sizeof(hdr)) ||
+		    os_mbuf_append(data, ad[i].data, ad[i].data_len)) {
+			os_mbuf_free_chain(data);
+			return NULL;
 		}
+	}
+
+	return data;
+}
+
+static int adv_start(struct bt_mesh_ext_adv *adv, uint32_t itvl,
+		     bool connectable, int duration, int max_events,
+		     const struct bt_data *ad, size_t ad_len,
+		     const struct bt_data *sd, size_t sd_len)
+{
+	struct os_mbuf *data;
+	int err;
 
-		atomic_set_bit_to(adv.flags, ADV_FLAG_UPDATE_PARAMS,
-				  param != &adv_param);
+	if (atomic_test_and_set_bit(adv->flags, ADV_FLAG_ACTIVE)) {
+		BT_ERR("Advertiser is busy");
+		return -EBUSY;
 	}
 
-	assert(ad_data);
-	err = os_mbuf_append(ad_data, ad, ad_len);
+	err = adv_configure(adv, itvl, connectable);
 	if (err) {
 		goto error;
 	}
 
-	err = ble_gap_ext_adv_set_data(BT_ID_DEFAULT, ad_data);
-	if (err) {
-		BT_ERR("Failed setting adv data: %d", err);
-		atomic_clear_bit(adv.flags, ADV_FLAG_ACTIVE);
+	/* Data mbufs are consumed by host regardless of result */
+	data = adv_data_get(ad, ad_len);
+	if (!data) {
+		err = -ENOMEM;
 		goto error;
 	}
 
-	err = os_mbuf_append(sd_data, sd, sd_len);
+	err = ble_gap_ext_adv_set_data(adv->instance, data);
 	if (err) {
+		BT_ERR("Failed setting adv data: %d", err);
 		goto error;
 	}
-	err = ble_gap_ext_adv_rsp_set_data(BT_ID_DEFAULT, sd_data);
-	if (err) {
-		BT_ERR("Failed setting scan response data: %d", err);
-		atomic_clear_bit(adv.flags, ADV_FLAG_ACTIVE);
-		goto error;
+
+	if (sd_len) {
+		data = adv_data_get(sd, sd_len);
+		if (!data) {
+			err = -ENOMEM;
+			goto error;
+		}
+
+		err = ble_gap_ext_adv_rsp_set_data(adv->instance, data);
+		if (err) {
+			BT_ERR("Failed setting scan response data: %d", err);
+			goto error;
+		}
 	}
 
-	adv.timestamp = k_uptime_get();
+	adv->timestamp = k_uptime_get();
 
-	err = ble_gap_ext_adv_start(BT_ID_DEFAULT, timeout, 0);
+	err = ble_gap_ext_adv_start(adv->instance, duration, max_events);
 	if (err) {
 		BT_ERR("Advertising failed: err %d", err);
-		atomic_clear_bit(adv.flags, ADV_FLAG_ACTIVE);
+		goto error;
 	}
 
-error:
-	if (ad_data) {
-		os_mbuf_free_chain(ad_data);
-	}
+	return 0;
 
-	if (sd_data) {
-		os_mbuf_free_chain(sd_data);
-	}
+error:
+	atomic_clear_bit(adv->flags, ADV_FLAG_ACTIVE);
 	return err;
 }
 
-static int buf_send(struct os_mbuf *buf)
+static int buf_send(struct bt_mesh_ext_adv *adv, struct os_mbuf *buf)
 {
 	static const uint8_t bt_mesh_adv_type[] = {
 		[BT_MESH_ADV_PROV]   = BLE_HS_ADV_TYPE_MESH_PROV,
@@ -202,39 +276,38 @@ static int buf_send(struct os_mbuf *buf)
 		[BT_MESH_ADV_URI]    = BLE_HS_ADV_TYPE_URI,
 	};
 
-	struct bt_le_ext_adv_start_param start = {
-		.num_events =
-			BT_MESH_TRANSMIT_COUNT(BT_MESH_ADV(buf)->xmit) + 1,
-	};
-	uint16_t duration, adv_int;
+	struct bt_mesh_adv_ext_stats *stats;
+	uint16_t num_events, duration, adv_int;
+	uint32_t wait;
 	struct bt_data ad;
 	int err;
 
+	num_events = BT_MESH_TRANSMIT_COUNT(BT_MESH_ADV(buf)->xmit) + 1;
 	adv_int = MAX(ADV_INT_FAST_MS,
 		      BT_MESH_TRANSMIT_INT(BT_MESH_ADV(buf)->xmit));
 	/* Upper boundary estimate: */
-	duration = start.num_events * (adv_int + 10);
+	duration = num_events * (adv_int + 10);
 
-	BT_DBG("type %u len %u: %s", BT_MESH_ADV(buf)->type,
-	       buf->om_len, bt_hex(buf->om_data, buf->om_len));
-	BT_DBG("count %u interval %ums duration %ums",
-	       BT_MESH_TRANSMIT_COUNT(BT_MESH_ADV(buf)->xmit) + 1, adv_int,
+	BT_DBG("set %u type %u len %u: %s", adv->instance,
+	       BT_MESH_ADV(buf)->type, buf->om_len,
+	       bt_hex(buf->om_data, buf->om_len));
+	BT_DBG("count %u interval %ums duration %ums", num_events, adv_int,
 	       duration);
 
 	ad.type = bt_mesh_adv_type[BT_MESH_ADV(buf)->type];
 	ad.data_len = buf->om_len;
 	ad.data = buf->om_data;
 
-	/* Only update advertising parameters if they're different */
-	if (adv_param.itvl_min != BT_MESH_ADV_SCAN_UNIT(adv_int)) {
-		adv_param.itvl_min = BT_MESH_ADV_SCAN_UNIT(adv_int);
-		adv_param.itvl_max = adv_param.itvl_min;
-		atomic_set_bit(adv.flags, ADV_FLAG_UPDATE_PARAMS);
-	}
-
-	err = adv_start(&adv_param, duration, &ad, 1, NULL, 0);
+	err = adv_start(adv, BT_MESH_ADV_SCAN_UNIT(adv_int), false, 0,
+			num_events, &ad, 1, NULL, 0);
 	if (!err) {
-		adv.buf = net_buf_ref(buf);
+		adv->buf = net_buf_ref(buf);
+
+		wait = k_uptime_get_32() - BT_MESH_ADV(buf)->queued;
+		stats = &adv_stats[BT_MESH_ADV(buf)->tag];
+		stats->tx++;
+		stats->wait_total += wait;
+		stats->wait_max = MAX(stats->wait_max, wait);
 	}
 
 	bt_mesh_adv_send_start(duration, err, BT_MESH_ADV(buf));
@@ -242,14 +315,13 @@ static int buf_send(struct os_mbuf *buf)
 	return err;
 }
 
-static void send_pending_adv(struct ble_npl_event *work)
+static bool send_from_queue(struct bt_mesh_ext_adv *adv,
+			    struct ble_npl_eventq *queue)
 {
 	struct os_mbuf *buf;
 	int err;
 
-	atomic_clear_bit(adv.flags, ADV_FLAG_SCHEDULED);
-
-	while ((buf = net_buf_get(&bt_mesh_adv_queue, K_NO_WAIT))) {
+	while ((buf = net_buf_get(queue, K_NO_WAIT))) {
 		/* busy == 0 means this was canceled */
 		if (!BT_MESH_ADV(buf)->busy) {
 			net_buf_unref(buf);
@@ -257,16 +329,37 @@ static void send_pending_adv(struct ble_npl_event *work)
 		}
 
 		BT_MESH_ADV(buf)->busy = 0U;
-		err = buf_send(buf);
+		err = buf_send(adv, buf);
 
 		net_buf_unref(buf);
 
 		if (!err) {
-			return; /* Wait for advertising to finish */
+			return true; /* Wait for advertising to finish */
 		}
 	}
 
-	if (!MYNEWT_VAL(BLE_MESH_GATT_SERVER)) {
+	return false;
+}
+
+static void send_pending_adv(struct ble_npl_event *work)
+{
+	struct bt_mesh_ext_adv *adv = ble_npl_event_get_arg(work);
+	int err = -ENOTSUP;
+
+	atomic_clear_bit(adv->flags, ADV_FLAG_SCHEDULED);
+
+	/* Local traffic always goes before relayed messages */
+	if ((adv->tags & ADV_TAG_LOCAL) &&
+	    send_from_queue(adv, &bt_mesh_adv_queue)) {
+		return;
+	}
+
+	if ((adv->tags & ADV_TAG_RELAY) &&
+	    send_from_queue(adv, &bt_mesh_relay_queue)) {
+		return;
+	}
+
+	if (!MYNEWT_VAL(BLE_MESH_GATT_SERVER) || !(adv->tags & ADV_TAG_PROXY)) {
 		return;
 	}
 
@@ -282,7 +375,7 @@ static void send_pending_adv(struct ble_npl_event *work)
 	}
 
 	if (!err) {
-		atomic_set_bit(adv.flags, ADV_FLAG_PROXY);
+		atomic_set_bit(adv->flags, ADV_FLAG_PROXY);
 	}
 }
 
@@ -290,17 +383,49 @@ void bt_mesh_adv_update(void)
 {
 	BT_DBG("");
 
-	schedule_send();
+	schedule_send(ADV_GATT);
 }
 
 void bt_mesh_adv_buf_ready(void)
 {
-	schedule_send();
+	schedule_send(ADV_MAIN);
+}
+
+void bt_mesh_adv_buf_relay_ready(void)
+{
+	int i;
+
+	for (i = 0; i < ADV_SET_RELAY_COUNT; i++) {
+		if (schedule_send(ADV_RELAY(i))) {
+			return;
+		}
+	}
+
+	/* All relay sets are busy (or there are none), message will be picked
+	 * up by the first set that completes.
+	 */
+	if (!ADV_SET_RELAY_COUNT) {
+		schedule_send(ADV_MAIN);
+	}
+}
+
+int bt_mesh_adv_ext_stats_get(enum bt_mesh_adv_tag tag,
+			      struct bt_mesh_adv_ext_stats *stats)
+{
+	if (tag >= BT_MESH_ADV_TAGS) {
+		return -EINVAL;
+	}
+
+	*stats = adv_stats[tag];
+
+	return 0;
 }
 
 void bt_mesh_adv_init(void)
 {
+    uint8_t instance;
     int rc;
+    int i;
 
     rc = os_mempool_init(&adv_buf_mempool, MYNEWT_VAL(BLE_MESH_ADV_BUF_COUNT),
                          BT_MESH_ADV_DATA_SIZE + BT_MESH_MBUF_HEADER_SIZE,
@@ -313,8 +438,42 @@ void bt_mesh_adv_init(void)
     assert(rc == 0);
 
     ble_npl_eventq_init(&bt_mesh_adv_queue);
+    ble_npl_eventq_init(&bt_mesh_relay_queue);
+
+	ADV_MAIN->tags |= ADV_TAG_LOCAL;
+	for (i = 0; i < ADV_SET_RELAY_COUNT; i++) {
+		ADV_RELAY(i)->tags |= ADV_TAG_RELAY;
+	}
 
-	k_work_init_delayable(&adv.work, send_pending_adv);
+	if (!ADV_SET_RELAY_COUNT) {
+		ADV_MAIN->tags |= ADV_TAG_RELAY;
+	}
+
+	ADV_GATT->tags |= ADV_TAG_PROXY;
+
+	/* Sets are placed on the highest instances, GATT advertising keeps
+	 * BT_MESH_ADV_GATT_INST as proxy server looks for it on connection.
+	 */
+	instance = BT_MESH_ADV_INST;
+	for (i = 0; i < ADV_SET_COUNT; i++) {
+#if MYNEWT_VAL(BLE_MESH_PROXY)
+		if (advs[i].tags & ADV_TAG_PROXY) {
+			advs[i].instance = BT_MESH_ADV_GATT_INST;
+			continue;
+		}
+
+		if (instance == BT_MESH_ADV_GATT_INST) {
+			instance--;
+		}
+#endif
+		advs[i].instance = instance--;
+	}
+
+	for (i = 0; i < ADV_SET_COUNT; i++) {
+		atomic_set_bit(advs[i].flags, ADV_FLAG_UPDATE_PARAMS);
+		k_work_init_delayable(&advs[i].work, send_pending_adv);
+		k_work_add_arg_delayable(&advs[i].work, &advs[i]);
+	}
 }
 
 int bt_mesh_adv_enable(void)
@@ -327,19 +486,16 @@ int bt_mesh_adv_start(const struct ble_gap_adv_params *param, int32_t duration,
 		      const struct bt_data *ad, size_t ad_len,
 		      const struct bt_data *sd, size_t sd_len)
 {
-	static uint32_t adv_timeout;
-	struct ble_gap_ext_adv_params params = {
-		.itvl_min = param->itvl_min,
-		.itvl_max = param->itvl_max
-	};
+	int adv_timeout;
 
-	/* In NimBLE duration is in ms, not 10ms units */
-	adv_timeout = (duration == BLE_HS_FOREVER) ? 0 : duration;
+	/* In NimBLE duration is in ms, extended advertising uses 10ms units */
+	adv_timeout = (duration == BLE_HS_FOREVER) ? 0 :
+		      (duration + 9) / 10;
 
 	BT_DBG("Start advertising %d ms", duration);
 
-	atomic_set_bit(adv.flags, ADV_FLAG_UPDATE_PARAMS);
-
-	return adv_start(&params, adv_timeout, ad, ad_len, sd, sd_len);
+	return adv_start(ADV_GATT, param->itvl_min,
+			 param->conn_mode != BLE_GAP_CONN_MODE_NON,
+			 adv_timeout, 0, ad, ad_len, sd, sd_len);
 }
 #endif
@@ -226,6 +226,8 @@ static void app_key_del(struct app_key *app)
 
 	app->net_idx = BT_MESH_KEY_UNUSED;
 	app->app_idx = BT_MESH_KEY_UNUSED;
+	bt_mesh_aes_key_cache_invalidate(app->keys[0].val);
+	bt_mesh_aes_key_cache_invalidate(app->keys[1].val);
 	(void)memset(app->keys, 0, sizeof(app->keys));
 }
 
@@ -235,6 +237,7 @@ static void app_key_revoke(struct app_key *app)
 		return;
 	}
 
+	bt_mesh_aes_key_cache_invalidate(app->keys[0].val);
 	memcpy(&app->keys[0], &app->keys[1], sizeof(app->keys[0]));
 	memset(&app->keys[1], 0, sizeof(app->keys[1]));
 	app->updated = false;
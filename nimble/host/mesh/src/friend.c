@@ -122,6 +122,8 @@ struct bt_mesh_friend *bt_mesh_friend_find(uint16_t net_idx, uint16_t lpn_addr,
 
 static int friend_cred_create(struct bt_mesh_friend *frnd, uint8_t idx)
 {
+	bt_mesh_net_cred_index_invalidate();
+
 	return bt_mesh_friend_cred_create(&frnd->cred[idx], frnd->lpn,
 					  bt_mesh_primary_addr(),
 					  frnd->lpn_counter, frnd->counter,
@@ -139,6 +141,106 @@ static void purge_buffers(struct net_buf_slist_t *list)
 	}
 }
 
+/* Key identifying Segment Acknowledgment in the Friend Queue, 0 for any other
+ * PDU. SeqZero is 13 bits, so bit 15 marks the key as valid.
+ */
+static uint32_t segack_key(uint16_t src, uint16_t seq_zero)
+{
+	return ((uint32_t)src << 16) | BIT(15) | (seq_zero & TRANS_SEQ_ZERO_MASK);
+}
+
+static uint32_t queue_ack_key(struct os_mbuf *buf)
+{
+	if (buf->om_len != 16 || !(buf->om_data[1] >> 7) ||
+	    TRANS_CTL_OP(&buf->om_data[9]) != TRANS_CTL_OP_ACK) {
+		return 0;
+	}
+
+	return segack_key(sys_get_be16(&buf->om_data[5]),
+			  sys_get_be16(&buf->om_data[10]) >> 2);
+}
+
+static uint16_t queue_free(struct bt_mesh_friend *frnd)
+{
+	return FRIEND_QUEUE_SIZE - frnd->queue.count;
+}
+
+static struct os_mbuf *queue_get(struct bt_mesh_friend *frnd)
+{
+	struct os_mbuf *buf;
+
+	if (!frnd->queue.count) {
+		return NULL;
+	}
+
+	buf = frnd->queue.buf[frnd->queue.head];
+	frnd->queue.buf[frnd->queue.head] = NULL;
+	frnd->queue.head = (frnd->queue.head + 1) % FRIEND_QUEUE_SIZE;
+	frnd->queue.count--;
+	frnd->queue_size--;
+
+	return buf;
+}
+
+/* Discards the oldest message, including all of its segments. */
+static bool queue_drop_oldest(struct bt_mesh_friend *frnd)
+{
+	struct os_mbuf *buf;
+	bool pending_segments;
+
+	do {
+		buf = queue_get(frnd);
+		if (!buf) {
+			return false;
+		}
+
+		frnd->queue_stats.dropped++;
+
+		pending_segments = (BT_MESH_ADV(buf)->flags & NET_BUF_FRAGS);
+		BT_DBG("PENDING SEGMENTS %d", pending_segments);
+
+		BT_MESH_ADV(buf)->flags &= ~NET_BUF_FRAGS;
+		net_buf_unref(buf);
+	} while (pending_segments);
+
+	return true;
+}
+
+static void queue_put(struct bt_mesh_friend *frnd, struct os_mbuf *buf)
+{
+	uint16_t idx;
+
+	/* The Friend Queue Size is the quota of each LPN, once it's reached
+	 * the oldest message makes room for the new one.
+	 */
+	if (!queue_free(frnd)) {
+		BT_WARN("Friend Queue of LPN 0x%04x full", frnd->lpn);
+		(void)queue_drop_oldest(frnd);
+	}
+
+	idx = (frnd->queue.head + frnd->queue.count) % FRIEND_QUEUE_SIZE;
+	frnd->queue.buf[idx] = buf;
+	frnd->queue.ack[idx] = queue_ack_key(buf);
+	frnd->queue.count++;
+
+	frnd->queue_size++;
+	frnd->queue_stats.enqueued++;
+	frnd->queue_stats.size_max = MAX(frnd->queue_stats.size_max,
+					 frnd->queue_size);
+}
+
+static void queue_purge(struct bt_mesh_friend *frnd)
+{
+	struct os_mbuf *buf;
+
+	while ((buf = queue_get(frnd))) {
+		BT_MESH_ADV(buf)->flags &= ~NET_BUF_FRAGS;
+		net_buf_unref(buf);
+	}
+
+	frnd->queue.head = 0U;
+}
+
 /* Intentionally start a little bit late into the ReceiveWindow when
  * it's large enough. This may improve reliability with some platforms,
  * like the PTS, where the receiver might not have sufficiently compensated
@@ -162,13 +264,14 @@ static void friend_clear(struct bt_mesh_friend *frnd)
 	(void)k_work_cancel_delayable(&frnd->timer);
 
 	memset(frnd->cred, 0, sizeof(frnd->cred));
+	bt_mesh_net_cred_index_invalidate();
 
 	if (frnd->last) {
 		net_buf_unref(frnd->last);
 		frnd->last = NULL;
 	}
 
-	purge_buffers(&frnd->queue);
+	queue_purge(frnd);
 
 	for (i = 0; i < ARRAY_SIZE(frnd->seg); i++) {
 		struct bt_mesh_friend_seg *seg = &frnd->seg[i];
@@ -183,6 +286,7 @@ static void friend_clear(struct bt_mesh_friend *frnd)
 	frnd->pending_buf = 0;
 	frnd->fsn = 0;
 	frnd->queue_size = 0;
+	memset(&frnd->queue_stats, 0, sizeof(frnd->queue_stats));
 	frnd->pending_req = 0;
 	memset(frnd->sub_list, 0, sizeof(frnd->sub_list));
 }
@@ -688,8 +792,7 @@ int bt_mesh_friend_sub_rem(struct bt_mesh_net_rx *rx,
 
 static void enqueue_buf(struct bt_mesh_friend *frnd, struct os_mbuf *buf)
 {
-	net_buf_slist_put(&frnd->queue, buf);
-	frnd->queue_size++;
+	queue_put(frnd, buf);
 }
 
 static void enqueue_update(struct bt_mesh_friend *frnd, uint8_t md)
@@ -751,7 +854,7 @@ int bt_mesh_friend_poll(struct bt_mesh_net_rx *rx, struct os_mbuf *buf)
 
 		frnd->fsn = msg->fsn;
 
-		if (net_buf_slist_is_empty(&frnd->queue)) {
+		if (!frnd->queue_size) {
 			enqueue_update(frnd, 0);
 			BT_DBG("Enqueued Friend Update to empty queue");
 		}
@@ -1059,23 +1162,11 @@ init_friend:
 
 static bool is_seg(struct bt_mesh_friend_seg *seg, uint16_t src, uint16_t seq_zero)
 {
-	struct os_mbuf *buf = (void *)net_buf_slist_peek_head(&seg->queue);
-	struct net_buf_simple_state state;
-	uint16_t buf_seq_zero;
-	uint16_t buf_src;
-
-	if (!buf) {
+	if (net_buf_slist_is_empty(&seg->queue)) {
 		return false;
 	}
 
-	net_buf_simple_save(buf, &state);
-	net_buf_skip(buf, 5);   /* skip IVI, NID, CTL, TTL, SEQ */
-	buf_src = net_buf_pull_be16(buf);
-	net_buf_skip(buf, 3);   /* skip DST, OP/AID */
-	buf_seq_zero = ((net_buf_pull_be16(buf) >> 2) & TRANS_SEQ_ZERO_MASK);
-	net_buf_simple_restore(buf, &state);
-
-	return ((src == buf_src) && (seq_zero == buf_seq_zero));
+	return ((src == seg->src) && (seq_zero == seg->seq_zero));
 }
 
 static struct bt_mesh_friend_seg *get_seg(struct bt_mesh_friend *frnd,
@@ -1098,6 +1189,8 @@ static struct bt_mesh_friend_seg *get_seg(struct bt_mesh_friend *frnd,
 	}
 
 	if (unassigned) {
+		unassigned->src = src;
+		unassigned->seq_zero = seq_zero;
 		unassigned->seg_count = seg_count;
 	}
 
@@ -1130,9 +1223,10 @@ static void enqueue_friend_pdu(struct bt_mesh_friend *frnd,
 	net_buf_slist_put(&seg->queue, buf);
 
 	if (type == BT_MESH_FRIEND_PDU_COMPLETE) {
-		net_buf_slist_merge_slist(&frnd->queue, &seg->queue);
+		while ((buf = net_buf_slist_get(&seg->queue))) {
+			queue_put(frnd, buf);
+		}
 
-		frnd->queue_size += seg->seg_count;
 		seg->seg_count = 0U;
 	} else {
 		/* Mark the buffer as having more to come after it */
@@ -1241,7 +1335,7 @@ static void friend_timeout(struct ble_npl_event *work)
 		return;
 	}
 
-	frnd->last = (void *)net_buf_slist_get(&frnd->queue);
+	frnd->last = queue_get(frnd);
 	if (!frnd->last) {
 		BT_WARN("Friendship not established with 0x%04x",
 			frnd->lpn);
@@ -1249,7 +1343,7 @@ static void friend_timeout(struct ble_npl_event *work)
 		return;
 	}
 
-	md = (uint8_t)(net_buf_slist_peek_head(&frnd->queue) != NULL);
+	md = (uint8_t)(frnd->queue_size != 0);
 
 	update_overwrite(frnd->last, md);
 
@@ -1263,7 +1357,6 @@ static void friend_timeout(struct ble_npl_event *work)
 
 	BT_DBG("Sending buf %p from Friend Queue of LPN 0x%04x",
 	       frnd->last, frnd->lpn);
-	frnd->queue_size--;
 
 send_last:
 	buf = bt_mesh_adv_create(BT_MESH_ADV_DATA, FRIEND_XMIT, K_NO_WAIT);
@@ -1316,6 +1409,7 @@ static void subnet_evt(struct bt_mesh_subnet *sub, enum bt_mesh_key_evt evt)
 			memcpy(&frnd->cred[0], &frnd->cred[1],
 			       sizeof(frnd->cred[0]));
 			memset(&frnd->cred[1], 0, sizeof(frnd->cred[1]));
+			bt_mesh_net_cred_index_invalidate();
 			enqueue_update(frnd, 0);
 			break;
 		default:
@@ -1346,8 +1440,6 @@ int bt_mesh_friend_init(void)
 		struct bt_mesh_friend *frnd = &bt_mesh.frnd[i];
 		int j;
 
-		net_buf_slist_init(&frnd->queue);
-
 		k_work_init_delayable(&frnd->timer, friend_timeout);
 		k_work_add_arg_delayable(&frnd->timer, frnd);
 		k_work_init_delayable(&frnd->clear.timer, clear_timeout);
@@ -1361,63 +1453,38 @@ int bt_mesh_friend_init(void)
 	return 0;
 }
 
-static bool is_segack(struct os_mbuf *buf, uint64_t *seqauth, uint16_t src)
-{
-	struct net_buf_simple_state state;
-	bool found = false;
-
-	if (buf->om_len != 16) {
-		return false;
-	}
-
-	net_buf_simple_save(buf, &state);
-
-	net_buf_skip(buf, 1); /* skip IVI, NID */
-
-	if (!(net_buf_pull_u8(buf) >> 7)) {
-		goto end;
-	}
-
-	net_buf_pull(buf, 3); /* skip SEQNUM */
-
-	if (src != net_buf_pull_be16(buf)) {
-		goto end;
-	}
-
-	net_buf_skip(buf, 2); /* skip dst */
-
-	if (TRANS_CTL_OP((uint8_t *) net_buf_pull_mem(buf, 1)) != TRANS_CTL_OP_ACK) {
-		goto end;
-	}
-
-	found = ((net_buf_pull_be16(buf) >> 2) & TRANS_SEQ_ZERO_MASK) ==
-		(*seqauth & TRANS_SEQ_ZERO_MASK);
-end:
-	net_buf_simple_restore(buf, &state);
-	return found;
-}
-
 static void friend_purge_old_ack(struct bt_mesh_friend *frnd, uint64_t *seq_auth,
 				 uint16_t src)
 {
-	struct os_mbuf *cur, *prev = NULL;
+	uint32_t key = segack_key(src, *seq_auth & TRANS_SEQ_ZERO_MASK);
+	uint16_t idx, next;
+	int i;
 
 	BT_DBG("SeqAuth %llx src 0x%04x", *seq_auth, src);
 
-	for (cur = net_buf_slist_peek_head(&frnd->queue);
-	     cur != NULL; prev = cur, cur = net_buf_slist_peek_next(cur)) {
-		struct os_mbuf *buf = (void *)cur;
+	for (i = 0; i < frnd->queue.count; i++) {
+		idx = (frnd->queue.head + i) % FRIEND_QUEUE_SIZE;
 
-		if (is_segack(buf, seq_auth, src)) {
-			BT_DBG("Removing old ack from Friend Queue");
+		if (frnd->queue.ack[idx] != key) {
+			continue;
+		}
 
-			net_buf_slist_remove(&frnd->queue, prev, cur);
-			frnd->queue_size--;
-			/* Make sure old slist entry state doesn't remain */
-			BT_MESH_ADV(buf)->frags = NULL;
-			net_buf_unref(buf);
-			break;
+		BT_DBG("Removing old ack from Friend Queue");
+
+		net_buf_unref(frnd->queue.buf[idx]);
+
+		/* Close up the gap so that free space is not lost */
+		for (i++; i < frnd->queue.count; i++) {
+			next = (idx + 1) % FRIEND_QUEUE_SIZE;
+			frnd->queue.buf[idx] = frnd->queue.buf[next];
+			frnd->queue.ack[idx] = frnd->queue.ack[next];
+			idx = next;
 		}
+
+		frnd->queue.buf[idx] = NULL;
+		frnd->queue.count--;
+		frnd->queue_size--;
+		break;
 	}
 }
 
@@ -1630,35 +1697,15 @@ bool bt_mesh_friend_queue_has_space(uint16_t net_idx, uint16_t src, uint16_t dst
 static bool friend_queue_prepare_space(struct bt_mesh_friend *frnd, uint16_t addr,
 				       uint64_t *seq_auth, uint8_t seg_count)
 {
-	bool pending_segments;
-	uint8_t avail_space;
-
 	if (!friend_queue_has_space(frnd, addr, seq_auth, seg_count)) {
 		return false;
 	}
 
-	avail_space = CONFIG_BT_MESH_FRIEND_QUEUE_SIZE - frnd->queue_size;
-	pending_segments = false;
-
-	while (pending_segments || avail_space < seg_count) {
-		struct os_mbuf *buf = (void *)net_buf_slist_get(&frnd->queue);
-
-		if (!buf) {
+	while (queue_free(frnd) < seg_count) {
+		if (!queue_drop_oldest(frnd)) {
 			BT_ERR("Unable to free up enough buffers");
 			return false;
 		}
-
-		frnd->queue_size--;
-		avail_space++;
-
-		pending_segments = (BT_MESH_ADV(buf)->flags & NET_BUF_FRAGS);
-		BT_DBG("PENDING SEGMENTS %d", pending_segments);
-
-		/* Make sure old slist entry state doesn't remain */
-		BT_MESH_ADV(buf)->frags = NULL;
-		BT_MESH_ADV(buf)->flags &= ~NET_BUF_FRAGS;
-
-		net_buf_unref(buf);
 	}
 
 	return true;
@@ -1746,6 +1793,22 @@ bool bt_mesh_friend_enqueue_tx(struct bt_mesh_net_tx *tx,
 	return matched;
 }
 
+int bt_mesh_friend_queue_stats_get(uint16_t lpn_addr,
+				   struct bt_mesh_friend_queue_stats *stats)
+{
+	struct bt_mesh_friend *frnd;
+
+	frnd = bt_mesh_friend_find(BT_MESH_KEY_ANY, lpn_addr, true, false);
+	if (!frnd) {
+		return -ENOENT;
+	}
+
+	*stats = frnd->queue_stats;
+	stats->size = frnd->queue_size;
+
+	return 0;
+}
+
 int bt_mesh_friend_terminate(uint16_t lpn_addr)
 {
 	struct bt_mesh_friend *frnd;
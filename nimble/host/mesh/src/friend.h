@@ -53,4 +53,14 @@ int bt_mesh_friend_sub_rem(struct bt_mesh_net_rx *rx,
 
 int bt_mesh_friend_init(void);
 
+/** @brief Get Friend Queue statistics of the given LPN.
+ *
+ *  @param lpn_addr Primary address of the LPN.
+ *  @param stats    Statistics output.
+ *
+ *  @return 0 on success, or (negative) error code on failure.
+ */
+int bt_mesh_friend_queue_stats_get(uint16_t lpn_addr,
+				   struct bt_mesh_friend_queue_stats *stats);
+
 #endif
@@ -127,6 +127,178 @@ void net_buf_simple_clone(const struct os_mbuf *original,
 }
 
 
+#if MYNEWT_VAL(BLE_MESH_AES_KEY_CACHE_SIZE) > 0
+/*
+ * Cache of expanded AES keys. CCM encrypts several blocks with the same key
+ * and relays/friends process every PDU with the same few network keys, so
+ * key expansion is done once per key instead of once per block.
+ *
+ * Cache is used from both host and mesh advertising tasks so it is only
+ * accessed inside critical section, and schedule is copied out to caller.
+ * Key expansion on miss is done outside of critical section.
+ */
+struct aes_key_cache_entry {
+    struct tc_aes_key_sched_struct sched;
+    uint8_t key[16];
+    uint32_t used;
+    bool valid;
+};
+
+static struct aes_key_cache_entry
+    aes_key_cache[MYNEWT_VAL(BLE_MESH_AES_KEY_CACHE_SIZE)];
+static struct aes_key_cache_entry *aes_key_cache_last;
+static uint32_t aes_key_cache_tick;
+
+static struct aes_key_cache_entry *
+aes_key_cache_find(const uint8_t *key)
+{
+    struct aes_key_cache_entry *entry;
+    int i;
+
+    /* Most likely hit during CCM, check it first */
+    entry = aes_key_cache_last;
+    if (entry && entry->valid && !memcmp(entry->key, key, 16)) {
+        return entry;
+    }
+
+    for (i = 0; i < ARRAY_SIZE(aes_key_cache); i++) {
+        entry = &aes_key_cache[i];
+
+        if (entry->valid && !memcmp(entry->key, key, 16)) {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+static struct aes_key_cache_entry *
+aes_key_cache_lru(void)
+{
+    struct aes_key_cache_entry *entry;
+    struct aes_key_cache_entry *lru;
+    int i;
+
+    lru = &aes_key_cache[0];
+    for (i = 0; i < ARRAY_SIZE(aes_key_cache); i++) {
+        entry = &aes_key_cache[i];
+
+        if (!entry->valid) {
+            return entry;
+        }
+
+        if ((int32_t)(entry->used - lru->used) < 0) {
+            lru = entry;
+        }
+    }
+
+    return lru;
+}
+
+static int
+aes_key_sched_get(const uint8_t *key, struct tc_aes_key_sched_struct *sched)
+{
+    struct aes_key_cache_entry *entry;
+    uint32_t sr;
+
+    sr = ble_npl_hw_enter_critical();
+
+    entry = aes_key_cache_find(key);
+    if (entry) {
+        entry->used = ++aes_key_cache_tick;
+        aes_key_cache_last = entry;
+        memcpy(sched, &entry->sched, sizeof(*sched));
+        ble_npl_hw_exit_critical(sr);
+        return 0;
+    }
+
+    ble_npl_hw_exit_critical(sr);
+
+    if (tc_aes128_set_encrypt_key(sched, key) == TC_CRYPTO_FAIL) {
+        return BLE_HS_EUNKNOWN;
+    }
+
+    sr = ble_npl_hw_enter_critical();
+
+    /* Other task could have added same key in the meantime */
+    entry = aes_key_cache_find(key);
+    if (!entry) {
+        entry = aes_key_cache_lru();
+        memcpy(&entry->sched, sched, sizeof(*sched));
+        memcpy(entry->key, key, 16);
+        entry->valid = true;
+    }
+
+    entry->used = ++aes_key_cache_tick;
+    aes_key_cache_last = entry;
+
+    ble_npl_hw_exit_critical(sr);
+
+    return 0;
+}
+
+void
+bt_mesh_aes_key_cache_invalidate(const uint8_t key[16])
+{
+    struct aes_key_cache_entry *entry;
+    uint32_t sr;
+
+    sr = ble_npl_hw_enter_critical();
+
+    entry = aes_key_cache_find(key);
+    if (entry) {
+        memset(entry, 0, sizeof(*entry));
+        if (aes_key_cache_last == entry) {
+            aes_key_cache_last = NULL;
+        }
+    }
+
+    ble_npl_hw_exit_critical(sr);
+}
+
+void
+bt_mesh_aes_key_cache_clear(void)
+{
+    uint32_t sr;
+
+    sr = ble_npl_hw_enter_critical();
+    memset(aes_key_cache, 0, sizeof(aes_key_cache));
+    aes_key_cache_last = NULL;
+    ble_npl_hw_exit_critical(sr);
+}
+
+int
+bt_encrypt_be(const uint8_t *key, const uint8_t *plaintext, uint8_t *enc_data)
+{
+    struct tc_aes_key_sched_struct s;
+    int rc;
+
+    rc = aes_key_sched_get(key, &s);
+    if (rc) {
+        return rc;
+    }
+
+#if MYNEWT_VAL(BLE_MESH_AES_TTABLE)
+    bt_mesh_aes_ttable_encrypt(s.words, plaintext, enc_data);
+#else
+    if (tc_aes_encrypt(enc_data, plaintext, &s) == TC_CRYPTO_FAIL) {
+        return BLE_HS_EUNKNOWN;
+    }
+#endif
+
+    return 0;
+}
+#else
+void
+bt_mesh_aes_key_cache_invalidate(const uint8_t key[16])
+{
+}
+
+void
+bt_mesh_aes_key_cache_clear(void)
+{
+}
+
 int
 bt_encrypt_be(const uint8_t *key, const uint8_t *plaintext, uint8_t *enc_data)
 {
@@ -136,12 +308,17 @@ bt_encrypt_be(const uint8_t *key, const uint8_t *plaintext, uint8_t *enc_data)
         return BLE_HS_EUNKNOWN;
     }
 
+#if MYNEWT_VAL(BLE_MESH_AES_TTABLE)
+    bt_mesh_aes_ttable_encrypt(s.words, plaintext, enc_data);
+#else
     if (tc_aes_encrypt(enc_data, plaintext, &s) == TC_CRYPTO_FAIL) {
         return BLE_HS_EUNKNOWN;
     }
+#endif
 
     return 0;
 }
+#endif
 
 uint16_t
 net_buf_simple_pull_le16(struct os_mbuf *om)
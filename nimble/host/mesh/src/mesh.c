@@ -164,6 +164,7 @@ void bt_mesh_reset(void)
 	bt_mesh_trans_reset();
 	bt_mesh_app_keys_reset();
 	bt_mesh_net_keys_reset();
+	bt_mesh_aes_key_cache_clear();
 
 	bt_mesh_net_loopback_clear(BT_MESH_KEY_ANY);
 
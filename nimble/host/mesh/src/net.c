@@ -76,11 +76,42 @@ struct iv_val {
 	iv_duration:7;
 } __packed;
 
-static struct {
-	uint32_t src : 15, /* MSb of source is always 0 */
-	      seq : 17;
-} msg_cache[MYNEWT_VAL(BLE_MESH_MSG_CACHE_SIZE)];
-static uint16_t msg_cache_next;
+#define MSG_CACHE_SIZE MYNEWT_VAL(BLE_MESH_MSG_CACHE_SIZE)
+
+#if MSG_CACHE_SIZE < 1 || MSG_CACHE_SIZE > 2048
+#error "BLE_MESH_MSG_CACHE_SIZE must be in range 1..2048"
+#endif
+
+/* Hash index is kept at most half full so that probe sequences stay short */
+#define MSG_CACHE_HASH_SIZE (MSG_CACHE_SIZE <= 8 ? 16 :    \
+			     MSG_CACHE_SIZE <= 16 ? 32 :   \
+			     MSG_CACHE_SIZE <= 32 ? 64 :   \
+			     MSG_CACHE_SIZE <= 64 ? 128 :  \
+			     MSG_CACHE_SIZE <= 128 ? 256 : \
+			     MSG_CACHE_SIZE <= 256 ? 512 : \
+			     MSG_CACHE_SIZE <= 512 ? 1024 : \
+			     MSG_CACHE_SIZE <= 1024 ? 2048 : 4096)
+
+/* Network message cache with FIFO eviction. Entries are stored in insertion
+ * order in keys[] and indexed by open-addressed hash table (linear probing,
+ * backward shift deletion) which holds entry index + 1, 0 meaning empty slot.
+ * Keys are not required to be unique: re-adding key makes index point to the
+ * newest entry and the older one is dropped silently when it is overwritten.
+ */
+struct net_cache {
+	uint32_t *keys;
+	uint16_t *hash;
+	uint16_t next;
+	uint32_t hit;
+	uint32_t evict;
+};
+
+static uint32_t msg_cache_keys[MSG_CACHE_SIZE];
+static uint16_t msg_cache_hash[MSG_CACHE_HASH_SIZE];
+static struct net_cache msg_cache = {
+	.keys = msg_cache_keys,
+	.hash = msg_cache_hash,
+};
 
 /* Singleton network context (the implementation only supports one) */
 struct bt_mesh_net bt_mesh = {
@@ -102,50 +133,154 @@ os_membuf_t loopback_mbuf_membuf[
 		OS_MEMPOOL_SIZE(LOOPBACK_MAX_PDU_LEN + BT_MESH_MBUF_HEADER_SIZE,
         MYNEWT_VAL(BLE_MESH_LOOPBACK_BUFS))];
 
-static uint32_t dup_cache[MYNEWT_VAL(BLE_MESH_MSG_CACHE_SIZE)];
-static int   dup_cache_next;
+static uint32_t dup_cache_keys[MSG_CACHE_SIZE];
+static uint16_t dup_cache_hash[MSG_CACHE_HASH_SIZE];
+static struct net_cache dup_cache = {
+	.keys = dup_cache_keys,
+	.hash = dup_cache_hash,
+};
 
-static bool check_dup(struct os_mbuf *data)
+static inline uint16_t net_cache_hash(uint32_t key)
 {
-	const uint8_t *tail = net_buf_simple_tail(data);
-	uint32_t val;
-	int i;
+	key *= 0x9e3779b1;
 
-	val = sys_get_be32(tail - 4) ^ sys_get_be32(tail - 8);
+	return (key ^ (key >> 16)) & (MSG_CACHE_HASH_SIZE - 1);
+}
 
-	for (i = 0; i < ARRAY_SIZE(dup_cache); i++) {
-		if (dup_cache[i] == val) {
-			return true;
-		}
+/* Returns hash table position referring to entry with given key or to empty
+ * slot terminating probe sequence.
+ */
+static uint16_t net_cache_find(const struct net_cache *cache, uint32_t key)
+{
+	uint16_t pos = net_cache_hash(key);
+
+	while (cache->hash[pos] &&
+	       cache->keys[cache->hash[pos] - 1] != key) {
+		pos = (pos + 1) & (MSG_CACHE_HASH_SIZE - 1);
 	}
 
-	dup_cache[dup_cache_next++] = val;
-	dup_cache_next %= ARRAY_SIZE(dup_cache);
+	return pos;
+}
+
+static bool net_cache_lookup(struct net_cache *cache, uint32_t key)
+{
+	if (cache->hash[net_cache_find(cache, key)]) {
+		cache->hit++;
+		return true;
+	}
 
 	return false;
 }
 
-static bool msg_cache_match(struct os_mbuf *pdu)
+/* Removes entry from hash index, entry itself is left in FIFO */
+static bool net_cache_unlink(struct net_cache *cache, uint16_t idx)
 {
-	uint16_t i;
+	uint16_t pos = net_cache_find(cache, cache->keys[idx]);
+	uint16_t next;
+	uint16_t home;
+
+	if (cache->hash[pos] != idx + 1) {
+		/* Never added or already replaced by newer entry */
+		return false;
+	}
+
+	/* Shift back following entries of the cluster which would otherwise be
+	 * unreachable once this slot becomes empty.
+	 */
+	next = pos;
+	for (;;) {
+		next = (next + 1) & (MSG_CACHE_HASH_SIZE - 1);
+		if (!cache->hash[next]) {
+			break;
+		}
 
-	for (i = 0; i < ARRAY_SIZE(msg_cache); i++) {
-		if (msg_cache[i].src == SRC(pdu->om_data) &&
-		    msg_cache[i].seq == (SEQ(pdu->om_data) & BIT_MASK(17))) {
-			return true;
+		home = net_cache_hash(cache->keys[cache->hash[next] - 1]);
+		if (((next - home) & (MSG_CACHE_HASH_SIZE - 1)) >=
+		    ((next - pos) & (MSG_CACHE_HASH_SIZE - 1))) {
+			cache->hash[pos] = cache->hash[next];
+			pos = next;
 		}
 	}
 
+	cache->hash[pos] = 0U;
+
+	return true;
+}
+
+static uint16_t net_cache_add(struct net_cache *cache, uint32_t key)
+{
+	uint16_t idx = cache->next;
+	uint16_t pos;
+
+	if (net_cache_unlink(cache, idx)) {
+		cache->evict++;
+	}
+
+	cache->keys[idx] = key;
+	pos = net_cache_find(cache, key);
+	cache->hash[pos] = idx + 1;
+
+	cache->next = (idx + 1) % MSG_CACHE_SIZE;
+
+	return idx;
+}
+
+static void net_cache_reset(struct net_cache *cache)
+{
+	(void)memset(cache->keys, 0, MSG_CACHE_SIZE * sizeof(cache->keys[0]));
+	(void)memset(cache->hash, 0,
+		     MSG_CACHE_HASH_SIZE * sizeof(cache->hash[0]));
+	cache->next = 0U;
+}
+
+static inline uint32_t msg_cache_key(uint16_t src, uint32_t seq)
+{
+	/* MSb of source is always 0 */
+	return ((uint32_t)(src & BIT_MASK(15)) << 17) | (seq & BIT_MASK(17));
+}
+
+static bool check_dup(struct os_mbuf *data)
+{
+	const uint8_t *tail = net_buf_simple_tail(data);
+	uint32_t val;
+
+	val = sys_get_be32(tail - 4) ^ sys_get_be32(tail - 8);
+
+	if (net_cache_lookup(&dup_cache, val)) {
+		return true;
+	}
+
+	net_cache_add(&dup_cache, val);
+
 	return false;
 }
 
+static bool msg_cache_match(struct os_mbuf *pdu)
+{
+	return net_cache_lookup(&msg_cache, msg_cache_key(SRC(pdu->om_data),
+							  SEQ(pdu->om_data)));
+}
+
 static void msg_cache_add(struct bt_mesh_net_rx *rx)
 {
 	/* Add to the cache */
-	rx->msg_cache_idx = msg_cache_next++;
-	msg_cache[rx->msg_cache_idx].src = rx->ctx.addr;
-	msg_cache[rx->msg_cache_idx].seq = rx->seq;
-	msg_cache_next %= ARRAY_SIZE(msg_cache);
+	rx->msg_cache_idx = net_cache_add(&msg_cache,
+					  msg_cache_key(rx->ctx.addr, rx->seq));
+}
+
+static void msg_cache_remove(uint16_t idx)
+{
+	net_cache_unlink(&msg_cache, idx);
+	/* Rewind the next index now that we're not using this entry */
+	msg_cache.next = idx;
+}
+
+void bt_mesh_net_cache_stats_get(struct bt_mesh_net_cache_stats *stats)
+{
+	stats->msg_cache_hit = msg_cache.hit;
+	stats->msg_cache_evict = msg_cache.evict;
+	stats->dup_cache_hit = dup_cache.hit;
+	stats->dup_cache_evict = dup_cache.evict;
 }
 
 static void store_iv(bool only_duration)
@@ -192,8 +327,7 @@ int bt_mesh_net_create(uint16_t idx, uint8_t flags, const uint8_t key[16],
 		return err;
 	}
 
-	(void)memset(msg_cache, 0, sizeof(msg_cache));
-	msg_cache_next = 0U;
+	net_cache_reset(&msg_cache);
 
 	bt_mesh.iv_index = iv_index;
 	atomic_set_bit_to(bt_mesh.flags, BT_MESH_IVU_IN_PROGRESS,
@@ -660,8 +794,10 @@ static void bt_mesh_net_relay(struct os_mbuf *sbuf,
 	const struct bt_mesh_net_cred *cred;
 	struct os_mbuf *buf;
 	uint8_t transmit;
+	bool to_adv;
 
 	if (rx->ctx.recv_ttl <= 1U) {
+		rx->sub->relay_stats.drop_ttl++;
 		return;
 	}
 
@@ -675,6 +811,18 @@ static void bt_mesh_net_relay(struct os_mbuf *sbuf,
 	BT_DBG("TTL %u CTL %u dst 0x%04x", rx->ctx.recv_ttl, rx->ctl,
 	       rx->ctx.recv_dst);
 
+	/* Don't spend buffer and re-encryption on PDU which would not be sent
+	 * on any bearer, e.g. Relay disabled and no Proxy Client interested.
+	 */
+	to_adv = relay_to_adv(rx->net_if) || rx->friend_cred;
+	if (!to_adv &&
+	    (!IS_ENABLED(CONFIG_BT_MESH_GATT_PROXY) ||
+	     !(rx->friend_cred ||
+	       bt_mesh_gatt_proxy_get() == BT_MESH_GATT_PROXY_ENABLED) ||
+	     !bt_mesh_proxy_relay_match(rx->ctx.recv_dst))) {
+		return;
+	}
+
 	/* The Relay Retransmit state is only applied to adv-adv relaying.
 	 * Anything else (like GATT to adv, or locally originated packets)
 	 * use the Network Transmit state.
@@ -688,9 +836,12 @@ static void bt_mesh_net_relay(struct os_mbuf *sbuf,
 	buf = bt_mesh_adv_create(BT_MESH_ADV_DATA, transmit, K_NO_WAIT);
 	if (!buf) {
 		BT_ERR("Out of relay buffers");
+		rx->sub->relay_stats.drop_nobuf++;
 		return;
 	}
 
+	BT_MESH_ADV(buf)->tag = BT_MESH_RELAY_ADV;
+
 	/* Leave CTL bit intact */
 	sbuf->om_data[1] &= 0x80;
 	sbuf->om_data[1] |= rx->ctx.recv_ttl - 1U;
@@ -713,9 +864,13 @@ static void bt_mesh_net_relay(struct os_mbuf *sbuf,
 	 */
 	if (net_encrypt(buf, cred, BT_MESH_NET_IVI_RX(rx), false)) {
 		BT_ERR("Re-encrypting failed");
+		rx->sub->relay_stats.drop_enc++;
 		goto done;
 	}
 
+	rx->sub->relay_stats.tx++;
+	rx->sub->relay_stats.tx_bytes += buf->om_len;
+
 	BT_DBG("encoded %u bytes: %s", buf->om_len,
 	       bt_hex(buf->om_data, buf->om_len));
 
@@ -729,7 +884,7 @@ static void bt_mesh_net_relay(struct os_mbuf *sbuf,
 		bt_mesh_proxy_relay(buf, rx->ctx.recv_dst);
 	}
 
-	if (relay_to_adv(rx->net_if) || rx->friend_cred) {
+	if (to_adv) {
 		bt_mesh_adv_send(buf, NULL, NULL);
 	}
 
@@ -855,9 +1010,7 @@ void bt_mesh_net_recv(struct os_mbuf *data, int8_t rssi,
 	 */
 	if (bt_mesh_trans_recv(buf, &rx) == -EAGAIN) {
 		BT_WARN("Removing rejected message from Network Message Cache");
-		msg_cache[rx.msg_cache_idx].src = BT_MESH_ADDR_UNASSIGNED;
-		/* Rewind the next index now that we're not using this entry */
-		msg_cache_next = rx.msg_cache_idx;
+		msg_cache_remove(rx.msg_cache_idx);
 	}
 
 	/* Relay if this was a group/virtual address, or if the destination
@@ -50,11 +50,24 @@ struct bt_mesh_node {
 #if MYNEWT_VAL(BLE_MESH_FRIEND)
 #define FRIEND_SEG_RX MYNEWT_VAL(BLE_MESH_FRIEND_SEG_RX)
 #define FRIEND_SUB_LIST_SIZE MYNEWT_VAL(BLE_MESH_FRIEND_SUB_LIST_SIZE)
+#define FRIEND_QUEUE_SIZE MYNEWT_VAL(BLE_MESH_FRIEND_QUEUE_SIZE)
 #else
 #define FRIEND_SEG_RX 0
 #define FRIEND_SUB_LIST_SIZE 0
+#define FRIEND_QUEUE_SIZE 0
 #endif
 
+struct bt_mesh_friend_queue_stats {
+	/** Number of PDUs currently in the Friend Queue */
+	uint32_t size;
+	/** Highest number of PDUs seen in the Friend Queue */
+	uint32_t size_max;
+	/** Number of PDUs added to the Friend Queue */
+	uint32_t enqueued;
+	/** Number of PDUs discarded to make room for newer ones */
+	uint32_t dropped;
+};
+
 struct bt_mesh_friend {
 	uint16_t lpn;
 	uint8_t  recv_delay;
@@ -79,6 +92,12 @@ struct bt_mesh_friend {
 	struct bt_mesh_friend_seg {
 		struct net_buf_slist_t queue;
 
+		/* Source and SeqZero of the message being collected, valid
+		 * while queue is not empty.
+		 */
+		uint16_t       src;
+		uint16_t       seq_zero;
+
 		/* The target number of segments, i.e. not necessarily
 		 * the current number of segments, in the queue. This is
 		 * used for Friend Queue free space calculations.
@@ -88,9 +107,21 @@ struct bt_mesh_friend {
 
 	struct os_mbuf *last;
 
-	struct net_buf_slist_t queue;
+	/* Friend Queue, ring of PDUs waiting to be polled by the LPN. PDUs
+	 * removed from the middle of the queue are closed up, so there are
+	 * no empty slots. For Segment Acknowledgments the ack array holds
+	 * the key used to find and replace them.
+	 */
+	struct {
+		struct os_mbuf *buf[FRIEND_QUEUE_SIZE];
+		uint32_t ack[FRIEND_QUEUE_SIZE];
+		uint16_t head;
+		uint16_t count;
+	} queue;
 	uint32_t queue_size;
 
+	struct bt_mesh_friend_queue_stats queue_stats;
+
 	/* Friend Clear Procedure */
 	struct {
 		uint32_t start;                  /* Clear Procedure start */
@@ -260,6 +291,14 @@ struct bt_mesh_net_tx {
 	      aid:6;
 };
 
+/* Network message and duplicate cache counters */
+struct bt_mesh_net_cache_stats {
+	uint32_t msg_cache_hit;   /* Decrypted PDUs found in message cache */
+	uint32_t msg_cache_evict; /* Message cache entries overwritten */
+	uint32_t dup_cache_hit;   /* Encrypted PDUs found in duplicate cache */
+	uint32_t dup_cache_evict; /* Duplicate cache entries overwritten */
+};
+
 extern struct bt_mesh_net bt_mesh;
 
 #define BT_MESH_NET_IVI_TX (bt_mesh.iv_index - \
@@ -298,6 +337,8 @@ void bt_mesh_net_recv(struct os_mbuf *data, int8_t rssi,
 
 void bt_mesh_net_loopback_clear(uint16_t net_idx);
 
+void bt_mesh_net_cache_stats_get(struct bt_mesh_net_cache_stats *stats);
+
 uint32_t bt_mesh_next_seq(void);
 
 void bt_mesh_net_init(void);
@@ -43,6 +43,8 @@ void bt_mesh_proxy_identity_start(struct bt_mesh_subnet *sub);
 void bt_mesh_proxy_identity_stop(struct bt_mesh_subnet *sub);
 
 bool bt_mesh_proxy_relay(struct os_mbuf *buf, uint16_t dst);
+/* Whether any connected Proxy Client would accept PDU sent to dst */
+bool bt_mesh_proxy_relay_match(uint16_t dst);
 void bt_mesh_proxy_addr_add(struct os_mbuf *buf, uint16_t addr);
 
 int ble_mesh_proxy_gap_event(struct ble_gap_event *event, void *arg);
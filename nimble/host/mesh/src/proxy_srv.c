@@ -769,6 +769,19 @@ static bool client_filter_match(struct bt_mesh_proxy_client *client,
 	return false;
 }
 
+bool bt_mesh_proxy_relay_match(uint16_t dst)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(clients); i++) {
+		if (clients[i].cli && client_filter_match(&clients[i], dst)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
 bool bt_mesh_proxy_relay(struct os_mbuf *buf, uint16_t dst)
 {
 	const struct bt_mesh_send_cb *cb = BT_MESH_ADV(buf)->cb;
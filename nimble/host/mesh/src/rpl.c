@@ -24,14 +24,139 @@ struct rpl_val {
 	old_iv:1;
 };
 
-static struct bt_mesh_rpl replay_list[MYNEWT_VAL(BLE_MESH_CRPL)];
-static ATOMIC_DEFINE(store, MYNEWT_VAL(BLE_MESH_CRPL));
+#define RPL_SIZE MYNEWT_VAL(BLE_MESH_CRPL)
+
+#if RPL_SIZE < 1 || RPL_SIZE > 2048
+#error "BLE_MESH_CRPL must be in range 1..2048"
+#endif
+
+/* Hash index is kept at most half full so that probe sequences stay short */
+#define RPL_HASH_SIZE (RPL_SIZE <= 8 ? 16 :    \
+		       RPL_SIZE <= 16 ? 32 :   \
+		       RPL_SIZE <= 32 ? 64 :   \
+		       RPL_SIZE <= 64 ? 128 :  \
+		       RPL_SIZE <= 128 ? 256 : \
+		       RPL_SIZE <= 256 ? 512 : \
+		       RPL_SIZE <= 512 ? 1024 : \
+		       RPL_SIZE <= 1024 ? 2048 : 4096)
+
+/* Used entries are kept packed at the beginning of replay_list and indexed
+ * by source address with open-addressed hash table holding entry index + 1,
+ * 0 meaning empty slot. Removing an entry moves the last one into its place.
+ */
+static struct bt_mesh_rpl replay_list[RPL_SIZE];
+static uint16_t rpl_hash[RPL_HASH_SIZE];
+static uint16_t rpl_count;
+static ATOMIC_DEFINE(store, RPL_SIZE);
 
 static inline int rpl_idx(const struct bt_mesh_rpl *rpl)
 {
 	return rpl - &replay_list[0];
 }
 
+static inline uint16_t rpl_hash_pos(uint16_t src)
+{
+	return ((uint32_t)src * 0x9e3779b1 >> 16) & (RPL_HASH_SIZE - 1);
+}
+
+/* Returns hash table position referring to entry with given source address
+ * or to empty slot terminating probe sequence.
+ */
+static uint16_t rpl_hash_find(uint16_t src)
+{
+	uint16_t pos = rpl_hash_pos(src);
+
+	while (rpl_hash[pos] && replay_list[rpl_hash[pos] - 1].src != src) {
+		pos = (pos + 1) & (RPL_HASH_SIZE - 1);
+	}
+
+	return pos;
+}
+
+static struct bt_mesh_rpl *rpl_find(uint16_t src)
+{
+	uint16_t pos = rpl_hash_find(src);
+
+	if (!rpl_hash[pos]) {
+		return NULL;
+	}
+
+	return &replay_list[rpl_hash[pos] - 1];
+}
+
+static void rpl_hash_del(uint16_t pos)
+{
+	uint16_t next = pos;
+	uint16_t home;
+
+	/* Shift back following entries of the cluster which would otherwise be
+	 * unreachable once this slot becomes empty.
+	 */
+	for (;;) {
+		next = (next + 1) & (RPL_HASH_SIZE - 1);
+		if (!rpl_hash[next]) {
+			break;
+		}
+
+		home = rpl_hash_pos(replay_list[rpl_hash[next] - 1].src);
+		if (((next - home) & (RPL_HASH_SIZE - 1)) >=
+		    ((next - pos) & (RPL_HASH_SIZE - 1))) {
+			rpl_hash[pos] = rpl_hash[next];
+			pos = next;
+		}
+	}
+
+	rpl_hash[pos] = 0U;
+}
+
+/* Returns free entry, source address is assigned by rpl_add() */
+static struct bt_mesh_rpl *rpl_next_free(void)
+{
+	if (rpl_count >= ARRAY_SIZE(replay_list)) {
+		return NULL;
+	}
+
+	return &replay_list[rpl_count];
+}
+
+static void rpl_add(struct bt_mesh_rpl *rpl, uint16_t src)
+{
+	__ASSERT(rpl == &replay_list[rpl_count], "Invalid RPL entry");
+
+	rpl->src = src;
+	rpl_hash[rpl_hash_find(src)] = rpl_idx(rpl) + 1;
+	rpl_count++;
+}
+
+static void rpl_remove(struct bt_mesh_rpl *rpl)
+{
+	int idx = rpl_idx(rpl);
+	int last = rpl_count - 1;
+
+	if (!rpl->src) {
+		return;
+	}
+
+	rpl_hash_del(rpl_hash_find(rpl->src));
+
+	if (idx != last) {
+		replay_list[idx] = replay_list[last];
+		rpl_hash[rpl_hash_find(replay_list[idx].src)] = idx + 1;
+		atomic_set_bit_to(store, idx, atomic_test_bit(store, last));
+	}
+
+	(void)memset(&replay_list[last], 0, sizeof(replay_list[last]));
+	atomic_clear_bit(store, last);
+	rpl_count--;
+}
+
+static void rpl_remove_all(void)
+{
+	(void)memset(replay_list, 0, sizeof(replay_list));
+	(void)memset(rpl_hash, 0, sizeof(rpl_hash));
+	rpl_count = 0U;
+}
+
 static void clear_rpl(struct bt_mesh_rpl *rpl)
 {
 #if MYNEWT_VAL(BLE_MESH_SETTINGS)
@@ -50,8 +175,7 @@ static void clear_rpl(struct bt_mesh_rpl *rpl)
 		BT_DBG("Cleared RPL");
 	}
 
-	(void)memset(rpl, 0, sizeof(*rpl));
-	atomic_clear_bit(store, rpl_idx(rpl));
+	rpl_remove(rpl);
 #endif
 }
 
@@ -87,7 +211,10 @@ void bt_mesh_rpl_update(struct bt_mesh_rpl *rpl,
 		rpl->seg = 0;
 	}
 
-	rpl->src = rx->ctx.addr;
+	if (!rpl->src) {
+		rpl_add(rpl, rx->ctx.addr);
+	}
+
 	rpl->seq = rx->seq;
 	rpl->old_iv = rx->old_iv;
 
@@ -104,7 +231,7 @@ void bt_mesh_rpl_update(struct bt_mesh_rpl *rpl,
 bool bt_mesh_rpl_check(struct bt_mesh_net_rx *rx,
 		struct bt_mesh_rpl **match)
 {
-	int i;
+	struct bt_mesh_rpl *rpl;
 
 	/* Don't bother checking messages from ourselves */
 	if (rx->net_if == BT_MESH_NET_IF_LOCAL) {
@@ -116,43 +243,32 @@ bool bt_mesh_rpl_check(struct bt_mesh_net_rx *rx,
 		return false;
 	}
 
-	for (i = 0; i < ARRAY_SIZE(replay_list); i++) {
-		struct bt_mesh_rpl *rpl = &replay_list[i];
+	rpl = rpl_find(rx->ctx.addr);
+	if (rpl) {
+		/* Existing slot for given address */
+		if (rx->old_iv && !rpl->old_iv) {
+			return true;
+		}
 
+		if (!((!rx->old_iv && rpl->old_iv) || rpl->seq < rx->seq)) {
+			return true;
+		}
+	} else {
 		/* Empty slot */
-		if (!rpl->src) {
-			if (match) {
-				*match = rpl;
-			} else {
-				bt_mesh_rpl_update(rpl, rx);
-			}
-
-			return false;
+		rpl = rpl_next_free();
+		if (!rpl) {
+			BT_ERR("RPL is full!");
+			return true;
 		}
+	}
 
-		/* Existing slot for given address */
-		if (rpl->src == rx->ctx.addr) {
-			if (rx->old_iv && !rpl->old_iv) {
-				return true;
-			}
-
-			if ((!rx->old_iv && rpl->old_iv) ||
-			    rpl->seq < rx->seq) {
-				if (match) {
-					*match = rpl;
-				} else {
-					bt_mesh_rpl_update(rpl, rx);
-				}
-
-				return false;
-			} else {
-				return true;
-			}
-		}
+	if (match) {
+		*match = rpl;
+	} else {
+		bt_mesh_rpl_update(rpl, rx);
 	}
 
-	BT_ERR("RPL is full!");
-	return true;
+	return false;
 }
 
 void bt_mesh_rpl_clear(void)
@@ -162,61 +278,31 @@ void bt_mesh_rpl_clear(void)
 	if (IS_ENABLED(CONFIG_BT_SETTINGS)) {
 		schedule_rpl_clear();
 	} else {
-		(void)memset(replay_list, 0, sizeof(replay_list));
-	}
-}
-
-#if MYNEWT_VAL(BLE_MESH_SETTINGS)
-static struct bt_mesh_rpl *bt_mesh_rpl_find(uint16_t src)
-{
-	int i;
-
-	for (i = 0; i < ARRAY_SIZE(replay_list); i++) {
-		if (replay_list[i].src == src) {
-			return &replay_list[i];
-		}
-	}
-
-	return NULL;
-}
-
-static struct bt_mesh_rpl *bt_mesh_rpl_alloc(uint16_t src)
-{
-	int i;
-
-	for (i = 0; i < ARRAY_SIZE(replay_list); i++) {
-		if (!replay_list[i].src) {
-			replay_list[i].src = src;
-			return &replay_list[i];
-		}
+		rpl_remove_all();
 	}
-
-	return NULL;
 }
-#endif
 
 void bt_mesh_rpl_reset(void)
 {
 	int i;
 
 	/* Discard "old old" IV Index entries from RPL and flag
-	 * any other ones (which are valid) as old.
+	 * any other ones (which are valid) as old. Walk backwards since
+	 * removal moves the last entry into the freed slot.
 	 */
-	for (i = 0; i < ARRAY_SIZE(replay_list); i++) {
+	for (i = rpl_count - 1; i >= 0; i--) {
 		struct bt_mesh_rpl *rpl = &replay_list[i];
 
-		if (rpl->src) {
-			if (rpl->old_iv) {
-				if (IS_ENABLED(CONFIG_BT_SETTINGS)) {
-					clear_rpl(rpl);
-				} else {
-					(void)memset(rpl, 0, sizeof(*rpl));
-				}
+		if (rpl->old_iv) {
+			if (IS_ENABLED(CONFIG_BT_SETTINGS)) {
+				clear_rpl(rpl);
 			} else {
-				rpl->old_iv = true;
-				if (IS_ENABLED(CONFIG_BT_SETTINGS)) {
-					schedule_rpl_store(rpl, true);
-				}
+				rpl_remove(rpl);
+			}
+		} else {
+			rpl->old_iv = true;
+			if (IS_ENABLED(CONFIG_BT_SETTINGS)) {
+				schedule_rpl_store(rpl, true);
 			}
 		}
 	}
@@ -238,11 +324,11 @@ static int rpl_set(int argc, char **argv, char *val)
 	BT_DBG("argv[0] %s val %s", argv[0], val ? val : "(null)");
 
 	src = strtol(argv[0], NULL, 16);
-	entry = bt_mesh_rpl_find(src);
+	entry = rpl_find(src);
 
 	if (!val) {
 		if (entry) {
-			memset(entry, 0, sizeof(*entry));
+			rpl_remove(entry);
 		} else {
 			BT_WARN("Unable to find RPL entry for 0x%04x", src);
 		}
@@ -251,11 +337,13 @@ static int rpl_set(int argc, char **argv, char *val)
 	}
 
 	if (!entry) {
-		entry = bt_mesh_rpl_alloc(src);
+		entry = rpl_next_free();
 		if (!entry) {
 			BT_ERR("Unable to allocate RPL entry for 0x%04x", src);
 			return -ENOMEM;
 		}
+
+		rpl_add(entry, src);
 	}
 
 	len = sizeof(rpl);
@@ -325,8 +413,28 @@ static void store_pending_rpl(struct bt_mesh_rpl *rpl)
 	}
 }
 
+/* Writes out only entries marked dirty, each one once regardless of how many
+ * times it was updated since last store.
+ */
+static void store_dirty_rpl(void)
+{
+	atomic_val_t dirty;
+	unsigned int bit;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(store); i++) {
+		dirty = atomic_clear(&store[i]);
+
+		while ((bit = find_lsb_set(dirty))) {
+			dirty &= ~BIT(bit - 1);
+			store_rpl(&replay_list[i * ATOMIC_BITS + bit - 1]);
+		}
+	}
+}
+
 void bt_mesh_rpl_pending_store(uint16_t addr)
 {
+	struct bt_mesh_rpl *rpl;
 	int i;
 
 	if (!IS_ENABLED(CONFIG_BT_SETTINGS) ||
@@ -335,25 +443,33 @@ void bt_mesh_rpl_pending_store(uint16_t addr)
 		return;
 	}
 
-	if (addr == BT_MESH_ADDR_ALL_NODES) {
-		bt_mesh_settings_store_cancel(BT_MESH_SETTINGS_RPL_PENDING);
-	}
-
-	for (i = 0; i < ARRAY_SIZE(replay_list); i++) {
-		if (addr != BT_MESH_ADDR_ALL_NODES &&
-		addr != replay_list[i].src) {
-			continue;
+	if (addr != BT_MESH_ADDR_ALL_NODES) {
+		rpl = rpl_find(addr);
+		if (!rpl) {
+			return;
 		}
 
 		if (atomic_test_bit(bt_mesh.flags, BT_MESH_VALID)) {
-			store_pending_rpl(&replay_list[i]);
+			store_pending_rpl(rpl);
 		} else {
-			clear_rpl(&replay_list[i]);
+			clear_rpl(rpl);
 		}
 
-		if (addr != BT_MESH_ADDR_ALL_NODES) {
-			break;
-		}
+		return;
+	}
+
+	bt_mesh_settings_store_cancel(BT_MESH_SETTINGS_RPL_PENDING);
+
+	if (atomic_test_bit(bt_mesh.flags, BT_MESH_VALID)) {
+		store_dirty_rpl();
+		return;
+	}
+
+	/* Walk backwards since removal moves the last entry into the freed
+	 * slot.
+	 */
+	for (i = rpl_count - 1; i >= 0; i--) {
+		clear_rpl(&replay_list[i]);
 	}
 }
 
@@ -32,6 +32,16 @@
 
 static struct k_work_delayable pending_store;
 static ATOMIC_DEFINE(pending_flags, BT_MESH_SETTINGS_FLAG_COUNT);
+static struct bt_mesh_settings_stats stats;
+
+/* All mesh settings writes go through here, for write statistics */
+int bt_mesh_settings_save_one(const char *name, char *val)
+{
+	stats.items++;
+	stats.bytes += strlen(name) + (val ? strlen(val) : 0);
+
+	return conf_save_one(name, val);
+}
 
 int settings_name_next(char *name, char **next)
 {
@@ -85,10 +95,17 @@ static int mesh_commit(void)
 	return 0;
 }
 
-/* Pending flags that use K_NO_WAIT as the storage timeout */
-#define NO_WAIT_PENDING_BITS (BIT(BT_MESH_SETTINGS_NET_PENDING) |           \
-			BIT(BT_MESH_SETTINGS_IV_PENDING)  |           \
-			BIT(BT_MESH_SETTINGS_SEQ_PENDING) |           \
+/* Pending flags that use K_NO_WAIT as the storage timeout. These are never
+ * delayed, as IV Index or sequence number lost on power loss could lead to
+ * reuse of sequence numbers.
+ */
+#define NO_WAIT_PENDING_BITS (BIT(BT_MESH_SETTINGS_IV_PENDING)  |           \
+			BIT(BT_MESH_SETTINGS_SEQ_PENDING))
+
+/* Pending flags that use CONFIG_BT_MESH_STORE_BATCH_DELAY, so changes made in
+ * a quick sequence (e.g. by provisioner) are stored together
+ */
+#define BATCH_PENDING_BITS (BIT(BT_MESH_SETTINGS_NET_PENDING) |             \
 			BIT(BT_MESH_SETTINGS_CDB_PENDING))
 
 /* Pending flags that use CONFIG_BT_MESH_STORE_TIMEOUT */
@@ -104,9 +121,12 @@ void bt_mesh_settings_store_schedule(enum bt_mesh_settings_flag flag)
 	int32_t timeout_ms, remaining_ms;
 
 	atomic_set_bit(pending_flags, flag);
+	stats.requests++;
 
 	if (atomic_get(pending_flags) & NO_WAIT_PENDING_BITS) {
 		timeout_ms = 0;
+	} else if (atomic_get(pending_flags) & BATCH_PENDING_BITS) {
+		timeout_ms = CONFIG_BT_MESH_STORE_BATCH_DELAY;
 	} else if (CONFIG_BT_MESH_RPL_STORE_TIMEOUT >= 0 &&
 		   atomic_test_bit(pending_flags, BT_MESH_SETTINGS_RPL_PENDING) &&
 		   !(atomic_get(pending_flags) & GENERIC_PENDING_BITS)) {
@@ -137,6 +157,7 @@ void bt_mesh_settings_store_cancel(enum bt_mesh_settings_flag flag)
 static void store_pending(struct ble_npl_event *work)
 {
 	BT_DBG("");
+
 	if (atomic_test_and_clear_bit(pending_flags,
 				      BT_MESH_SETTINGS_RPL_PENDING)) {
 		bt_mesh_rpl_pending_store(BT_MESH_ADDR_ALL_NODES);
@@ -195,6 +216,11 @@ static void store_pending(struct ble_npl_event *work)
 #endif
 }
 
+void bt_mesh_settings_stats_get(struct bt_mesh_settings_stats *out)
+{
+	*out = stats;
+}
+
 static struct conf_handler bt_mesh_settings_conf_handler = {
 	.ch_name = "bt_mesh",
 	.ch_get = NULL,
@@ -20,7 +20,24 @@ enum bt_mesh_settings_flag {
 	BT_MESH_SETTINGS_FLAG_COUNT,
 };
 
+struct bt_mesh_settings_stats {
+	/** Number of store requests, i.e. times some state became dirty */
+	uint32_t requests;
+	/** Number of settings items written */
+	uint32_t items;
+	/** Number of name and value bytes written */
+	uint32_t bytes;
+};
+
 void bt_mesh_settings_init(void);
 int settings_name_next(char *name, char **next);
 void bt_mesh_settings_store_schedule(enum bt_mesh_settings_flag flag);
 void bt_mesh_settings_store_cancel(enum bt_mesh_settings_flag flag);
+
+/** @brief Get settings write statistics.
+ *
+ *  Ratio of items to requests shows write amplification.
+ *
+ *  @param stats Statistics output.
+ */
+void bt_mesh_settings_stats_get(struct bt_mesh_settings_stats *stats);
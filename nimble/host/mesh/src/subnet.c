@@ -60,9 +60,43 @@ static struct bt_mesh_subnet subnets[CONFIG_BT_MESH_SUBNET_COUNT] = {
 	},
 };
 
+#if MYNEWT_VAL(BLE_MESH_FRIEND)
+#define CRED_INDEX_SIZE (2 * (CONFIG_BT_MESH_SUBNET_COUNT + \
+			      MYNEWT_VAL(BLE_MESH_FRIEND_LPN_COUNT)))
+#else
+#define CRED_INDEX_SIZE (2 * CONFIG_BT_MESH_SUBNET_COUNT)
+#endif
+
+#define CRED_INDEX_NID_COUNT 128
+
+/* Candidate credential for received Network PDUs */
+struct cred_index_entry {
+	const struct bt_mesh_net_cred *cred;
+	struct bt_mesh_subnet *sub;
+	uint8_t new_key:1,
+		friend_cred:1;
+};
+
+/* Friendship and subnet credentials grouped by NID, so that only credentials
+ * with NID matching received PDU are tried. Entries for NID n are at
+ * cred_index[cred_index_start[n]] up to cred_index[cred_index_start[n + 1]],
+ * friendship credentials first. Index is rebuilt on first lookup after any
+ * key or friendship change.
+ */
+static struct {
+	struct cred_index_entry entries[CRED_INDEX_SIZE];
+	uint16_t start[CRED_INDEX_NID_COUNT + 1];
+	bool valid;
+	uint32_t attempts;
+	uint32_t wasted;
+} cred_index;
+
 static void subnet_evt(struct bt_mesh_subnet *sub, enum bt_mesh_key_evt evt)
 {
 	int i;
+
+	bt_mesh_net_cred_index_invalidate();
+
 	for (i = 0; i < (sizeof(bt_mesh_subnet_cb_list)/sizeof(void *)); i++) {
 		BT_DBG("%d", i);
 		if (bt_mesh_subnet_cb_list[i]) {
@@ -211,6 +245,16 @@ void bt_mesh_subnet_store(uint16_t net_idx)
 }
 #endif
 
+static void net_keys_cache_invalidate(struct bt_mesh_subnet_keys *keys)
+{
+	bt_mesh_aes_key_cache_invalidate(keys->msg.enc);
+	bt_mesh_aes_key_cache_invalidate(keys->msg.privacy);
+	bt_mesh_aes_key_cache_invalidate(keys->beacon);
+#if defined(CONFIG_BT_MESH_GATT_PROXY)
+	bt_mesh_aes_key_cache_invalidate(keys->identity);
+#endif
+}
+
 static void key_refresh(struct bt_mesh_subnet *sub, uint8_t new_phase)
 {
 	BT_DBG("Phase 0x%02x -> 0x%02x", sub->kr_phase, new_phase);
@@ -234,6 +278,7 @@ static void key_refresh(struct bt_mesh_subnet *sub, uint8_t new_phase)
 		/* __fallthrough; */
 	case BT_MESH_KR_NORMAL:
 		sub->kr_phase = BT_MESH_KR_NORMAL;
+		net_keys_cache_invalidate(&sub->keys[0]);
 		memcpy(&sub->keys[0], &sub->keys[1], sizeof(sub->keys[0]));
 		sub->keys[1].valid = 0U;
 		subnet_evt(sub, BT_MESH_KEY_REVOKED);
@@ -290,6 +335,8 @@ static void subnet_del(struct bt_mesh_subnet *sub)
 	bt_mesh_net_loopback_clear(sub->net_idx);
 
 	subnet_evt(sub, BT_MESH_KEY_DELETED);
+	net_keys_cache_invalidate(&sub->keys[0]);
+	net_keys_cache_invalidate(&sub->keys[1]);
 	(void)memset(sub, 0, sizeof(*sub));
 	sub->net_idx = BT_MESH_KEY_UNUSED;
 }
@@ -643,6 +690,8 @@ int bt_mesh_subnet_set(uint16_t net_idx, uint8_t kr_phase,
 	sub->net_idx = net_idx;
 	sub->kr_phase = kr_phase;
 
+	bt_mesh_net_cred_index_invalidate();
+
 	if (IS_ENABLED(CONFIG_BT_MESH_GATT_PROXY)) {
 		sub->node_id = BT_MESH_NODE_IDENTITY_STOPPED;
 	} else {
@@ -726,6 +775,81 @@ void bt_mesh_net_keys_reset(void)
 	}
 }
 
+void bt_mesh_net_cred_index_invalidate(void)
+{
+	cred_index.valid = false;
+}
+
+static void cred_index_add(struct cred_index_entry *entries, int *count,
+			   const struct bt_mesh_net_cred *cred,
+			   struct bt_mesh_subnet *sub, int key_idx,
+			   bool friend_cred)
+{
+	if (!sub->keys[key_idx].valid) {
+		return;
+	}
+
+	entries[*count].cred = cred;
+	entries[*count].sub = sub;
+	entries[*count].new_key = (key_idx > 0);
+	entries[*count].friend_cred = friend_cred;
+	(*count)++;
+}
+
+static void cred_index_build(void)
+{
+	struct cred_index_entry entries[CRED_INDEX_SIZE];
+	uint16_t pos[CRED_INDEX_NID_COUNT];
+	int count = 0;
+	int i, j;
+
+#if MYNEWT_VAL(BLE_MESH_FRIEND)
+	/** Each friendship has unique friendship credentials */
+	for (i = 0; i < ARRAY_SIZE(bt_mesh.frnd); i++) {
+		struct bt_mesh_friend *frnd = &bt_mesh.frnd[i];
+
+		if (!frnd->subnet) {
+			continue;
+		}
+
+		for (j = 0; j < ARRAY_SIZE(frnd->cred); j++) {
+			cred_index_add(entries, &count, &frnd->cred[j],
+				       frnd->subnet, j, true);
+		}
+	}
+#endif
+
+	for (i = 0; i < ARRAY_SIZE(subnets); i++) {
+		struct bt_mesh_subnet *sub = &subnets[i];
+
+		if (sub->net_idx == BT_MESH_KEY_UNUSED) {
+			continue;
+		}
+
+		for (j = 0; j < ARRAY_SIZE(sub->keys); j++) {
+			cred_index_add(entries, &count, &sub->keys[j].msg, sub,
+				       j, false);
+		}
+	}
+
+	/* Counting sort by NID, keeps friendship credentials first */
+	(void)memset(cred_index.start, 0, sizeof(cred_index.start));
+	for (i = 0; i < count; i++) {
+		cred_index.start[entries[i].cred->nid + 1]++;
+	}
+
+	for (i = 0; i < CRED_INDEX_NID_COUNT; i++) {
+		cred_index.start[i + 1] += cred_index.start[i];
+		pos[i] = cred_index.start[i];
+	}
+
+	for (i = 0; i < count; i++) {
+		cred_index.entries[pos[entries[i].cred->nid]++] = entries[i];
+	}
+
+	cred_index.valid = true;
+}
+
 bool bt_mesh_net_cred_find(struct bt_mesh_net_rx *rx, struct os_mbuf *in,
 			   struct os_mbuf *out,
 			   bool (*cb)(struct bt_mesh_net_rx *rx,
@@ -733,7 +857,9 @@ bool bt_mesh_net_cred_find(struct bt_mesh_net_rx *rx, struct os_mbuf *in,
 				      struct os_mbuf *out,
 				      const struct bt_mesh_net_cred *cred))
 {
-	int i, j;
+	const struct cred_index_entry *entry;
+	uint8_t nid;
+	int i;
 
 	BT_DBG("");
 
@@ -741,13 +867,13 @@ bool bt_mesh_net_cred_find(struct bt_mesh_net_rx *rx, struct os_mbuf *in,
 	if (bt_mesh_lpn_waiting_update()) {
 		rx->sub = bt_mesh.lpn.sub;
 
-		for (j = 0; j < ARRAY_SIZE(bt_mesh.lpn.cred); j++) {
-			if (!rx->sub->keys[j].valid) {
+		for (i = 0; i < ARRAY_SIZE(bt_mesh.lpn.cred); i++) {
+			if (!rx->sub->keys[i].valid) {
 				continue;
 			}
 
-			if (cb(rx, in, out, &bt_mesh.lpn.cred[j])) {
-				rx->new_key = (j > 0);
+			if (cb(rx, in, out, &bt_mesh.lpn.cred[i])) {
+				rx->new_key = (i > 0);
 				rx->friend_cred = 1U;
 				rx->ctx.net_idx = rx->sub->net_idx;
 				return true;
@@ -761,53 +887,50 @@ bool bt_mesh_net_cred_find(struct bt_mesh_net_rx *rx, struct os_mbuf *in,
 	}
 #endif
 
-#if MYNEWT_VAL(BLE_MESH_FRIEND)
-	/** Each friendship has unique friendship credentials */
-	for (i = 0; i < ARRAY_SIZE(bt_mesh.frnd); i++) {
-		struct bt_mesh_friend *frnd = &bt_mesh.frnd[i];
+	if (!cred_index.valid) {
+		cred_index_build();
+	}
 
-		if (!frnd->subnet) {
-			continue;
-		}
+	nid = in->om_data[0] & 0x7f;
 
-		rx->sub = frnd->subnet;
+	for (i = cred_index.start[nid]; i < cred_index.start[nid + 1]; i++) {
+		entry = &cred_index.entries[i];
 
-		for (j = 0; j < ARRAY_SIZE(frnd->cred); j++) {
-			if (!rx->sub->keys[j].valid) {
-				continue;
-			}
+		rx->sub = entry->sub;
+		cred_index.attempts++;
 
-			if (cb(rx, in, out, &frnd->cred[j])) {
-				rx->new_key = (j > 0);
-				rx->friend_cred = 1U;
-				rx->ctx.net_idx = rx->sub->net_idx;
-				return true;
-			}
+		if (cb(rx, in, out, entry->cred)) {
+			rx->new_key = entry->new_key;
+			rx->friend_cred = entry->friend_cred;
+			rx->ctx.net_idx = rx->sub->net_idx;
+			return true;
 		}
+
+		cred_index.wasted++;
 	}
-#endif
 
-	for (i = 0; i < ARRAY_SIZE(subnets); i++) {
-		rx->sub = &subnets[i];
-		if (rx->sub->net_idx == BT_MESH_KEY_UNUSED) {
-			continue;
-		}
+	return false;
+}
 
-		for (j = 0; j < ARRAY_SIZE(rx->sub->keys); j++) {
-			if (!rx->sub->keys[j].valid) {
-				continue;
-			}
+int bt_mesh_subnet_relay_stats_get(uint16_t net_idx,
+				   struct bt_mesh_subnet_relay_stats *stats)
+{
+	struct bt_mesh_subnet *sub;
 
-			if (cb(rx, in, out, &rx->sub->keys[j].msg)) {
-				rx->new_key = (j > 0);
-				rx->friend_cred = 0U;
-				rx->ctx.net_idx = rx->sub->net_idx;
-				return true;
-			}
-		}
+	sub = bt_mesh_subnet_get(net_idx);
+	if (!sub) {
+		return -ENOENT;
 	}
 
-	return false;
+	*stats = sub->relay_stats;
+
+	return 0;
+}
+
+void bt_mesh_net_cred_stats_get(struct bt_mesh_net_cred_stats *stats)
+{
+	stats->attempts = cred_index.attempts;
+	stats->wasted = cred_index.wasted;
 }
 
 #if MYNEWT_VAL(BLE_MESH_SETTINGS)
@@ -52,6 +52,14 @@ struct bt_mesh_subnet {
 
 	uint8_t  auth[8];            /* Beacon Authentication Value */
 
+	struct bt_mesh_subnet_relay_stats {
+		uint32_t tx;         /* Relayed PDUs */
+		uint32_t tx_bytes;   /* Relayed Network PDU octets */
+		uint32_t drop_ttl;   /* Not relayed, TTL too low */
+		uint32_t drop_nobuf; /* Not relayed, out of relay buffers */
+		uint32_t drop_enc;   /* Not relayed, re-encryption failed */
+	} relay_stats;
+
 	struct bt_mesh_subnet_keys {
 		bool valid;
 		uint8_t net[16];       /* NetKey */
@@ -152,8 +160,9 @@ int bt_mesh_friend_cred_create(struct bt_mesh_net_cred *cred,
  *  @param rx Network RX parameters, passed to the callback.
  *  @param in Input message buffer, passed to the callback.
  *  @param out Output message buffer, passed to the callback.
- *  @param cb Callback to call for each known network credential. Iteration
- *            stops when this callback returns @c true.
+ *  @param cb Callback to call for each known network credential with NID
+ *            matching the message. Iteration stops when this callback
+ *            returns @c true.
  *
  *  @returns Whether any of the credentials got a @c true return from the
  *           callback.
@@ -165,6 +174,39 @@ bool bt_mesh_net_cred_find(struct bt_mesh_net_rx *rx, struct os_mbuf *in,
 				      struct os_mbuf *out,
 				      const struct bt_mesh_net_cred *cred));
 
+/** @brief Invalidate network credential lookup index.
+ *
+ *  Must be called whenever friendship credentials or subnet keys change,
+ *  the index is rebuilt on next call to @ref bt_mesh_net_cred_find.
+ */
+void bt_mesh_net_cred_index_invalidate(void);
+
+/** Network credential lookup counters */
+struct bt_mesh_net_cred_stats {
+	/** Credentials with NID matching received PDU that were tried */
+	uint32_t attempts;
+	/** Tried credentials which failed to decrypt the PDU */
+	uint32_t wasted;
+};
+
+/** @brief Get network credential lookup counters.
+ *
+ *  @param stats Counters output.
+ */
+void bt_mesh_net_cred_stats_get(struct bt_mesh_net_cred_stats *stats);
+
+/** @brief Get relay counters of the given Subnet.
+ *
+ *  Counters are reset when the Subnet is deleted.
+ *
+ *  @param net_idx Network index of the Subnet.
+ *  @param stats   Counters output.
+ *
+ *  @returns 0 on success, or (negative) error code on failure.
+ */
+int bt_mesh_subnet_relay_stats_get(uint16_t net_idx,
+				   struct bt_mesh_subnet_relay_stats *stats);
+
 /** @brief Get the network flags of the given Subnet.
  *
  *  @param sub Subnet to get the network flags of.
@@ -114,7 +114,7 @@ static struct seg_tx {
 
 static struct seg_rx {
 	struct bt_mesh_subnet   *sub;
-	void                    *seg[CONFIG_BT_MESH_RX_SEG_MAX];
+	struct os_mbuf          *buf;        /* Reassembled SDU */
 	uint64_t                    seq_auth;
 	uint16_t                    src;
 	uint16_t                    dst;
@@ -130,6 +130,14 @@ static struct seg_rx {
 	struct k_work_delayable    ack;
 } seg_rx[CONFIG_BT_MESH_RX_SEG_MSG_COUNT];
 
+/* Each RX context owns one reassembly buffer, so that segments are copied
+ * straight to their final position in the SDU.
+ */
+static os_membuf_t seg_rx_buf_mem[OS_MEMPOOL_SIZE(
+		CONFIG_BT_MESH_RX_SEG_MSG_COUNT,
+		BT_MESH_RX_SDU_MAX + BT_MESH_MBUF_HEADER_SIZE)];
+static struct os_mempool seg_rx_buf_mempool;
+static struct os_mbuf_pool seg_rx_buf_pool;
 
 char _k_mem_slab_buffer_[OS_ALIGN((BT_MESH_APP_SEG_SDU_MAX)*(CONFIG_BT_MESH_SEG_BUFS), OS_ALIGNMENT)];
 
@@ -694,30 +702,10 @@ int bt_mesh_trans_send(struct bt_mesh_net_tx *tx, struct os_mbuf *msg,
 	return err;
 }
 
-static void seg_rx_assemble(struct seg_rx *rx, struct os_mbuf *buf,
-			    uint8_t aszmic)
-{
-	int i;
-
-	net_buf_simple_reset(buf);
-
-	for (i = 0; i <= rx->seg_n; i++) {
-		net_buf_simple_add_mem(buf, rx->seg[i],
-				       MIN(seg_len(rx->ctl),
-					   rx->len - (i * seg_len(rx->ctl))));
-	}
-
-	/* Adjust the length to not contain the MIC at the end */
-	if (!rx->ctl) {
-		buf->om_len -= APP_MIC_LEN(aszmic);
-	}
-}
-
 struct decrypt_ctx {
 	struct bt_mesh_app_crypto_ctx crypto;
 	struct os_mbuf *buf;
 	struct os_mbuf *sdu;
-	struct seg_rx *seg;
 };
 
 static int sdu_try_decrypt(struct bt_mesh_net_rx *rx, const uint8_t key[16],
@@ -725,10 +713,9 @@ static int sdu_try_decrypt(struct bt_mesh_net_rx *rx, const uint8_t key[16],
 {
 	const struct decrypt_ctx *ctx = cb_data;
 
-	if (ctx->seg) {
-		seg_rx_assemble(ctx->seg, ctx->buf, ctx->crypto.aszmic);
-	}
-
+	/* Decrypted SDU is written to a separate buffer, the encrypted one is
+	 * kept intact for the next candidate key.
+	 */
 	net_buf_simple_reset(ctx->sdu);
 
 	return bt_mesh_app_decrypt(key, &ctx->crypto, ctx->buf, ctx->sdu);
@@ -749,7 +736,6 @@ static int sdu_recv(struct bt_mesh_net_rx *rx, uint8_t hdr, uint8_t aszmic,
 		},
 		.buf = buf,
 		.sdu = sdu,
-		.seg = seg,
 	};
 
 	BT_DBG("AKF %u AID 0x%02x", !ctx.crypto.dev_key, AID(&hdr));
@@ -1096,8 +1082,6 @@ static int send_ack(struct bt_mesh_subnet *sub, uint16_t src, uint16_t dst,
 
 static void seg_rx_reset(struct seg_rx *rx, bool full_reset)
 {
-	int i;
-
 	BT_DBG("rx %p", rx);
 
 	/* If this fails, the handler will exit early on the next execution, as
@@ -1112,15 +1096,6 @@ static void seg_rx_reset(struct seg_rx *rx, bool full_reset)
 						&rx->seq_auth);
 	}
 
-	for (i = 0; i <= rx->seg_n; i++) {
-		if (!rx->seg[i]) {
-			continue;
-		}
-
-		k_mem_slab_free(&segs, &rx->seg[i]);
-		rx->seg[i] = NULL;
-	}
-
 	rx->in_use = 0;
 
 	/* We don't always reset these values since we need to be able to
@@ -1233,17 +1208,36 @@ static bool seg_rx_is_valid(struct seg_rx *rx, struct bt_mesh_net_rx *net_rx,
 	return true;
 }
 
+/* Keeps a single source from taking all RX contexts, e.g. by sending to
+ * several group addresses at once.
+ */
+static bool seg_rx_src_limit_reached(uint16_t src)
+{
+	int count = 0;
+	int i;
+
+	if (!MYNEWT_VAL(BLE_MESH_RX_SEG_MSG_PER_SRC)) {
+		return false;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(seg_rx); i++) {
+		if (seg_rx[i].in_use && seg_rx[i].src == src) {
+			count++;
+		}
+	}
+
+	return count >= MYNEWT_VAL(BLE_MESH_RX_SEG_MSG_PER_SRC);
+}
+
 static struct seg_rx *seg_rx_alloc(struct bt_mesh_net_rx *net_rx,
 				   const uint8_t *hdr, const uint64_t *seq_auth,
 				   uint8_t seg_n)
 {
 	int i;
 
-	/* No race condition on this check, as this function only executes in
-	 * the collaborative Bluetooth rx thread:
-	 */
-	if (k_mem_slab_num_free_get(&segs) < 1) {
-		BT_WARN("Not enough segments for incoming message");
+	if (seg_rx_src_limit_reached(net_rx->ctx.addr)) {
+		BT_WARN("Too many incoming messages from 0x%04x",
+			net_rx->ctx.addr);
 		return NULL;
 	}
 
@@ -1265,6 +1259,9 @@ static struct seg_rx *seg_rx_alloc(struct bt_mesh_net_rx *net_rx,
 		rx->dst = net_rx->ctx.recv_dst;
 		rx->block = 0;
 
+		net_buf_simple_reset(rx->buf);
+		OS_MBUF_PKTHDR(rx->buf)->omp_len = 0;
+
 		BT_DBG("New RX context. Block Complete 0x%08x",
 		       (unsigned) BLOCK_COMPLETE(seg_n));
 
@@ -1478,15 +1475,9 @@ found_rx:
 		k_work_schedule(&rx->ack, K_MSEC(timeout));
 	}
 
-	/* Allocated segment here */
-	err = k_mem_slab_alloc(&segs, &rx->seg[seg_o]);
-	if (err) {
-		BT_WARN("Unable allocate buffer for Seg %u", seg_o);
-		return -ENOBUFS;
-	}
-
-	os_mbuf_copydata(buf, 0, buf->om_len, rx->seg[seg_o]);
-	BT_DBG("copied %s", bt_hex(rx->seg[seg_o], rx->len));
+	/* Segment goes straight to its position in the reassembled SDU */
+	os_mbuf_copydata(buf, 0, buf->om_len,
+			 rx->buf->om_data + seg_o * seg_len(rx->ctl));
 
 	BT_DBG("Received %u/%u", seg_o, seg_n);
 
@@ -1520,28 +1511,21 @@ found_rx:
 		 net_rx->ctx.send_ttl, seq_auth, rx->block, rx->obo);
 
 	if (net_rx->ctl) {
-		struct os_mbuf *sdu = NET_BUF_SIMPLE(BT_MESH_RX_CTL_MAX);
-		seg_rx_assemble(rx, sdu, 0U);
-		err = ctl_recv(net_rx, *hdr, sdu, seq_auth);
+		os_mbuf_extend(rx->buf, rx->len);
+		err = ctl_recv(net_rx, *hdr, rx->buf, seq_auth);
 	} else if (rx->len < 1 + APP_MIC_LEN(ASZMIC(hdr))) {
 		BT_ERR("Too short SDU + MIC");
 		err = -EINVAL;
 	} else {
-		struct os_mbuf *seg_buf = NET_BUF_SIMPLE(BT_MESH_RX_SDU_MAX);
 		struct os_mbuf *sdu;
 
-		/* Decrypting in place to avoid creating two assembly buffers.
-		 * We'll reassemble the buffer from the segments before each
-		 * decryption attempt.
-		 */
-		net_buf_simple_init(seg_buf, 0);
+		/* The MIC stays in place right after the encrypted data */
+		os_mbuf_extend(rx->buf, rx->len - APP_MIC_LEN(ASZMIC(hdr)));
 
-	    sdu = NET_BUF_SIMPLE(rx->len - APP_MIC_LEN(ASZMIC(hdr)));
-		net_buf_simple_init_with_data(
-			sdu, seg_buf->om_data, rx->len - APP_MIC_LEN(ASZMIC(hdr)));
+		sdu = NET_BUF_SIMPLE(rx->len - APP_MIC_LEN(ASZMIC(hdr)));
+		net_buf_simple_init(sdu, 0);
 
-		err = sdu_recv(net_rx, *hdr, ASZMIC(hdr), seg_buf, sdu, rx);
-		os_mbuf_free_chain(seg_buf);
+		err = sdu_recv(net_rx, *hdr, ASZMIC(hdr), rx->buf, sdu, rx);
 	}
 
 	seg_rx_reset(rx, false);
@@ -1689,9 +1673,23 @@ void bt_mesh_trans_init(void)
 	/* XXX Probably we need mempool for that.
 	 *  For now we increase MSYS_1_BLOCK_COUNT
 	 */
+	rc = os_mempool_init(&seg_rx_buf_mempool,
+			     CONFIG_BT_MESH_RX_SEG_MSG_COUNT,
+			     BT_MESH_RX_SDU_MAX + BT_MESH_MBUF_HEADER_SIZE,
+			     seg_rx_buf_mem, "seg_rx_buf_pool");
+	assert(rc == 0);
+
+	rc = os_mbuf_pool_init(&seg_rx_buf_pool, &seg_rx_buf_mempool,
+			       BT_MESH_RX_SDU_MAX + BT_MESH_MBUF_HEADER_SIZE,
+			       CONFIG_BT_MESH_RX_SEG_MSG_COUNT);
+	assert(rc == 0);
+
 	for (i = 0; i < ARRAY_SIZE(seg_rx); i++) {
 		k_work_init_delayable(&seg_rx[i].ack, seg_ack);
 		k_work_add_arg_delayable(&seg_rx[i].ack, &seg_rx[i]);
+
+		seg_rx[i].buf = os_mbuf_get_pkthdr(&seg_rx_buf_pool, 0);
+		assert(seg_rx[i].buf);
 	}
 }
 
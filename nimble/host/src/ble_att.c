@@ -536,6 +536,8 @@ ble_att_rx_extended(uint16_t conn_handle, uint16_t cid, struct os_mbuf **om)
         return BLE_HS_EMSGSIZE;
     }
 
+    ble_hs_trace_u32x3(BLE_HS_TRACE_ID_ATT_RX, conn_handle, cid, op);
+
     if (cid == BLE_L2CAP_CID_ATT && ble_att_is_response_op(op)) {
         ble_att_send_outstanding_after_response(conn_handle);
     }
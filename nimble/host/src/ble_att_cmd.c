@@ -90,6 +90,8 @@ ble_att_tx_with_conn(struct ble_hs_conn *conn, struct ble_l2cap_chan *chan, stru
     }
 
     ble_att_inc_tx_stat(txom->om_data[0]);
+    ble_hs_trace_u32x3(BLE_HS_TRACE_ID_ATT_TX, conn->bhc_handle, chan->scid,
+                       txom->om_data[0]);
 
     ble_att_truncate_to_mtu(chan, txom);
     rc = ble_l2cap_tx(conn, chan, txom);
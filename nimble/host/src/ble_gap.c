@@ -105,6 +105,16 @@
 
 #define BLE_GAP_UPDATE_TIMEOUT_MS               40000 /* ms */
 
+/**
+ * If background connection fails to initiate, it is retried at this rate
+ * (ms).
+ */
+#define BLE_GAP_BG_CONN_RETRY_TIMEOUT_MS        100 /* ms */
+
+#define BLE_GAP_BG_CONN     (MYNEWT_VAL(BLE_GAP_BG_CONN_MAX_PEERS) > 0 &&   \
+                             MYNEWT_VAL(BLE_ROLE_CENTRAL) &&                \
+                             MYNEWT_VAL(BLE_WHITELIST))
+
 #if MYNEWT_VAL(BLE_ROLE_CENTRAL)
 static const struct ble_gap_conn_params ble_gap_conn_params_dflt = {
     .scan_itvl = 0x0010,
@@ -259,6 +269,15 @@ static int ble_gap_conn_cancel_tx(void);
 static int ble_gap_disc_enable_tx(int enable, int filter_duplicates);
 #endif
 
+#if BLE_GAP_BG_CONN
+static void ble_gap_bg_conn_master_idle(void);
+static void ble_gap_bg_conn_reset(void);
+static int ble_gap_bg_conn_initiating(void);
+static int ble_gap_bg_conn_yield(void);
+static int ble_gap_bg_conn_rx_cancelled(void);
+static void ble_gap_bg_conn_conn_broken(const struct ble_gap_conn_desc *desc);
+#endif
+
 STATS_SECT_DECL(ble_gap_stats) ble_gap_stats;
 STATS_NAME_START(ble_gap_stats)
     STATS_NAME(ble_gap_stats, wl_set)
@@ -786,6 +805,8 @@ ble_gap_call_event_cb(struct ble_gap_event *event,
 
     BLE_HS_DBG_ASSERT(!ble_hs_locked_by_cur_task());
 
+    ble_hs_trace_u32(BLE_HS_TRACE_ID_GAP_EVENT, event->type);
+
     if (cb != NULL) {
         rc = cb(event, cb_arg);
     } else {
@@ -797,6 +818,8 @@ ble_gap_call_event_cb(struct ble_gap_event *event,
         rc = 0;
     }
 
+    ble_hs_trace_u32x2(BLE_HS_TRACE_ID_GAP_EVENT_DONE, event->type, rc);
+
     return rc;
 }
 
@@ -854,6 +877,10 @@ ble_gap_master_reset_state(void)
     ble_gap_master.conn.cancel = 0;
 
     ble_hs_timer_resched();
+
+#if BLE_GAP_BG_CONN
+    ble_gap_bg_conn_master_idle();
+#endif
 }
 #endif
 
@@ -1283,6 +1310,10 @@ ble_gap_conn_broken(uint16_t conn_handle, int reason)
 
     ble_hs_atomic_conn_delete(conn_handle);
 
+#if BLE_GAP_BG_CONN
+    ble_gap_bg_conn_conn_broken(&event.disconnect.conn);
+#endif
+
     event.type = BLE_GAP_EVENT_DISCONNECT;
     event.disconnect.reason = reason;
 
@@ -1463,6 +1494,13 @@ ble_gap_reset_state(int reason)
 {
     uint16_t conn_handle;
 
+#if BLE_GAP_BG_CONN
+    /* Controller state is lost, application restarts background connection
+     * when host is synced again.
+     */
+    ble_gap_bg_conn_reset();
+#endif
+
     while (1) {
         conn_handle = ble_hs_atomic_first_conn_handle();
         if (conn_handle == BLE_HS_CONN_HANDLE_NONE) {
@@ -1583,10 +1621,26 @@ void
 ble_gap_rx_adv_report(struct ble_gap_disc_desc *desc)
 {
 #if NIMBLE_BLE_SCAN
+#if BLE_HS_ADV_FILTER
+    uint8_t filter_flags = 0;
+#endif
+
     if (ble_gap_rx_adv_report_sanity_check(desc->data, desc->length_data)) {
         return;
     }
 
+#if BLE_HS_ADV_FILTER
+    if (desc->event_type == BLE_HCI_ADV_RPT_EVTYPE_SCAN_RSP) {
+        filter_flags |= BLE_HS_ADV_FILTER_F_SCAN_RSP;
+    }
+
+    if (!ble_hs_adv_filter_rx(&desc->addr, BLE_HS_ADV_FILTER_SID_NONE,
+                              desc->rssi, desc->data, desc->length_data,
+                              filter_flags)) {
+        return;
+    }
+#endif
+
     ble_gap_disc_report(desc);
 #endif
 }
@@ -1602,10 +1656,28 @@ ble_gap_rx_le_scan_timeout(void)
 void
 ble_gap_rx_ext_adv_report(struct ble_gap_ext_disc_desc *desc)
 {
+#if BLE_HS_ADV_FILTER
+    uint8_t filter_flags = 0;
+#endif
+
     if (ble_gap_rx_adv_report_sanity_check(desc->data, desc->length_data)) {
         return;
     }
 
+#if BLE_HS_ADV_FILTER
+    if (desc->props & BLE_HCI_ADV_SCAN_RSP_MASK) {
+        filter_flags |= BLE_HS_ADV_FILTER_F_SCAN_RSP;
+    }
+    if (desc->data_status == BLE_GAP_EXT_ADV_DATA_STATUS_INCOMPLETE) {
+        filter_flags |= BLE_HS_ADV_FILTER_F_INCOMPLETE;
+    }
+
+    if (!ble_hs_adv_filter_rx(&desc->addr, desc->sid, desc->rssi,
+                              desc->data, desc->length_data, filter_flags)) {
+        return;
+    }
+#endif
+
     ble_gap_ext_disc_report(desc);
 }
 #endif
@@ -2045,6 +2117,11 @@ ble_gap_rx_conn_complete(struct ble_gap_conn_complete *evt, uint8_t instance)
             break;
         case BLE_ERR_UNK_CONN_ID:
             /* master role */
+#if BLE_GAP_BG_CONN
+            if (ble_gap_bg_conn_rx_cancelled()) {
+                break;
+            }
+#endif
             if (ble_gap_master_in_progress()) {
                 /* Connect procedure successfully cancelled. */
                 if (ble_gap_master.preempted_op == BLE_GAP_OP_M_CONN) {
@@ -2423,6 +2500,25 @@ ble_gap_wl_tx_add(const ble_addr_t *addr)
                              &cmd, sizeof(cmd), NULL, 0);
 }
 
+#if BLE_GAP_BG_CONN
+static int
+ble_gap_wl_tx_rmv(const ble_addr_t *addr)
+{
+    struct ble_hci_le_rmv_white_list_cp cmd;
+
+    if (addr->type > BLE_ADDR_RANDOM) {
+        return BLE_HS_EINVAL;
+    }
+
+    memcpy(cmd.addr, addr->val, BLE_DEV_ADDR_LEN);
+    cmd.addr_type = addr->type;
+
+    return ble_hs_hci_cmd_tx(BLE_HCI_OP(BLE_HCI_OGF_LE,
+                                        BLE_HCI_OCF_LE_RMV_WHITE_LIST),
+                             &cmd, sizeof(cmd), NULL, 0);
+}
+#endif
+
 static int
 ble_gap_wl_tx_clear(void)
 {
@@ -5032,6 +5128,12 @@ ble_gap_disc_ext_validate(uint8_t own_addr_type)
         return BLE_HS_EINVAL;
     }
 
+#if BLE_GAP_BG_CONN
+    if (ble_gap_bg_conn_yield() != 0) {
+        return BLE_HS_EBUSY;
+    }
+#endif
+
     if (ble_gap_conn_active()) {
         return BLE_HS_EBUSY;
     }
@@ -5663,6 +5765,13 @@ ble_gap_ext_connect(uint8_t own_addr_type, const ble_addr_t *peer_addr,
 
     ble_hs_lock();
 
+#if BLE_GAP_BG_CONN
+    if (ble_gap_bg_conn_yield() != 0) {
+        rc = BLE_HS_EALREADY;
+        goto done;
+    }
+#endif
+
     if (ble_gap_conn_active()) {
         rc = BLE_HS_EALREADY;
         goto done;
@@ -5792,6 +5901,13 @@ ble_gap_connect(uint8_t own_addr_type, const ble_addr_t *peer_addr,
 
     ble_hs_lock();
 
+#if BLE_GAP_BG_CONN
+    if (ble_gap_bg_conn_yield() != 0) {
+        rc = BLE_HS_EALREADY;
+        goto done;
+    }
+#endif
+
     if (ble_gap_conn_active()) {
         rc = BLE_HS_EALREADY;
         goto done;
@@ -6039,6 +6155,17 @@ ble_gap_conn_cancel(void)
     }
 
     ble_hs_lock();
+
+#if BLE_GAP_BG_CONN
+    /* Background connect is not an application procedure, it is stopped
+     * with ble_gap_bg_conn_stop().
+     */
+    if (ble_gap_bg_conn_initiating()) {
+        ble_hs_unlock();
+        return BLE_HS_EALREADY;
+    }
+#endif
+
     rc = ble_gap_conn_cancel_no_lock();
     ble_hs_unlock();
 
@@ -6049,6 +6176,634 @@ ble_gap_conn_cancel(void)
 
 }
 
+/*****************************************************************************
+ * $background connect                                                       *
+ *****************************************************************************/
+
+#if BLE_GAP_BG_CONN
+struct ble_gap_bg_conn_peer {
+    ble_addr_t addr;
+    uint16_t conn_handle;
+    uint8_t in_wl:1;
+    /* Removed from set, but still needs to be removed from white list */
+    uint8_t removed:1;
+};
+
+/**
+ * The state of background connection. Disconnected peers are kept in the
+ * white list, as many as fit, and connect procedure using the white list is
+ * re-armed from the host task whenever the master becomes idle.
+ */
+static struct {
+    struct ble_gap_bg_conn_peer peers[MYNEWT_VAL(BLE_GAP_BG_CONN_MAX_PEERS)];
+    uint8_t num_peers;
+    /* Index of the peer to be added to white list next */
+    uint8_t next_peer;
+    uint8_t wl_size;
+    uint8_t wl_cnt;
+    uint8_t own_addr_type;
+    /* Connection complete events still to come for connect procedures
+     * cancelled in favour of application procedures
+     */
+    uint8_t cancel_pending;
+    uint8_t enabled:1;
+    /* White list is to be refilled with the next peers */
+    uint8_t rotate:1;
+    struct ble_gap_conn_params params;
+    ble_gap_event_fn *cb;
+    void *cb_arg;
+    struct ble_npl_event arm_ev;
+    struct ble_npl_callout retry_timer;
+} ble_gap_bg_conn;
+
+static int ble_gap_bg_conn_gap_event(struct ble_gap_event *event, void *arg);
+
+static struct ble_gap_bg_conn_peer *
+ble_gap_bg_conn_peer_find(const ble_addr_t *addr)
+{
+    struct ble_gap_bg_conn_peer *peer;
+    int i;
+
+    for (i = 0; i < ble_gap_bg_conn.num_peers; i++) {
+        peer = &ble_gap_bg_conn.peers[i];
+        if (!peer->removed && ble_addr_cmp(&peer->addr, addr) == 0) {
+            return peer;
+        }
+    }
+
+    return NULL;
+}
+
+static struct ble_gap_bg_conn_peer *
+ble_gap_bg_conn_peer_find_handle(uint16_t conn_handle)
+{
+    struct ble_gap_bg_conn_peer *peer;
+    int i;
+
+    for (i = 0; i < ble_gap_bg_conn.num_peers; i++) {
+        peer = &ble_gap_bg_conn.peers[i];
+        if (peer->conn_handle == conn_handle) {
+            return peer;
+        }
+    }
+
+    return NULL;
+}
+
+static void
+ble_gap_bg_conn_peer_free(int idx)
+{
+    memmove(&ble_gap_bg_conn.peers[idx], &ble_gap_bg_conn.peers[idx + 1],
+            (ble_gap_bg_conn.num_peers - idx - 1) *
+            sizeof(ble_gap_bg_conn.peers[0]));
+    ble_gap_bg_conn.num_peers--;
+
+    if (ble_gap_bg_conn.next_peer > idx) {
+        ble_gap_bg_conn.next_peer--;
+    }
+    if (ble_gap_bg_conn.next_peer >= ble_gap_bg_conn.num_peers) {
+        ble_gap_bg_conn.next_peer = 0;
+    }
+}
+
+static int
+ble_gap_bg_conn_peer_waiting(const struct ble_gap_bg_conn_peer *peer)
+{
+    /* Peer may also be connected by other means, e.g. ble_gap_connect() */
+    return !peer->removed && peer->conn_handle == BLE_HS_CONN_HANDLE_NONE &&
+           ble_hs_conn_find_by_addr(&peer->addr) == NULL;
+}
+
+static int
+ble_gap_bg_conn_initiating(void)
+{
+    return ble_gap_master.op == BLE_GAP_OP_M_CONN &&
+           ble_gap_master.cb == ble_gap_bg_conn_gap_event;
+}
+
+/**
+ * Brings the white list in line with the set of peers. Connected and removed
+ * peers are dropped from the white list and free entries are filled with
+ * waiting peers, continuing where the previous fill stopped so that every
+ * peer gets its turn if not all of them fit. Only changed entries are written
+ * to the controller, so re-arming after a connection costs a couple of HCI
+ * commands rather than rewriting whole white list.
+ *
+ * @param out_num_waiting       On success, number of waiting peers which did
+ *                                  not fit into the white list.
+ */
+static int
+ble_gap_bg_conn_wl_update(uint8_t *out_num_waiting)
+{
+    struct ble_gap_bg_conn_peer *peer;
+    uint8_t num_waiting = 0;
+    uint8_t idx;
+    int rc;
+    int i;
+
+    BLE_HS_DBG_ASSERT(ble_hs_locked_by_cur_task());
+
+    for (i = ble_gap_bg_conn.num_peers - 1; i >= 0; i--) {
+        peer = &ble_gap_bg_conn.peers[i];
+
+        if (peer->in_wl && (ble_gap_bg_conn.rotate || peer->removed ||
+                            !ble_gap_bg_conn_peer_waiting(peer))) {
+            rc = ble_gap_wl_tx_rmv(&peer->addr);
+            if (rc != 0) {
+                return rc;
+            }
+
+            peer->in_wl = 0;
+            ble_gap_bg_conn.wl_cnt--;
+        }
+
+        if (peer->removed) {
+            ble_gap_bg_conn_peer_free(i);
+        }
+    }
+
+    ble_gap_bg_conn.rotate = 0;
+
+    idx = ble_gap_bg_conn.next_peer;
+    for (i = 0; i < ble_gap_bg_conn.num_peers; i++) {
+        peer = &ble_gap_bg_conn.peers[idx];
+
+        if (!peer->in_wl && ble_gap_bg_conn_peer_waiting(peer)) {
+            if (ble_gap_bg_conn.wl_cnt < ble_gap_bg_conn.wl_size) {
+                rc = ble_gap_wl_tx_add(&peer->addr);
+                if (rc != 0) {
+                    return rc;
+                }
+
+                peer->in_wl = 1;
+                ble_gap_bg_conn.wl_cnt++;
+            } else if (num_waiting++ == 0) {
+                /* Next fill starts with first peer which did not fit. */
+                ble_gap_bg_conn.next_peer = idx;
+            }
+        }
+
+        idx = (idx + 1) % ble_gap_bg_conn.num_peers;
+    }
+
+    *out_num_waiting = num_waiting;
+
+    return 0;
+}
+
+static void
+ble_gap_bg_conn_arm(void)
+{
+    uint8_t num_waiting;
+    int32_t duration_ms;
+    int rc;
+
+    if (!ble_gap_bg_conn.enabled ||
+        ble_npl_callout_is_active(&ble_gap_bg_conn.retry_timer)) {
+        return;
+    }
+
+    ble_hs_lock();
+
+    if (ble_gap_master_in_progress()) {
+        /* Re-armed when the master is idle again. */
+        ble_hs_unlock();
+        return;
+    }
+
+    rc = ble_gap_bg_conn_wl_update(&num_waiting);
+
+    ble_hs_unlock();
+
+    if (rc != 0) {
+        goto retry;
+    }
+
+    if (ble_gap_bg_conn.wl_cnt == 0) {
+        /* Re-armed when a peer is added or disconnected. */
+        return;
+    }
+
+    if (num_waiting > 0) {
+        duration_ms = MYNEWT_VAL(BLE_GAP_BG_CONN_ROTATE_MS);
+    } else {
+        duration_ms = BLE_HS_FOREVER;
+    }
+
+    rc = ble_gap_connect(ble_gap_bg_conn.own_addr_type, NULL, duration_ms,
+                         &ble_gap_bg_conn.params, ble_gap_bg_conn_gap_event,
+                         NULL);
+    switch (rc) {
+    case 0:
+    case BLE_HS_EDISABLED:
+        return;
+    case BLE_HS_ENOMEM:
+        /* No free connection; re-armed on any disconnection. */
+        return;
+    default:
+        goto retry;
+    }
+
+retry:
+    ble_npl_callout_reset(&ble_gap_bg_conn.retry_timer,
+                          ble_npl_time_ms_to_ticks32(
+                              BLE_GAP_BG_CONN_RETRY_TIMEOUT_MS));
+}
+
+static void
+ble_gap_bg_conn_arm_event(struct ble_npl_event *ev)
+{
+    ble_gap_bg_conn_arm();
+}
+
+/**
+ * Makes background connection pick up a change in the set of peers.
+ */
+static void
+ble_gap_bg_conn_kick(void)
+{
+    BLE_HS_DBG_ASSERT(ble_hs_locked_by_cur_task());
+
+    if (!ble_gap_bg_conn.enabled) {
+        return;
+    }
+
+    if (ble_gap_bg_conn_initiating()) {
+        /* White list can't be modified while in use. Connect procedure is
+         * cancelled and re-armed from the host task once cancelled. This is
+         * also needed if white list is full, as a connect procedure with all
+         * peers fitting white list never times out to rotate it.
+         */
+        if (!ble_gap_master.conn.cancel) {
+            ble_gap_conn_cancel_no_lock();
+        }
+    } else {
+        ble_npl_eventq_put(ble_hs_evq_get(), &ble_gap_bg_conn.arm_ev);
+    }
+}
+
+/**
+ * Makes background connect give way to master procedure of the application.
+ * Connect procedure is cancelled and the master is released right away, as
+ * cancel is confirmed by the controller when command completes. Connection
+ * complete event reporting the cancel is consumed on reception, and
+ * background connect is re-armed once the master is idle again.
+ */
+static int
+ble_gap_bg_conn_yield(void)
+{
+    int rc;
+
+    BLE_HS_DBG_ASSERT(ble_hs_locked_by_cur_task());
+
+    if (!ble_gap_bg_conn_initiating()) {
+        return 0;
+    }
+
+    /* Already cancelled if the white list is being updated. */
+    if (!ble_gap_master.conn.cancel) {
+        rc = ble_gap_conn_cancel_tx();
+        if (rc != 0) {
+            return rc;
+        }
+    }
+
+    BLE_HS_LOG(INFO, "GAP procedure yielded: background connect\n");
+
+    ble_gap_bg_conn.cancel_pending++;
+    ble_gap_master_reset_state();
+
+    return 0;
+}
+
+/**
+ * Returns 1 if cancelled connection complete event belongs to background
+ * connect which gave way to the application.
+ */
+static int
+ble_gap_bg_conn_rx_cancelled(void)
+{
+    if (ble_gap_bg_conn.cancel_pending == 0) {
+        return 0;
+    }
+
+    ble_gap_bg_conn.cancel_pending--;
+
+    return 1;
+}
+
+/**
+ * Called on termination of any connection, not only those established by
+ * background connect: a peer connected with ble_gap_connect() becomes waiting
+ * again and a free connection may let background connect proceed.
+ */
+static void
+ble_gap_bg_conn_conn_broken(const struct ble_gap_conn_desc *desc)
+{
+    struct ble_gap_bg_conn_peer *peer;
+
+    ble_hs_lock();
+
+    peer = ble_gap_bg_conn_peer_find_handle(desc->conn_handle);
+    if (peer != NULL) {
+        peer->conn_handle = BLE_HS_CONN_HANDLE_NONE;
+    } else {
+        peer = ble_gap_bg_conn_peer_find(&desc->peer_id_addr);
+        if (peer == NULL) {
+            peer = ble_gap_bg_conn_peer_find(&desc->peer_ota_addr);
+        }
+    }
+
+    /* Running connect procedure is only disturbed if white list changes. */
+    if (peer != NULL || !ble_gap_bg_conn_initiating()) {
+        ble_gap_bg_conn_kick();
+    }
+
+    ble_hs_unlock();
+}
+
+static void
+ble_gap_bg_conn_master_idle(void)
+{
+    if (ble_gap_bg_conn.enabled) {
+        ble_npl_eventq_put(ble_hs_evq_get(), &ble_gap_bg_conn.arm_ev);
+    }
+}
+
+static void
+ble_gap_bg_conn_disable(void)
+{
+    ble_gap_bg_conn.enabled = 0;
+    ble_npl_callout_stop(&ble_gap_bg_conn.retry_timer);
+    ble_npl_eventq_remove(ble_hs_evq_get(), &ble_gap_bg_conn.arm_ev);
+}
+
+static void
+ble_gap_bg_conn_reset(void)
+{
+    ble_gap_bg_conn.cancel_pending = 0;
+
+    if (ble_gap_bg_conn.enabled) {
+        ble_gap_bg_conn_disable();
+    }
+}
+
+static int
+ble_gap_bg_conn_gap_event(struct ble_gap_event *event, void *arg)
+{
+    struct ble_gap_bg_conn_peer *peer;
+    struct ble_gap_conn_desc desc;
+    int rc;
+
+    switch (event->type) {
+    case BLE_GAP_EVENT_CONNECT:
+        switch (event->connect.status) {
+        case 0:
+            break;
+        case BLE_HS_ETIMEOUT:
+            /* Give waiting peers their turn in the white list. */
+            ble_gap_bg_conn.rotate = 1;
+            return 0;
+        case BLE_HS_EAPP:
+            /* Cancelled to update the white list. */
+            return 0;
+        default:
+            if (ble_gap_bg_conn.enabled) {
+                ble_npl_callout_reset(&ble_gap_bg_conn.retry_timer,
+                                      ble_npl_time_ms_to_ticks32(
+                                          BLE_GAP_BG_CONN_RETRY_TIMEOUT_MS));
+            }
+            return 0;
+        }
+
+        rc = ble_gap_conn_find(event->connect.conn_handle, &desc);
+        if (rc != 0) {
+            break;
+        }
+
+        ble_hs_lock();
+        peer = ble_gap_bg_conn_peer_find(&desc.peer_id_addr);
+        if (peer == NULL) {
+            peer = ble_gap_bg_conn_peer_find(&desc.peer_ota_addr);
+        }
+        if (peer != NULL) {
+            peer->conn_handle = event->connect.conn_handle;
+        }
+        ble_hs_unlock();
+        break;
+
+    default:
+        break;
+    }
+
+    if (ble_gap_bg_conn.cb != NULL) {
+        return ble_gap_bg_conn.cb(event, ble_gap_bg_conn.cb_arg);
+    }
+
+    return 0;
+}
+#endif
+
+#if MYNEWT_VAL(BLE_GAP_BG_CONN_MAX_PEERS)
+int
+ble_gap_bg_conn_start(uint8_t own_addr_type,
+                      const struct ble_gap_conn_params *params,
+                      ble_gap_event_fn *cb, void *cb_arg)
+{
+#if BLE_GAP_BG_CONN
+    uint8_t wl_size;
+    int rc;
+    int i;
+
+    if (!ble_hs_is_enabled()) {
+        return BLE_HS_EDISABLED;
+    }
+
+    if (ble_gap_bg_conn.enabled) {
+        return BLE_HS_EALREADY;
+    }
+
+    rc = ble_gap_wl_read_size(&wl_size);
+    if (rc != 0) {
+        return rc;
+    }
+
+    ble_hs_lock();
+
+    if (ble_gap_bg_conn.enabled) {
+        rc = BLE_HS_EALREADY;
+        goto done;
+    }
+
+    if (ble_gap_wl_busy()) {
+        rc = BLE_HS_EBUSY;
+        goto done;
+    }
+
+    BLE_HS_LOG(INFO, "GAP procedure initiated: background connect; "
+                     "own_addr_type=%d wl_size=%d\n", own_addr_type, wl_size);
+
+    rc = ble_gap_wl_tx_clear();
+    if (rc != 0) {
+        goto done;
+    }
+
+    for (i = 0; i < ble_gap_bg_conn.num_peers; i++) {
+        ble_gap_bg_conn.peers[i].in_wl = 0;
+    }
+
+    ble_gap_bg_conn.next_peer = 0;
+    ble_gap_bg_conn.wl_size = wl_size;
+    ble_gap_bg_conn.wl_cnt = 0;
+    ble_gap_bg_conn.rotate = 0;
+    ble_gap_bg_conn.own_addr_type = own_addr_type;
+    ble_gap_bg_conn.params = params ? *params : ble_gap_conn_params_dflt;
+    ble_gap_bg_conn.cb = cb;
+    ble_gap_bg_conn.cb_arg = cb_arg;
+
+    ble_npl_event_init(&ble_gap_bg_conn.arm_ev, ble_gap_bg_conn_arm_event,
+                       NULL);
+    ble_npl_callout_init(&ble_gap_bg_conn.retry_timer, ble_hs_evq_get(),
+                         ble_gap_bg_conn_arm_event, NULL);
+
+    ble_gap_bg_conn.enabled = 1;
+    ble_npl_eventq_put(ble_hs_evq_get(), &ble_gap_bg_conn.arm_ev);
+
+done:
+    ble_hs_unlock();
+
+    return rc;
+#else
+    return BLE_HS_ENOTSUP;
+#endif
+}
+
+int
+ble_gap_bg_conn_stop(void)
+{
+#if BLE_GAP_BG_CONN
+    int rc;
+    int i;
+
+    ble_hs_lock();
+
+    if (!ble_gap_bg_conn.enabled) {
+        rc = BLE_HS_EALREADY;
+        goto done;
+    }
+
+    ble_gap_bg_conn_disable();
+
+    if (ble_gap_bg_conn_initiating() && !ble_gap_master.conn.cancel) {
+        ble_gap_conn_cancel_no_lock();
+    }
+
+    /* White list is cleared on start, so removed peers can go now. */
+    for (i = ble_gap_bg_conn.num_peers - 1; i >= 0; i--) {
+        if (ble_gap_bg_conn.peers[i].removed) {
+            ble_gap_bg_conn_peer_free(i);
+        }
+    }
+
+    rc = 0;
+
+done:
+    ble_hs_unlock();
+
+    return rc;
+#else
+    return BLE_HS_ENOTSUP;
+#endif
+}
+
+int
+ble_gap_bg_conn_peer_add(const ble_addr_t *addr)
+{
+#if BLE_GAP_BG_CONN
+    struct ble_gap_bg_conn_peer *peer;
+    struct ble_hs_conn *conn;
+    int rc;
+
+    if (addr->type != BLE_ADDR_PUBLIC && addr->type != BLE_ADDR_RANDOM) {
+        return BLE_HS_EINVAL;
+    }
+
+    ble_hs_lock();
+
+    if (ble_gap_bg_conn_peer_find(addr) != NULL) {
+        rc = BLE_HS_EALREADY;
+        goto done;
+    }
+
+    if (ble_gap_bg_conn.num_peers ==
+        MYNEWT_VAL(BLE_GAP_BG_CONN_MAX_PEERS)) {
+        rc = BLE_HS_ENOMEM;
+        goto done;
+    }
+
+    peer = &ble_gap_bg_conn.peers[ble_gap_bg_conn.num_peers];
+    memset(peer, 0, sizeof(*peer));
+    peer->addr = *addr;
+    peer->conn_handle = BLE_HS_CONN_HANDLE_NONE;
+
+    /* Peer may still be connected in background, if it was removed and added
+     * again.
+     */
+    conn = ble_hs_conn_find_by_addr(addr);
+    if (conn != NULL && conn->bhc_cb == ble_gap_bg_conn_gap_event) {
+        peer->conn_handle = conn->bhc_handle;
+    }
+
+    ble_gap_bg_conn.num_peers++;
+
+    ble_gap_bg_conn_kick();
+
+    rc = 0;
+
+done:
+    ble_hs_unlock();
+
+    return rc;
+#else
+    return BLE_HS_ENOTSUP;
+#endif
+}
+
+int
+ble_gap_bg_conn_peer_remove(const ble_addr_t *addr)
+{
+#if BLE_GAP_BG_CONN
+    struct ble_gap_bg_conn_peer *peer;
+    int rc;
+
+    ble_hs_lock();
+
+    peer = ble_gap_bg_conn_peer_find(addr);
+    if (peer == NULL) {
+        rc = BLE_HS_ENOENT;
+        goto done;
+    }
+
+    if (peer->in_wl && ble_gap_bg_conn.enabled) {
+        /* Freed once removed from white list. */
+        peer->removed = 1;
+        ble_gap_bg_conn_kick();
+    } else {
+        ble_gap_bg_conn_peer_free(peer - ble_gap_bg_conn.peers);
+    }
+
+    rc = 0;
+
+done:
+    ble_hs_unlock();
+
+    return rc;
+#else
+    return BLE_HS_ENOTSUP;
+#endif
+}
+#endif
+
 /*****************************************************************************
  * $update connection parameters                                             *
  *****************************************************************************/
@@ -7095,6 +7850,10 @@ ble_gap_init(void)
     memset(&ble_gap_sync, 0, sizeof(ble_gap_sync));
 #endif
 
+#if BLE_GAP_BG_CONN
+    memset(&ble_gap_bg_conn, 0, sizeof(ble_gap_bg_conn));
+#endif
+
     rc = ble_npl_mutex_init(&preempt_done_mutex);
 
     if (rc) {
@@ -812,3 +812,524 @@ ble_hs_adv_find_field(uint8_t type, const uint8_t *data, uint8_t length,
 
     return 0;
 }
+
+#if BLE_HS_ADV_FILTER
+/* Kinds of compiled filter entries, also bits of ble_hs_adv_filter.kinds. */
+#define BLE_HS_ADV_FILTER_KIND_UUID16       0
+#define BLE_HS_ADV_FILTER_KIND_UUID32       1
+#define BLE_HS_ADV_FILTER_KIND_UUID128      2
+#define BLE_HS_ADV_FILTER_KIND_MFG          3
+#define BLE_HS_ADV_FILTER_KIND_NAME         4
+#define BLE_HS_ADV_FILTER_KIND_ADDR         5
+
+#define BLE_HS_ADV_FILTER_CONT_CNT MYNEWT_VAL(BLE_HS_ADV_FILTER_CONT_CNT)
+
+struct ble_hs_adv_filter_entry {
+    uint8_t kind;
+    /* Length of value to match; value is matched as a prefix */
+    uint8_t len;
+    union {
+        uint8_t val[BLE_HS_ADV_FILTER_PREFIX_MAX_LEN + 2];
+        struct {
+            uint8_t type;
+            uint64_t min;
+            uint64_t max;
+        } addr;
+    };
+};
+
+/* Advertising set whose scan responses or data fragments are reported without
+ * matching, or whose data fragments are dropped.
+ */
+struct ble_hs_adv_filter_cont {
+    ble_addr_t addr;
+    uint8_t sid;
+    uint8_t valid:1;
+    /* Extended advertising data is incomplete, more fragments follow */
+    uint8_t incomplete:1;
+    /* First fragment was rejected, drop the rest of the chain */
+    uint8_t rejected:1;
+};
+
+static struct {
+    struct ble_hs_adv_filter_entry entries[
+        MYNEWT_VAL(BLE_HS_ADV_FILTER_MAX_RULES)];
+    uint8_t num_entries;
+    /* Kinds of entries present, so that AD fields which no entry refers to
+     * are skipped without looking at entries.
+     */
+    uint8_t kinds;
+    int8_t rssi_min;
+    uint8_t enabled:1;
+    struct ble_hs_adv_filter_cont cont[BLE_HS_ADV_FILTER_CONT_CNT];
+    /* Entry to be reused next if there is no free one */
+    uint8_t cont_next;
+    uint32_t hits;
+    uint32_t misses;
+} ble_hs_adv_filter;
+
+static uint64_t
+ble_hs_adv_filter_addr_val(const ble_addr_t *addr)
+{
+    uint64_t val = 0;
+    int i;
+
+    for (i = BLE_DEV_ADDR_LEN - 1; i >= 0; i--) {
+        val = (val << 8) | addr->val[i];
+    }
+
+    return val;
+}
+
+static int
+ble_hs_adv_filter_compile(const struct ble_hs_adv_filter_rule *rule,
+                          struct ble_hs_adv_filter_entry *entry)
+{
+    memset(entry, 0, sizeof(*entry));
+
+    switch (rule->type) {
+    case BLE_HS_ADV_FILTER_TYPE_UUID:
+        if (rule->uuid == NULL) {
+            return BLE_HS_EINVAL;
+        }
+
+        switch (rule->uuid->type) {
+        case BLE_UUID_TYPE_16:
+            entry->kind = BLE_HS_ADV_FILTER_KIND_UUID16;
+            break;
+        case BLE_UUID_TYPE_32:
+            entry->kind = BLE_HS_ADV_FILTER_KIND_UUID32;
+            break;
+        case BLE_UUID_TYPE_128:
+            entry->kind = BLE_HS_ADV_FILTER_KIND_UUID128;
+            break;
+        default:
+            return BLE_HS_EINVAL;
+        }
+
+        entry->len = ble_uuid_length(rule->uuid);
+        ble_uuid_flat(rule->uuid, entry->val);
+        break;
+
+    case BLE_HS_ADV_FILTER_TYPE_MFG:
+        if (rule->mfg.data_len > BLE_HS_ADV_FILTER_PREFIX_MAX_LEN ||
+            (rule->mfg.data_len > 0 && rule->mfg.data == NULL)) {
+            return BLE_HS_EINVAL;
+        }
+
+        entry->kind = BLE_HS_ADV_FILTER_KIND_MFG;
+        entry->len = 2 + rule->mfg.data_len;
+        put_le16(entry->val, rule->mfg.company_id);
+        if (rule->mfg.data_len > 0) {
+            memcpy(entry->val + 2, rule->mfg.data, rule->mfg.data_len);
+        }
+        break;
+
+    case BLE_HS_ADV_FILTER_TYPE_NAME:
+        if (rule->name.prefix_len == 0 ||
+            rule->name.prefix_len > BLE_HS_ADV_FILTER_PREFIX_MAX_LEN ||
+            rule->name.prefix == NULL) {
+            return BLE_HS_EINVAL;
+        }
+
+        entry->kind = BLE_HS_ADV_FILTER_KIND_NAME;
+        entry->len = rule->name.prefix_len;
+        memcpy(entry->val, rule->name.prefix, rule->name.prefix_len);
+        break;
+
+    case BLE_HS_ADV_FILTER_TYPE_ADDR:
+        if ((rule->addr.min.type != BLE_ADDR_PUBLIC &&
+             rule->addr.min.type != BLE_ADDR_RANDOM) ||
+            rule->addr.min.type != rule->addr.max.type) {
+            return BLE_HS_EINVAL;
+        }
+
+        entry->kind = BLE_HS_ADV_FILTER_KIND_ADDR;
+        entry->addr.type = rule->addr.min.type;
+        entry->addr.min = ble_hs_adv_filter_addr_val(&rule->addr.min);
+        entry->addr.max = ble_hs_adv_filter_addr_val(&rule->addr.max);
+        if (entry->addr.min > entry->addr.max) {
+            return BLE_HS_EINVAL;
+        }
+        break;
+
+    default:
+        return BLE_HS_EINVAL;
+    }
+
+    return 0;
+}
+
+static int
+ble_hs_adv_filter_match_kind(uint8_t kind, const uint8_t *val, uint8_t len)
+{
+    const struct ble_hs_adv_filter_entry *entry;
+    int i;
+
+    if (!(ble_hs_adv_filter.kinds & (1 << kind))) {
+        return 0;
+    }
+
+    for (i = 0; i < ble_hs_adv_filter.num_entries; i++) {
+        entry = &ble_hs_adv_filter.entries[i];
+        if (entry->kind == kind && len >= entry->len &&
+            memcmp(val, entry->val, entry->len) == 0) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static int
+ble_hs_adv_filter_match_list(uint8_t kind, const uint8_t *val, uint8_t len,
+                             uint8_t elem_len)
+{
+    if (!(ble_hs_adv_filter.kinds & (1 << kind))) {
+        return 0;
+    }
+
+    for (; len >= elem_len; val += elem_len, len -= elem_len) {
+        if (ble_hs_adv_filter_match_kind(kind, val, elem_len)) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static int
+ble_hs_adv_filter_match_addr(const ble_addr_t *addr)
+{
+    const struct ble_hs_adv_filter_entry *entry;
+    uint64_t val;
+    int i;
+
+    if (!(ble_hs_adv_filter.kinds & (1 << BLE_HS_ADV_FILTER_KIND_ADDR))) {
+        return 0;
+    }
+
+    val = ble_hs_adv_filter_addr_val(addr);
+
+    for (i = 0; i < ble_hs_adv_filter.num_entries; i++) {
+        entry = &ble_hs_adv_filter.entries[i];
+        /* Resolved identity address types are matched as identity type. */
+        if (entry->kind == BLE_HS_ADV_FILTER_KIND_ADDR &&
+            entry->addr.type == (addr->type & 1) &&
+            val >= entry->addr.min && val <= entry->addr.max) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Matches raw advertising data against the rules in a single pass, without
+ * parsing it into ble_hs_adv_fields.
+ */
+static int
+ble_hs_adv_filter_match_data(const uint8_t *data, uint8_t length)
+{
+    const uint8_t *val;
+    uint8_t val_len;
+    int match;
+
+    while (length > 1) {
+        /* Zero length field terminates data; malformed data doesn't match. */
+        if (data[0] == 0 || data[0] >= length) {
+            return 0;
+        }
+
+        val = data + 2;
+        val_len = data[0] - 1;
+
+        switch (data[1]) {
+        case BLE_HS_ADV_TYPE_INCOMP_UUIDS16:
+        case BLE_HS_ADV_TYPE_COMP_UUIDS16:
+            match = ble_hs_adv_filter_match_list(
+                BLE_HS_ADV_FILTER_KIND_UUID16, val, val_len, 2);
+            break;
+
+        case BLE_HS_ADV_TYPE_INCOMP_UUIDS32:
+        case BLE_HS_ADV_TYPE_COMP_UUIDS32:
+            match = ble_hs_adv_filter_match_list(
+                BLE_HS_ADV_FILTER_KIND_UUID32, val, val_len, 4);
+            break;
+
+        case BLE_HS_ADV_TYPE_INCOMP_UUIDS128:
+        case BLE_HS_ADV_TYPE_COMP_UUIDS128:
+            match = ble_hs_adv_filter_match_list(
+                BLE_HS_ADV_FILTER_KIND_UUID128, val, val_len, 16);
+            break;
+
+        case BLE_HS_ADV_TYPE_SVC_DATA_UUID16:
+            match = val_len >= 2 &&
+                    ble_hs_adv_filter_match_kind(
+                        BLE_HS_ADV_FILTER_KIND_UUID16, val, 2);
+            break;
+
+        case BLE_HS_ADV_TYPE_SVC_DATA_UUID32:
+            match = val_len >= 4 &&
+                    ble_hs_adv_filter_match_kind(
+                        BLE_HS_ADV_FILTER_KIND_UUID32, val, 4);
+            break;
+
+        case BLE_HS_ADV_TYPE_SVC_DATA_UUID128:
+            match = val_len >= 16 &&
+                    ble_hs_adv_filter_match_kind(
+                        BLE_HS_ADV_FILTER_KIND_UUID128, val, 16);
+            break;
+
+        case BLE_HS_ADV_TYPE_INCOMP_NAME:
+        case BLE_HS_ADV_TYPE_COMP_NAME:
+            match = ble_hs_adv_filter_match_kind(BLE_HS_ADV_FILTER_KIND_NAME,
+                                                 val, val_len);
+            break;
+
+        case BLE_HS_ADV_TYPE_MFG_DATA:
+            match = ble_hs_adv_filter_match_kind(BLE_HS_ADV_FILTER_KIND_MFG,
+                                                 val, val_len);
+            break;
+
+        default:
+            match = 0;
+            break;
+        }
+
+        if (match) {
+            return 1;
+        }
+
+        length -= 1 + data[0];
+        data += 1 + data[0];
+    }
+
+    return 0;
+}
+
+static struct ble_hs_adv_filter_cont *
+ble_hs_adv_filter_cont_find(const ble_addr_t *addr, uint8_t sid)
+{
+    struct ble_hs_adv_filter_cont *cont;
+    int i;
+
+    for (i = 0; i < BLE_HS_ADV_FILTER_CONT_CNT; i++) {
+        cont = &ble_hs_adv_filter.cont[i];
+        if (cont->valid && cont->sid == sid &&
+            ble_addr_cmp(&cont->addr, addr) == 0) {
+            return cont;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Allocates entry for an advertising set. Entries of incomplete data chains
+ * are never reused, otherwise the rest of the chain would be matched as if it
+ * started with AD structure boundary.
+ *
+ * @return                      Entry on success; NULL if all entries are in
+ *                                  use by incomplete data chains.
+ */
+static struct ble_hs_adv_filter_cont *
+ble_hs_adv_filter_cont_alloc(const ble_addr_t *addr, uint8_t sid)
+{
+    struct ble_hs_adv_filter_cont *cont;
+    int idx;
+    int i;
+
+    for (i = 0; i < BLE_HS_ADV_FILTER_CONT_CNT; i++) {
+        cont = &ble_hs_adv_filter.cont[i];
+        if (!cont->valid) {
+            goto found;
+        }
+    }
+
+    for (i = 0; i < BLE_HS_ADV_FILTER_CONT_CNT; i++) {
+        idx = (ble_hs_adv_filter.cont_next + i) % BLE_HS_ADV_FILTER_CONT_CNT;
+        cont = &ble_hs_adv_filter.cont[idx];
+        if (!cont->incomplete) {
+            ble_hs_adv_filter.cont_next = (idx + 1) %
+                                          BLE_HS_ADV_FILTER_CONT_CNT;
+            goto found;
+        }
+    }
+
+    return NULL;
+
+found:
+    memset(cont, 0, sizeof(*cont));
+    cont->addr = *addr;
+    cont->sid = sid;
+    cont->valid = 1;
+
+    return cont;
+}
+
+static int
+ble_hs_adv_filter_match(const ble_addr_t *addr, uint8_t sid, int8_t rssi,
+                        const uint8_t *data, uint8_t length, uint8_t flags)
+{
+    struct ble_hs_adv_filter_cont *cont;
+    uint8_t incomplete;
+    int match;
+
+    incomplete = !!(flags & BLE_HS_ADV_FILTER_F_INCOMPLETE);
+
+    cont = ble_hs_adv_filter_cont_find(addr, sid);
+
+    /* Fragments following the first one do not start with AD structure
+     * boundary, so they share the verdict of the first fragment.
+     */
+    if (cont != NULL && cont->incomplete) {
+        match = !cont->rejected;
+        cont->incomplete = incomplete;
+        if (cont->rejected && !incomplete) {
+            cont->valid = 0;
+        }
+        return match;
+    }
+
+    if (cont != NULL && (flags & BLE_HS_ADV_FILTER_F_SCAN_RSP)) {
+        cont->incomplete = incomplete;
+        return 1;
+    }
+
+    /* 127 indicates RSSI is not available. */
+    match = (rssi == 127 || rssi >= ble_hs_adv_filter.rssi_min) &&
+            (ble_hs_adv_filter.num_entries == 0 ||
+             ble_hs_adv_filter_match_addr(addr) ||
+             ble_hs_adv_filter_match_data(data, length));
+
+    if (!match) {
+        if (incomplete) {
+            if (cont == NULL) {
+                cont = ble_hs_adv_filter_cont_alloc(addr, sid);
+            }
+            if (cont != NULL) {
+                cont->incomplete = 1;
+                cont->rejected = 1;
+            }
+        } else if (cont != NULL) {
+            cont->valid = 0;
+        }
+        return 0;
+    }
+
+    if (!(flags & BLE_HS_ADV_FILTER_F_SCAN_RSP) || incomplete) {
+        if (cont == NULL) {
+            cont = ble_hs_adv_filter_cont_alloc(addr, sid);
+        }
+        if (cont == NULL) {
+            /* Rest of the chain can't be tracked, so the whole chain is
+             * dropped rather than reported partially.
+             */
+            return !incomplete;
+        }
+        cont->incomplete = incomplete;
+        cont->rejected = 0;
+    }
+
+    return 1;
+}
+
+int
+ble_hs_adv_filter_rx(const ble_addr_t *addr, uint8_t sid, int8_t rssi,
+                     const uint8_t *data, uint8_t length, uint8_t flags)
+{
+    int match;
+
+    if (!ble_hs_adv_filter.enabled) {
+        return 1;
+    }
+
+    ble_hs_lock();
+
+    if (ble_hs_adv_filter.enabled) {
+        match = ble_hs_adv_filter_match(addr, sid, rssi, data, length, flags);
+        if (match) {
+            ble_hs_adv_filter.hits++;
+        } else {
+            ble_hs_adv_filter.misses++;
+        }
+    } else {
+        match = 1;
+    }
+
+    ble_hs_unlock();
+
+    return match;
+}
+#endif
+
+#if MYNEWT_VAL(BLE_HS_ADV_FILTER_MAX_RULES)
+int
+ble_hs_adv_filter_set(const struct ble_hs_adv_filter_params *params)
+{
+#if BLE_HS_ADV_FILTER
+    struct ble_hs_adv_filter_entry entries[
+        MYNEWT_VAL(BLE_HS_ADV_FILTER_MAX_RULES)];
+    uint8_t kinds = 0;
+    int rc;
+    int i;
+
+    if (params != NULL) {
+        if (params->num_rules > MYNEWT_VAL(BLE_HS_ADV_FILTER_MAX_RULES)) {
+            return BLE_HS_ENOMEM;
+        }
+
+        if (params->num_rules > 0 && params->rules == NULL) {
+            return BLE_HS_EINVAL;
+        }
+
+        for (i = 0; i < params->num_rules; i++) {
+            rc = ble_hs_adv_filter_compile(&params->rules[i], &entries[i]);
+            if (rc != 0) {
+                return rc;
+            }
+
+            kinds |= 1 << entries[i].kind;
+        }
+    }
+
+    ble_hs_lock();
+
+    memset(ble_hs_adv_filter.cont, 0, sizeof(ble_hs_adv_filter.cont));
+    ble_hs_adv_filter.hits = 0;
+    ble_hs_adv_filter.misses = 0;
+
+    if (params != NULL) {
+        memcpy(ble_hs_adv_filter.entries, entries,
+               params->num_rules * sizeof(entries[0]));
+        ble_hs_adv_filter.num_entries = params->num_rules;
+        ble_hs_adv_filter.kinds = kinds;
+        ble_hs_adv_filter.rssi_min = params->rssi_min;
+        ble_hs_adv_filter.enabled = 1;
+    } else {
+        ble_hs_adv_filter.enabled = 0;
+    }
+
+    ble_hs_unlock();
+
+    return 0;
+#else
+    return BLE_HS_ENOTSUP;
+#endif
+}
+
+void
+ble_hs_adv_filter_stats(uint32_t *out_hits, uint32_t *out_misses)
+{
+#if BLE_HS_ADV_FILTER
+    ble_hs_lock();
+    *out_hits = ble_hs_adv_filter.hits;
+    *out_misses = ble_hs_adv_filter.misses;
+    ble_hs_unlock();
+#else
+    *out_hits = 0;
+    *out_misses = 0;
+#endif
+}
+#endif
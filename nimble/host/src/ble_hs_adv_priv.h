@@ -20,6 +20,11 @@
 #ifndef H_BLE_HS_ADV_PRIV_
 #define H_BLE_HS_ADV_PRIV_
 
+#include <inttypes.h>
+#include "syscfg/syscfg.h"
+#include "nimble/ble.h"
+#include "nimble/nimble_opt.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -29,6 +34,28 @@ int ble_hs_adv_set_flat(uint8_t type, int data_len, const void *data,
 int ble_hs_adv_find_field(uint8_t type, const uint8_t *data, uint8_t length,
                           const struct ble_hs_adv_field **out);
 
+#if MYNEWT_VAL(BLE_HS_ADV_FILTER_MAX_RULES) && NIMBLE_BLE_SCAN
+#define BLE_HS_ADV_FILTER                   1
+#else
+#define BLE_HS_ADV_FILTER                   0
+#endif
+
+/* Report is a scan response. */
+#define BLE_HS_ADV_FILTER_F_SCAN_RSP        0x01
+/* Advertising data is incomplete, more data follows in next report. */
+#define BLE_HS_ADV_FILTER_F_INCOMPLETE      0x02
+
+/* Advertising SID of reports which carry none, e.g. legacy ones. */
+#define BLE_HS_ADV_FILTER_SID_NONE          0xff
+
+#if BLE_HS_ADV_FILTER
+/**
+ * Returns 1 if advertising report is to be reported to the application.
+ */
+int ble_hs_adv_filter_rx(const ble_addr_t *addr, uint8_t sid, int8_t rssi,
+                         const uint8_t *data, uint8_t length, uint8_t flags);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
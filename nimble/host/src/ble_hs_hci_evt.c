@@ -316,6 +316,14 @@ ble_hs_hci_evt_num_completed_pkts(uint8_t event_code, const void *data,
                 ble_hs_hci_add_avail_pkts(num_pkts);
             }
             ble_hs_unlock();
+
+#if MYNEWT_VAL(BLE_ISO_BROADCAST_SOURCE)
+            /* Not an ACL connection, may be CIS or BIS */
+            if (conn == NULL) {
+                ble_iso_rx_num_comp_pkts(le16toh(ev->completed[i].handle),
+                                         num_pkts);
+            }
+#endif
         }
     }
 
@@ -89,6 +89,25 @@ ble_hs_mbuf_l2cap_pkt(void)
     return ble_hs_mbuf_gen_pkt(BLE_HCI_DATA_HDR_SZ + BLE_L2CAP_HDR_SZ);
 }
 
+#if MYNEWT_VAL(BLE_ISO)
+/**
+ * Allocates an mbuf suitable for an HCI ISO data packet.  The resulting packet
+ * has sufficient leading space for:
+ *     o ISO data header
+ *     o Time_Stamp
+ *     o Packet_Sequence_Number and ISO_SDU_Length
+ *
+ * @return                  An empty mbuf on success; null on memory
+ *                              exhaustion.
+ */
+struct os_mbuf *
+ble_hs_mbuf_iso_pkt(void)
+{
+    return ble_hs_mbuf_gen_pkt(sizeof(struct ble_hci_iso) + sizeof(uint32_t) +
+                               sizeof(struct ble_hci_iso_data));
+}
+#endif
+
 struct os_mbuf *
 ble_hs_mbuf_att_pkt(void)
 {
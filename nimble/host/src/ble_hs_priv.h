@@ -33,6 +33,7 @@
 #include "ble_hs_conn_priv.h"
 #include "ble_hs_mbuf_priv.h"
 #include "ble_hs_startup_priv.h"
+#include "ble_hs_trace_priv.h"
 #include "ble_l2cap_priv.h"
 #include "ble_l2cap_sig_priv.h"
 #include "ble_l2cap_coc_priv.h"
@@ -0,0 +1,59 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef H_BLE_HS_TRACE_PRIV_
+#define H_BLE_HS_TRACE_PRIV_
+
+#include "nimble/ble_trace.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Keep in sync with tools/ble_trace/ble_trace_decode.py */
+#define BLE_HS_TRACE_ID_ATT_RX                  0
+#define BLE_HS_TRACE_ID_ATT_TX                  1
+#define BLE_HS_TRACE_ID_L2CAP_RX                2
+#define BLE_HS_TRACE_ID_L2CAP_TX                3
+#define BLE_HS_TRACE_ID_GAP_EVENT               4
+#define BLE_HS_TRACE_ID_GAP_EVENT_DONE          5
+
+static inline void
+ble_hs_trace_u32(unsigned id, uint32_t p1)
+{
+    ble_trace_u32(BLE_TRACE_ID_HS(id), p1);
+}
+
+static inline void
+ble_hs_trace_u32x2(unsigned id, uint32_t p1, uint32_t p2)
+{
+    ble_trace_u32x2(BLE_TRACE_ID_HS(id), p1, p2);
+}
+
+static inline void
+ble_hs_trace_u32x3(unsigned id, uint32_t p1, uint32_t p2, uint32_t p3)
+{
+    ble_trace_u32x3(BLE_TRACE_ID_HS(id), p1, p2, p3);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* H_BLE_HS_TRACE_PRIV_ */
@@ -21,6 +21,7 @@
 
 #if MYNEWT_VAL(BLE_ISO)
 #include "os/os_mbuf.h"
+#include "mem/mem.h"
 #include "host/ble_hs_log.h"
 #include "host/ble_hs.h"
 #include "host/ble_iso.h"
@@ -30,8 +31,8 @@
 #include "ble_hs_hci_priv.h"
 #include "ble_hs_mbuf_priv.h"
 
-#ifndef min
-#define min(a, b) ((a) < (b) ? (a) : (b))
+#ifndef max
+#define max(a, b) ((a) > (b) ? (a) : (b))
 #endif
 
 #define ble_iso_big_conn_handles_init(_big, _handles, _num_handles)         \
@@ -56,6 +57,11 @@
         }                                                                   \
     } while (0);
 
+/* Number of outstanding TX packets for which controller latency is tracked */
+#define BLE_ISO_TX_TIME_CNT     8
+
+#define BLE_ISO_TX_QUEUE_SIZE   MYNEWT_VAL(BLE_ISO_TX_QUEUE_SIZE)
+
 enum ble_iso_conn_type {
     BLE_ISO_CONN_BIS,
 };
@@ -73,11 +79,47 @@ struct ble_iso_big {
 struct ble_iso_conn {
     SLIST_ENTRY(ble_iso_conn) next;
     enum ble_iso_conn_type type;
-    uint8_t handle;
+    uint16_t handle;
 
     struct ble_iso_rx_data_info rx_info;
     struct os_mbuf *rx_buf;
 
+#if MYNEWT_VAL(BLE_ISO_BROADCAST_SINK)
+    uint32_t rx_sdus;
+    uint32_t rx_frags;
+    uint32_t rx_bytes;
+    uint32_t rx_incomplete;
+    uint32_t rx_invalid;
+#endif
+
+#if MYNEWT_VAL(BLE_ISO_BROADCAST_SOURCE)
+    uint16_t tx_seq_num;
+    uint16_t tx_outstanding;
+    uint32_t tx_sent;
+    uint32_t tx_completed;
+    uint32_t tx_latency_last;
+    uint32_t tx_latency_max;
+    ble_npl_time_t tx_time[BLE_ISO_TX_TIME_CNT];
+    uint8_t tx_time_valid;
+
+#if BLE_ISO_TX_QUEUE_SIZE > 0
+    /* SDUs waiting for controller buffers, oldest first */
+    struct {
+        struct os_mbuf *om;
+        ble_npl_time_t time;
+        uint8_t ts_flag;
+    } tx_queue[BLE_ISO_TX_QUEUE_SIZE];
+    uint8_t tx_queue_head;
+    uint8_t tx_queue_cnt;
+    uint8_t tx_queue_max;
+    uint32_t tx_dropped;
+    uint32_t tx_wait_max;
+    uint32_t tx_wait_last;
+    /* Mean deviation of queue wait time, in 1/16 ms */
+    uint32_t tx_jitter;
+#endif
+#endif
+
     ble_iso_event_fn *cb;
     void *cb_arg;
 };
@@ -96,6 +138,10 @@ static struct os_mempool ble_iso_bis_pool;
 static os_membuf_t ble_iso_bis_mem[
     OS_MEMPOOL_SIZE(MYNEWT_VAL(BLE_ISO_MAX_BISES), sizeof (struct ble_iso_bis))];
 
+#if MYNEWT_VAL(BLE_ISO_BROADCAST_SOURCE) && BLE_ISO_TX_QUEUE_SIZE > 0
+static void ble_iso_conn_tx_queue_flush(struct ble_iso_conn *conn);
+#endif
+
 static void
 ble_iso_conn_append(struct ble_iso_conn *conn)
 {
@@ -214,6 +260,8 @@ ble_iso_big_free(struct ble_iso_big *big)
     };
     uint8_t i = 0;
 
+    ble_hs_lock();
+
     SLIST_FOREACH(conn, &ble_iso_conns, next) {
         struct ble_iso_bis *bis;
 
@@ -224,10 +272,15 @@ ble_iso_big_free(struct ble_iso_big *big)
         bis = CONTAINER_OF(conn, struct ble_iso_bis, conn);
         if (bis->big == big) {
             SLIST_REMOVE(&ble_iso_conns, conn, ble_iso_conn, next);
+#if MYNEWT_VAL(BLE_ISO_BROADCAST_SOURCE) && BLE_ISO_TX_QUEUE_SIZE > 0
+            ble_iso_conn_tx_queue_flush(conn);
+#endif
             rem_bis[i++] = bis;
         }
     }
 
+    ble_hs_unlock();
+
     while (i > 0) {
         os_memblock_put(&ble_iso_bis_pool, rem_bis[--i]);
     }
@@ -407,109 +460,404 @@ ble_iso_rx_terminate_big_complete(const struct ble_hci_ev_le_subev_terminate_big
     ble_iso_big_free(big);
 }
 
-static int
-ble_iso_tx_complete(uint16_t conn_handle, const uint8_t *data,
-                    uint16_t data_len)
+static struct os_mbuf *
+ble_iso_frag_alloc(uint16_t frag_size, void *arg)
 {
-    struct os_mbuf *om;
-    int rc;
+    return ble_hs_mbuf_iso_pkt();
+}
 
-    om = ble_hs_mbuf_bare_pkt();
-    if (!om) {
-        return BLE_HS_ENOMEM;
+static struct os_mbuf *
+ble_iso_hdr_prepend(struct os_mbuf *om, uint16_t conn_handle, uint8_t pb_flag,
+                    uint8_t ts_flag)
+{
+    struct ble_hci_iso *hci_iso;
+    uint16_t len;
+
+    len = OS_MBUF_PKTLEN(om);
+
+    om = os_mbuf_prepend_pullup(om, sizeof(*hci_iso));
+    if (om == NULL) {
+        return NULL;
     }
 
-    os_mbuf_extend(om, 8);
-    /* Connection_Handle, PB_Flag, TS_Flag */
-    put_le16(&om->om_data[0],
-             BLE_HCI_ISO_HANDLE(conn_handle, BLE_HCI_ISO_PB_COMPLETE, 0));
-    /* Data_Total_Length = Data length + Packet_Sequence_Number placeholder */
-    put_le16(&om->om_data[2], data_len + 4);
-    /* Packet_Sequence_Number placeholder */
-    put_le16(&om->om_data[4], 0);
-    /* ISO_SDU_Length */
-    put_le16(&om->om_data[6], data_len);
+    hci_iso = (void *)om->om_data;
+    put_le16(&hci_iso->handle,
+             BLE_HCI_ISO_HANDLE(conn_handle, pb_flag, ts_flag));
+    put_le16(&hci_iso->length, len);
 
-    rc = os_mbuf_append(om, data, data_len);
-    if (rc) {
-        return rc;
+    return om;
+}
+
+static void
+ble_iso_conn_tx_sent(struct ble_iso_conn *conn)
+{
+    uint8_t idx;
+
+    BLE_HS_DBG_ASSERT(ble_hs_locked_by_cur_task());
+
+    idx = conn->tx_sent % BLE_ISO_TX_TIME_CNT;
+
+    /* Slot is reused only if packet which used it was already completed,
+     * otherwise latency of both packets is not tracked.
+     */
+    if (conn->tx_outstanding < BLE_ISO_TX_TIME_CNT) {
+        conn->tx_time[idx] = ble_npl_time_get();
+        conn->tx_time_valid |= 1 << idx;
+    } else {
+        conn->tx_time_valid &= ~(1 << idx);
+    }
+
+    conn->tx_sent++;
+    conn->tx_outstanding++;
+}
+
+static struct os_mbuf *
+ble_iso_sdu_hdr_prepend(struct os_mbuf *om, uint16_t seq_num,
+                        const struct ble_iso_tx_data_info *info)
+{
+    struct ble_hci_iso_data *iso_data;
+    uint16_t sdu_len;
+    bool ts;
+
+    sdu_len = OS_MBUF_PKTLEN(om);
+    ts = info != NULL && info->ts_valid;
+
+    /* Headers are put in leading space of SDU, data is not copied */
+    om = os_mbuf_prepend_pullup(om, sizeof(*iso_data) +
+                                    (ts ? sizeof(info->ts) : 0));
+    if (om == NULL) {
+        return NULL;
     }
 
-    return ble_transport_to_ll_iso(om);
+    if (ts) {
+        put_le32(om->om_data, info->ts);
+        iso_data = (void *)(om->om_data + sizeof(info->ts));
+    } else {
+        iso_data = (void *)om->om_data;
+    }
+
+    put_le16(&iso_data->packet_seq_num, seq_num);
+    put_le16(&iso_data->sdu_len, sdu_len);
+
+    return om;
 }
 
 static int
-ble_iso_tx_segmented(uint16_t conn_handle, const uint8_t *data,
-                     uint16_t data_len)
+ble_iso_conn_tx_sdu(struct ble_iso_conn *conn, struct os_mbuf *om,
+                    uint8_t ts_flag)
 {
-    struct os_mbuf *om;
-    uint16_t data_left = data_len;
-    uint16_t packet_len;
-    uint16_t offset = 0;
+    struct os_mbuf *frag;
     uint8_t pb;
     int rc;
 
-    while (data_left) {
-        packet_len = min(MYNEWT_VAL(BLE_TRANSPORT_ISO_SIZE), data_left);
-        if (data_left == data_len) {
-            pb = BLE_HCI_ISO_PB_FIRST;
-        } else if (packet_len == data_left) {
-            pb = BLE_HCI_ISO_PB_LAST;
+    BLE_HS_DBG_ASSERT(ble_hs_locked_by_cur_task());
+
+    pb = BLE_HCI_ISO_PB_FIRST;
+
+    /* Fragments are copied only if SDU does not fit in single ISO buffer */
+    while (om != NULL) {
+        frag = mem_split_frag(&om, MYNEWT_VAL(BLE_TRANSPORT_ISO_SIZE),
+                              ble_iso_frag_alloc, NULL);
+        if (frag == NULL) {
+            rc = BLE_HS_ENOMEM;
+            goto err;
+        }
+
+        if (pb == BLE_HCI_ISO_PB_FIRST) {
+            pb = om == NULL ? BLE_HCI_ISO_PB_COMPLETE : BLE_HCI_ISO_PB_FIRST;
         } else {
-            pb = BLE_HCI_ISO_PB_CONTINUATION;
+            pb = om == NULL ? BLE_HCI_ISO_PB_LAST :
+                              BLE_HCI_ISO_PB_CONTINUATION;
         }
 
-        om = ble_hs_mbuf_bare_pkt();
-        if (!om) {
-            return BLE_HS_ENOMEM;
+        frag = ble_iso_hdr_prepend(frag, conn->handle, pb, ts_flag);
+        if (frag == NULL) {
+            rc = BLE_HS_ENOMEM;
+            goto err;
         }
 
-        os_mbuf_extend(om, pb == BLE_HCI_ISO_PB_FIRST ? 8: 4);
+        rc = ble_transport_to_ll_iso(frag);
+        if (rc != 0) {
+            goto err;
+        }
 
-        /* Connection_Handle, PB_Flag, TS_Flag */
-        put_le16(&om->om_data[0],
-                 BLE_HCI_ISO_HANDLE(conn_handle, pb, 0));
+        /* Only packets accepted by transport will be completed */
+        ble_iso_conn_tx_sent(conn);
 
+        /* Time_Stamp is only present in first fragment */
+        ts_flag = 0;
         if (pb == BLE_HCI_ISO_PB_FIRST) {
-            /* Data_Total_Length = Data length +
-             * Packet_Sequence_Number placeholder*/
-            put_le16(&om->om_data[2], packet_len + 4);
+            pb = BLE_HCI_ISO_PB_CONTINUATION;
+        }
+    }
 
-            /* Packet_Sequence_Number placeholder */
-            put_le16(&om->om_data[8], 0);
+    return 0;
 
-            /* ISO_SDU_Length */
-            put_le16(&om->om_data[10], packet_len);
-        } else {
-            put_le16(&om->om_data[2], packet_len);
+err:
+    os_mbuf_free_chain(om);
+    return rc;
+}
+
+#if BLE_ISO_TX_QUEUE_SIZE > 0
+static void
+ble_iso_conn_tx_queue_pop(struct ble_iso_conn *conn)
+{
+    conn->tx_queue[conn->tx_queue_head].om = NULL;
+    conn->tx_queue_head = (conn->tx_queue_head + 1) % BLE_ISO_TX_QUEUE_SIZE;
+    conn->tx_queue_cnt--;
+}
+
+static void
+ble_iso_conn_tx_queue_flush(struct ble_iso_conn *conn)
+{
+    while (conn->tx_queue_cnt > 0) {
+        os_mbuf_free_chain(conn->tx_queue[conn->tx_queue_head].om);
+        ble_iso_conn_tx_queue_pop(conn);
+    }
+}
+
+static void
+ble_iso_conn_tx_queue_push(struct ble_iso_conn *conn, struct os_mbuf *om,
+                           uint8_t ts_flag)
+{
+    uint8_t idx;
+
+    if (conn->tx_queue_cnt == BLE_ISO_TX_QUEUE_SIZE) {
+        /* Oldest SDU would be the first to go stale anyway */
+        os_mbuf_free_chain(conn->tx_queue[conn->tx_queue_head].om);
+        ble_iso_conn_tx_queue_pop(conn);
+        conn->tx_dropped++;
+    }
+
+    idx = (conn->tx_queue_head + conn->tx_queue_cnt) % BLE_ISO_TX_QUEUE_SIZE;
+    conn->tx_queue[idx].om = om;
+    conn->tx_queue[idx].time = ble_npl_time_get();
+    conn->tx_queue[idx].ts_flag = ts_flag;
+    conn->tx_queue_cnt++;
+    conn->tx_queue_max = max(conn->tx_queue_max, conn->tx_queue_cnt);
+}
+
+static void
+ble_iso_conn_tx_wait_update(struct ble_iso_conn *conn, uint32_t wait)
+{
+    int32_t diff;
+
+    diff = wait - conn->tx_wait_last;
+    if (diff < 0) {
+        diff = -diff;
+    }
+
+    /* Same estimator as RTP interarrival jitter, scaled by 16 */
+    conn->tx_jitter += diff - ((conn->tx_jitter + 8) >> 4);
+
+    conn->tx_wait_last = wait;
+    conn->tx_wait_max = max(conn->tx_wait_max, wait);
+}
+
+static void
+ble_iso_conn_tx_queue_drain(struct ble_iso_conn *conn)
+{
+    ble_npl_time_t max_latency;
+    ble_npl_time_t now;
+    struct os_mbuf *om;
+    uint32_t wait;
+    uint8_t ts_flag;
+
+    BLE_HS_DBG_ASSERT(ble_hs_locked_by_cur_task());
+
+    max_latency = ble_npl_time_ms_to_ticks32(
+                                MYNEWT_VAL(BLE_ISO_TX_QUEUE_MAX_LATENCY));
+    now = ble_npl_time_get();
+
+    /* Keep controller queue shallow, so SDUs wait here where stale ones can
+     * still be dropped.
+     */
+    while (conn->tx_queue_cnt > 0 &&
+           conn->tx_outstanding < MYNEWT_VAL(BLE_ISO_TX_MAX_OUTSTANDING)) {
+        om = conn->tx_queue[conn->tx_queue_head].om;
+        wait = now - conn->tx_queue[conn->tx_queue_head].time;
+        ts_flag = conn->tx_queue[conn->tx_queue_head].ts_flag;
+        ble_iso_conn_tx_queue_pop(conn);
+
+        if (wait > max_latency) {
+            os_mbuf_free_chain(om);
+            conn->tx_dropped++;
+            continue;
         }
 
-        rc = os_mbuf_append(om, data + offset, packet_len);
-        if (rc) {
-            return rc;
+        ble_iso_conn_tx_wait_update(conn, ble_npl_time_ticks_to_ms32(wait));
+
+        if (ble_iso_conn_tx_sdu(conn, om, ts_flag) != 0) {
+            conn->tx_dropped++;
         }
+    }
+}
+#endif
+
+int
+ble_iso_tx_mbuf(uint16_t conn_handle, struct os_mbuf *om,
+                const struct ble_iso_tx_data_info *info)
+{
+    struct ble_iso_conn *conn;
+    uint16_t seq_num;
+    int rc;
+
+    if (OS_MBUF_PKTLEN(om) > BLE_HCI_ISO_SDU_LENGTH_MASK) {
+        os_mbuf_free_chain(om);
+        return BLE_HS_EINVAL;
+    }
+
+    ble_hs_lock();
+
+    conn = ble_iso_conn_lookup_handle(conn_handle);
+    if (conn == NULL) {
+        ble_hs_unlock();
+        os_mbuf_free_chain(om);
+        return BLE_HS_ENOTCONN;
+    }
 
-        ble_transport_to_ll_iso(om);
+    if (info != NULL && info->seq_num_valid) {
+        conn->tx_seq_num = info->seq_num;
+    }
 
-        offset += packet_len;
-        data_left -= packet_len;
+    /* Sequence number is assigned even if SDU is dropped later, so peer
+     * sees it as lost.
+     */
+    seq_num = conn->tx_seq_num++;
+
+    om = ble_iso_sdu_hdr_prepend(om, seq_num, info);
+    if (om == NULL) {
+        ble_hs_unlock();
+        return BLE_HS_ENOMEM;
     }
 
-    return 0;
+#if BLE_ISO_TX_QUEUE_SIZE > 0
+    ble_iso_conn_tx_queue_push(conn, om, info != NULL && info->ts_valid);
+    ble_iso_conn_tx_queue_drain(conn);
+    rc = 0;
+#else
+    rc = ble_iso_conn_tx_sdu(conn, om, info != NULL && info->ts_valid);
+#endif
+
+    ble_hs_unlock();
+
+    return rc;
 }
 
 int
 ble_iso_tx(uint16_t conn_handle, void *data, uint16_t data_len)
 {
+    struct os_mbuf *om;
     int rc;
 
-    if (data_len <= MYNEWT_VAL(BLE_TRANSPORT_ISO_SIZE)) {
-        rc = ble_iso_tx_complete(conn_handle, data, data_len);
-    } else {
-        rc = ble_iso_tx_segmented(conn_handle, data, data_len);
+    om = ble_hs_mbuf_iso_pkt();
+    if (om == NULL) {
+        return BLE_HS_ENOMEM;
     }
 
-    return rc;
+    rc = os_mbuf_append(om, data, data_len);
+    if (rc != 0) {
+        os_mbuf_free_chain(om);
+        return BLE_HS_ENOMEM;
+    }
+
+    return ble_iso_tx_mbuf(conn_handle, om, NULL);
+}
+
+int
+ble_iso_tx_stats_get(uint16_t conn_handle, struct ble_iso_tx_stats *stats)
+{
+    struct ble_iso_conn *conn;
+
+    ble_hs_lock();
+
+    conn = ble_iso_conn_lookup_handle(conn_handle);
+    if (conn != NULL) {
+        memset(stats, 0, sizeof(*stats));
+        stats->seq_num = conn->tx_seq_num;
+        stats->outstanding = conn->tx_outstanding;
+        stats->completed = conn->tx_completed;
+        stats->latency_last = conn->tx_latency_last;
+        stats->latency_max = conn->tx_latency_max;
+#if BLE_ISO_TX_QUEUE_SIZE > 0
+        stats->queued = conn->tx_queue_cnt;
+        stats->queued_max = conn->tx_queue_max;
+        stats->dropped = conn->tx_dropped;
+        stats->wait_last = conn->tx_wait_last;
+        stats->wait_max = conn->tx_wait_max;
+        stats->jitter = conn->tx_jitter >> 4;
+#endif
+    }
+
+    ble_hs_unlock();
+
+    return conn != NULL ? 0 : BLE_HS_ENOTCONN;
+}
+
+int
+ble_iso_rx_num_comp_pkts(uint16_t conn_handle, uint16_t num_pkts)
+{
+    struct ble_iso_event event;
+    struct ble_iso_conn *conn;
+    ble_iso_event_fn *cb;
+    ble_npl_time_t now;
+    uint32_t latency;
+    void *cb_arg;
+    uint8_t idx;
+
+    now = ble_npl_time_get();
+
+    ble_hs_lock();
+
+    conn = ble_iso_conn_lookup_handle(conn_handle);
+    if (conn == NULL) {
+        ble_hs_unlock();
+        return BLE_HS_ENOTCONN;
+    }
+
+    if (conn->tx_outstanding < num_pkts) {
+        ble_hs_unlock();
+        return BLE_HS_ECONTROLLER;
+    }
+
+    memset(&event, 0, sizeof(event));
+    event.type = BLE_ISO_EVENT_ISO_TX_COMPLETE;
+    event.iso_tx_complete.conn_handle = conn_handle;
+    event.iso_tx_complete.num_pkts = num_pkts;
+
+    /* Packets are completed in the same order as they were sent */
+    while (num_pkts--) {
+        idx = (conn->tx_sent - conn->tx_outstanding) % BLE_ISO_TX_TIME_CNT;
+
+        if (conn->tx_time_valid & (1 << idx)) {
+            latency = ble_npl_time_ticks_to_ms32(now - conn->tx_time[idx]);
+            conn->tx_latency_last = latency;
+            conn->tx_latency_max = max(conn->tx_latency_max, latency);
+            conn->tx_time_valid &= ~(1 << idx);
+        }
+
+        conn->tx_outstanding--;
+        conn->tx_completed++;
+    }
+
+#if BLE_ISO_TX_QUEUE_SIZE > 0
+    /* Controller buffers were freed, pass next SDUs */
+    ble_iso_conn_tx_queue_drain(conn);
+#endif
+
+    event.iso_tx_complete.outstanding = conn->tx_outstanding;
+    event.iso_tx_complete.latency = conn->tx_latency_last;
+
+    cb = conn->cb;
+    cb_arg = conn->cb_arg;
+
+    ble_hs_unlock();
+
+    if (cb != NULL) {
+        cb(&event, cb_arg);
+    }
+
+    return 0;
 }
 #endif /* BLE_ISO_BROADCAST_SOURCE */
 
@@ -695,35 +1043,38 @@ static int
 ble_iso_rx_data_info_parse(struct os_mbuf *om, bool ts_available,
                            struct ble_iso_rx_data_info *info)
 {
-    struct ble_hci_iso_data *iso_data;
+    struct ble_hci_iso_data iso_data;
+    uint8_t ts[4];
     uint16_t u16;
+    int rc;
 
+    /* Headers are copied out and trimmed, SDU data stays where it is */
     if (ts_available) {
-        if (os_mbuf_len(om) < sizeof(info->ts)) {
+        rc = os_mbuf_copydata(om, 0, sizeof(ts), ts);
+        if (rc != 0) {
             BLE_HS_LOG_DEBUG("Data missing\n");
             return BLE_HS_EMSGSIZE;
         }
 
-        info->ts = get_le32(om->om_data);
-        os_mbuf_adj(om, sizeof(info->ts));
+        info->ts = get_le32(ts);
+        os_mbuf_adj(om, sizeof(ts));
     } else {
         info->ts = 0;
     }
 
-    if (os_mbuf_len(om) < sizeof(*iso_data)) {
+    rc = os_mbuf_copydata(om, 0, sizeof(iso_data), &iso_data);
+    if (rc != 0) {
         BLE_HS_LOG_DEBUG("Data missing\n");
         return BLE_HS_EMSGSIZE;
     }
 
-    iso_data = (void *)(om->om_data);
-
-    info->seq_num = le16toh(iso_data->packet_seq_num);
-    u16 = le16toh(iso_data->sdu_len);
+    info->seq_num = le16toh(iso_data.packet_seq_num);
+    u16 = le16toh(iso_data.sdu_len);
     info->sdu_len = BLE_HCI_ISO_SDU_LENGTH(u16);
     info->status = BLE_HCI_ISO_PKT_STATUS_FLAG(u16);
     info->ts_valid = ts_available;
 
-    os_mbuf_adj(om, sizeof(*iso_data));
+    os_mbuf_adj(om, sizeof(iso_data));
 
     return 0;
 }
@@ -740,6 +1091,7 @@ ble_iso_conn_rx_data_discard(struct ble_iso_conn *conn)
 {
     os_mbuf_free_chain(conn->rx_buf);
     ble_iso_conn_rx_reset(conn);
+    conn->rx_invalid++;
 }
 
 static void
@@ -754,9 +1106,34 @@ ble_iso_event_iso_rx_emit(struct ble_iso_conn *conn)
 
     if (conn->cb != NULL) {
         conn->cb(&event, conn->cb_arg);
+    } else {
+        os_mbuf_free_chain(conn->rx_buf);
     }
 }
 
+static void
+ble_iso_conn_rx_complete(struct ble_iso_conn *conn)
+{
+    uint16_t len;
+
+    len = OS_MBUF_PKTLEN(conn->rx_buf);
+
+    /*
+     * SDU with missing fragments is still passed up, so application keeps
+     * its timing (e.g. runs packet loss concealment) for this interval.
+     */
+    if (len != conn->rx_info.sdu_len) {
+        conn->rx_info.status = BLE_ISO_DATA_STATUS_LOST;
+        conn->rx_incomplete++;
+    }
+
+    conn->rx_sdus++;
+    conn->rx_bytes += len;
+
+    ble_iso_event_iso_rx_emit(conn);
+    ble_iso_conn_rx_reset(conn);
+}
+
 static int
 ble_iso_conn_rx_data_load(struct ble_iso_conn *conn, struct os_mbuf *frag,
                           uint8_t pb_flag, bool ts_available, void *arg)
@@ -768,12 +1145,13 @@ ble_iso_conn_rx_data_load(struct ble_iso_conn *conn, struct os_mbuf *frag,
     case BLE_HCI_ISO_PB_FIRST:
     case BLE_HCI_ISO_PB_COMPLETE:
         if (conn->rx_buf != NULL) {
-            /* Previous data packet never completed. Discard old packet. */
-            ble_iso_conn_rx_data_discard(conn);
+            /* Previous SDU never completed, pass up what was received */
+            ble_iso_conn_rx_complete(conn);
         }
 
         rc = ble_iso_rx_data_info_parse(frag, ts_available, &conn->rx_info);
         if (rc != 0) {
+            conn->rx_invalid++;
             return rc;
         }
 
@@ -784,28 +1162,30 @@ ble_iso_conn_rx_data_load(struct ble_iso_conn *conn, struct os_mbuf *frag,
     case BLE_HCI_ISO_PB_LAST:
         if (conn->rx_buf == NULL) {
             /* Last fragment without the start. Discard new packet. */
+            conn->rx_invalid++;
             return BLE_HS_EBADDATA;
         }
 
         /* Determine whether the total length won't exceed the declared SDU length */
         len_remaining = conn->rx_info.sdu_len - OS_MBUF_PKTLEN(conn->rx_buf);
-        if (len_remaining - os_mbuf_len(frag) < 0) {
+        if (len_remaining - (int)OS_MBUF_PKTLEN(frag) < 0) {
             /* SDU Length exceeded. Discard all packets. */
             ble_iso_conn_rx_data_discard(conn);
             return BLE_HS_EBADDATA;
         }
 
+        /* Fragment is chained as is, its packet header is dropped */
         os_mbuf_concat(conn->rx_buf, frag);
         break;
 
     default:
         BLE_HS_LOG_ERROR("Invalid pb_flag %d\n", pb_flag);
+        conn->rx_invalid++;
         return BLE_HS_EBADDATA;
     }
 
     if (pb_flag == BLE_HCI_ISO_PB_COMPLETE || pb_flag == BLE_HCI_ISO_PB_LAST) {
-        ble_iso_event_iso_rx_emit(conn);
-        ble_iso_conn_rx_reset(conn);
+        ble_iso_conn_rx_complete(conn);
     }
 
     return 0;
@@ -845,6 +1225,11 @@ ble_iso_rx_data(struct os_mbuf *om, void *arg)
         return BLE_HS_EMSGSIZE;
     }
 
+    /* Drop any transport padding, so SDU can be chained as is */
+    if (os_mbuf_len(om) > length) {
+        os_mbuf_adj(om, length - os_mbuf_len(om));
+    }
+
     conn = ble_iso_conn_lookup_handle(conn_handle);
     if (conn == NULL) {
         BLE_HS_LOG_DEBUG("Unknown handle=%d\n", conn_handle);
@@ -852,6 +1237,8 @@ ble_iso_rx_data(struct os_mbuf *om, void *arg)
         return BLE_HS_EMSGSIZE;
     }
 
+    conn->rx_frags++;
+
     rc = ble_iso_conn_rx_data_load(conn, om, pb_flag, ts_flag > 0, arg);
     if (rc != 0) {
         os_mbuf_free_chain(om);
@@ -860,6 +1247,28 @@ ble_iso_rx_data(struct os_mbuf *om, void *arg)
 
     return 0;
 }
+
+int
+ble_iso_rx_stats_get(uint16_t conn_handle, struct ble_iso_rx_stats *stats)
+{
+    struct ble_iso_conn *conn;
+
+    ble_hs_lock();
+
+    conn = ble_iso_conn_lookup_handle(conn_handle);
+    if (conn != NULL) {
+        memset(stats, 0, sizeof(*stats));
+        stats->sdus = conn->rx_sdus;
+        stats->frags = conn->rx_frags;
+        stats->bytes = conn->rx_bytes;
+        stats->incomplete = conn->rx_incomplete;
+        stats->invalid = conn->rx_invalid;
+    }
+
+    ble_hs_unlock();
+
+    return conn != NULL ? 0 : BLE_HS_ENOTCONN;
+}
 #endif /* BLE_ISO_BROADCAST_SINK */
 
 int
@@ -889,6 +1298,12 @@ ble_iso_data_path_setup(const struct ble_iso_data_path_setup_params *param)
     if (param->data_path_dir & BLE_ISO_DATA_DIR_TX) {
         /* Input (Host to Controller) */
         cp->data_path_dir |= BLE_HCI_ISO_DATA_PATH_DIR_INPUT;
+
+        /* Optional, reports ISO Data transmission completion */
+        if (param->cb != NULL) {
+            conn->cb = param->cb;
+            conn->cb_arg = param->cb_arg;
+        }
     }
 
     if (param->data_path_dir & BLE_ISO_DATA_DIR_RX) {
@@ -40,6 +40,9 @@ ble_iso_rx_big_sync_lost(const struct ble_hci_ev_le_subev_big_sync_lost *ev);
 int
 ble_iso_rx_data(struct os_mbuf *om, void *arg);
 
+int
+ble_iso_rx_num_comp_pkts(uint16_t conn_handle, uint16_t num_pkts);
+
 #ifdef __cplusplus
 }
 #endif
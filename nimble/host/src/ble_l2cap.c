@@ -365,6 +365,9 @@ ble_l2cap_rx(struct ble_hs_conn *conn,
             goto err;
         }
 
+        ble_hs_trace_u32x3(BLE_HS_TRACE_ID_L2CAP_RX, conn->bhc_handle,
+                           l2cap_hdr.cid, l2cap_hdr.len);
+
         /* Strip L2CAP header from the front of the mbuf. */
         os_mbuf_adj(om, BLE_L2CAP_HDR_SZ);
 
@@ -457,6 +460,9 @@ ble_l2cap_tx(struct ble_hs_conn *conn, struct ble_l2cap_chan *chan,
 {
     int rc;
 
+    ble_hs_trace_u32x3(BLE_HS_TRACE_ID_L2CAP_TX, conn->bhc_handle, chan->dcid,
+                       OS_MBUF_PKTLEN(txom));
+
     txom = ble_l2cap_prepend_hdr(txom, chan->dcid, OS_MBUF_PKTLEN(txom));
     if (txom == NULL) {
         return BLE_HS_ENOMEM;
@@ -3167,3 +3167,563 @@ TEST_SUITE(ble_gap_test_suite_set_cb)
     ble_gap_test_case_set_cb_good();
     ble_gap_test_case_set_cb_bad();
 }
+
+/*****************************************************************************
+ * $background connect                                                       *
+ *****************************************************************************/
+
+#if MYNEWT_VAL(BLE_GAP_BG_CONN_MAX_PEERS)
+static void
+ble_gap_test_util_bg_conn_init(void)
+{
+    ble_gap_test_util_init();
+
+    /* Drop events left behind by previous test cases, so that only events
+     * posted by background connection are run.
+     */
+    while (ble_npl_eventq_get(ble_hs_evq_get(), 0) != NULL) {
+    }
+}
+
+static void
+ble_gap_test_util_bg_conn_run_events(void)
+{
+    struct ble_npl_event *ev;
+
+    while ((ev = ble_npl_eventq_get(ble_hs_evq_get(), 0)) != NULL) {
+        ble_npl_event_run(ev);
+    }
+}
+
+static void
+ble_gap_test_util_verify_tx_rmv_wl(ble_addr_t *addr)
+{
+    uint8_t param_len;
+    uint8_t *param;
+
+    param = ble_hs_test_util_hci_verify_tx(BLE_HCI_OGF_LE,
+                                           BLE_HCI_OCF_LE_RMV_WHITE_LIST,
+                                           &param_len);
+    TEST_ASSERT(param_len == 7);
+    TEST_ASSERT(param[0] == addr->type);
+    TEST_ASSERT(memcmp(param + 1, addr->val, 6) == 0);
+}
+
+static void
+ble_gap_test_util_verify_tx_bg_create_conn(void)
+{
+    uint8_t param_len;
+    uint8_t *param;
+
+    param = ble_hs_test_util_hci_verify_tx(BLE_HCI_OGF_LE,
+                                           BLE_HCI_OCF_LE_CREATE_CONN,
+                                           &param_len);
+    TEST_ASSERT(param_len == BLE_HCI_CREATE_CONN_LEN);
+    TEST_ASSERT(param[4] == BLE_HCI_CONN_FILT_USE_WL);
+    TEST_ASSERT(param[12] == BLE_OWN_ADDR_PUBLIC);
+}
+
+static void
+ble_gap_test_util_bg_conn_start(uint8_t wl_size)
+{
+    int rc;
+
+    ble_hs_test_util_hci_ack_set_params(
+        ble_hs_hci_util_opcode_join(BLE_HCI_OGF_LE,
+                                    BLE_HCI_OCF_LE_RD_WHITE_LIST_SIZE),
+        0, &wl_size, sizeof wl_size);
+    ble_hs_test_util_hci_ack_append(
+        ble_hs_hci_util_opcode_join(BLE_HCI_OGF_LE,
+                                    BLE_HCI_OCF_LE_CLEAR_WHITE_LIST),
+        0);
+
+    rc = ble_gap_bg_conn_start(BLE_OWN_ADDR_PUBLIC, NULL,
+                               ble_gap_test_util_connect_cb, NULL);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    ble_hs_test_util_hci_verify_tx(BLE_HCI_OGF_LE,
+                                   BLE_HCI_OCF_LE_RD_WHITE_LIST_SIZE, NULL);
+    ble_gap_test_util_verify_tx_clear_wl();
+}
+
+static void
+ble_gap_test_util_bg_conn_rx_complete(uint16_t conn_handle,
+                                      const ble_addr_t *peer_addr)
+{
+    struct ble_gap_conn_complete evt;
+    int rc;
+
+    ble_hs_test_util_hci_ack_set(
+        ble_hs_hci_util_opcode_join(BLE_HCI_OGF_LE,
+                                    BLE_HCI_OCF_LE_RD_REM_FEAT), 0);
+
+    memset(&evt, 0, sizeof evt);
+    evt.status = BLE_ERR_SUCCESS;
+    evt.connection_handle = conn_handle;
+    evt.role = BLE_HCI_LE_CONN_COMPLETE_ROLE_MASTER;
+    evt.peer_addr_type = peer_addr->type;
+    memcpy(evt.peer_addr, peer_addr->val, 6);
+
+    rc = ble_gap_rx_conn_complete(&evt, 0);
+    TEST_ASSERT_FATAL(rc == 0);
+}
+
+TEST_CASE_SELF(ble_gap_test_case_bg_conn_bad_args)
+{
+    ble_addr_t peer_addr = { BLE_ADDR_PUBLIC, { 1, 2, 3, 4, 5, 6 }};
+    int rc;
+
+    ble_gap_test_util_bg_conn_init();
+
+    /*** Not started. */
+    rc = ble_gap_bg_conn_stop();
+    TEST_ASSERT(rc == BLE_HS_EALREADY);
+
+    /*** Identity address types only. */
+    rc = ble_gap_bg_conn_peer_add(
+        &((ble_addr_t) { BLE_ADDR_PUBLIC_ID, { 1, 2, 3, 4, 5, 6 }}));
+    TEST_ASSERT(rc == BLE_HS_EINVAL);
+
+    /*** Duplicate and unknown peers. */
+    rc = ble_gap_bg_conn_peer_add(&peer_addr);
+    TEST_ASSERT(rc == 0);
+    rc = ble_gap_bg_conn_peer_add(&peer_addr);
+    TEST_ASSERT(rc == BLE_HS_EALREADY);
+
+    rc = ble_gap_bg_conn_peer_remove(
+        &((ble_addr_t) { BLE_ADDR_RANDOM, { 1, 2, 3, 4, 5, 6 }}));
+    TEST_ASSERT(rc == BLE_HS_ENOENT);
+    rc = ble_gap_bg_conn_peer_remove(&peer_addr);
+    TEST_ASSERT(rc == 0);
+
+    /*** Already started. */
+    ble_gap_test_util_bg_conn_start(4);
+    rc = ble_gap_bg_conn_start(BLE_OWN_ADDR_PUBLIC, NULL,
+                               ble_gap_test_util_connect_cb, NULL);
+    TEST_ASSERT(rc == BLE_HS_EALREADY);
+
+    /* No peers; ensure nothing is initiated. */
+    ble_gap_test_util_bg_conn_run_events();
+    TEST_ASSERT(!ble_gap_master_in_progress());
+    TEST_ASSERT(ble_hs_test_util_hci_out_first() == NULL);
+
+    rc = ble_gap_bg_conn_stop();
+    TEST_ASSERT(rc == 0);
+
+    ble_hs_test_util_assert_mbufs_freed(NULL);
+}
+
+TEST_CASE_SELF(ble_gap_test_case_bg_conn_good)
+{
+    ble_addr_t peer1 = { BLE_ADDR_PUBLIC, { 1, 2, 3, 4, 5, 6 }};
+    ble_addr_t peer2 = { BLE_ADDR_RANDOM, { 2, 3, 4, 5, 6, 0xc7 }};
+    int rc;
+
+    ble_gap_test_util_bg_conn_init();
+
+    ble_gap_test_util_bg_conn_start(4);
+
+    rc = ble_gap_bg_conn_peer_add(&peer1);
+    TEST_ASSERT_FATAL(rc == 0);
+    rc = ble_gap_bg_conn_peer_add(&peer2);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    /* Ensure both peers are put into white list and connect procedure is
+     * started.
+     */
+    ble_hs_test_util_hci_ack_set(
+        ble_hs_hci_util_opcode_join(BLE_HCI_OGF_LE,
+                                    BLE_HCI_OCF_LE_ADD_WHITE_LIST), 0);
+    ble_hs_test_util_hci_ack_append(
+        ble_hs_hci_util_opcode_join(BLE_HCI_OGF_LE,
+                                    BLE_HCI_OCF_LE_ADD_WHITE_LIST), 0);
+    ble_hs_test_util_hci_ack_append(
+        ble_hs_hci_util_opcode_join(BLE_HCI_OGF_LE,
+                                    BLE_HCI_OCF_LE_CREATE_CONN), 0);
+    ble_gap_test_util_bg_conn_run_events();
+
+    ble_gap_test_util_verify_tx_add_wl(&peer1);
+    ble_gap_test_util_verify_tx_add_wl(&peer2);
+    ble_gap_test_util_verify_tx_bg_create_conn();
+    TEST_ASSERT(ble_gap_master_in_progress());
+
+    /* Connect to second peer; ensure application is notified. */
+    ble_gap_test_util_bg_conn_rx_complete(2, &peer2);
+    TEST_ASSERT(!ble_gap_master_in_progress());
+    TEST_ASSERT(ble_gap_test_event.type == BLE_GAP_EVENT_CONNECT);
+    TEST_ASSERT(ble_gap_test_conn_status == 0);
+    TEST_ASSERT(ble_gap_test_conn_desc.conn_handle == 2);
+    TEST_ASSERT(ble_addr_cmp(&ble_gap_test_conn_desc.peer_id_addr,
+                             &peer2) == 0);
+
+    /* Ensure only connected peer is removed from white list before connect
+     * procedure is re-armed.
+     */
+    ble_hs_test_util_hci_out_clear();
+    ble_hs_test_util_hci_ack_set(
+        ble_hs_hci_util_opcode_join(BLE_HCI_OGF_LE,
+                                    BLE_HCI_OCF_LE_RMV_WHITE_LIST), 0);
+    ble_hs_test_util_hci_ack_append(
+        ble_hs_hci_util_opcode_join(BLE_HCI_OGF_LE,
+                                    BLE_HCI_OCF_LE_CREATE_CONN), 0);
+    ble_gap_test_util_bg_conn_run_events();
+
+    ble_gap_test_util_verify_tx_rmv_wl(&peer2);
+    ble_gap_test_util_verify_tx_bg_create_conn();
+    TEST_ASSERT(ble_gap_master_in_progress());
+
+    /* Peer disconnects; ensure connect procedure is cancelled so that peer
+     * can be put back into white list.
+     */
+    ble_hs_test_util_hci_ack_set(
+        ble_hs_hci_util_opcode_join(BLE_HCI_OGF_LE,
+                                    BLE_HCI_OCF_LE_CREATE_CONN_CANCEL), 0);
+    ble_hs_test_util_hci_rx_disconn_complete_event(2, 0,
+                                                   BLE_ERR_REM_USER_CONN_TERM);
+    TEST_ASSERT(ble_gap_test_event.type == BLE_GAP_EVENT_DISCONNECT);
+    ble_hs_test_util_hci_verify_tx_create_conn_cancel();
+
+    ble_gap_test_util_reset_cb_info();
+    ble_hs_test_util_hci_rx_conn_cancel_evt();
+    TEST_ASSERT(!ble_gap_master_in_progress());
+
+    /* Cancel is not reported to application. */
+    TEST_ASSERT(ble_gap_test_event.type == 0xff);
+
+    ble_hs_test_util_hci_ack_set(
+        ble_hs_hci_util_opcode_join(BLE_HCI_OGF_LE,
+                                    BLE_HCI_OCF_LE_ADD_WHITE_LIST), 0);
+    ble_hs_test_util_hci_ack_append(
+        ble_hs_hci_util_opcode_join(BLE_HCI_OGF_LE,
+                                    BLE_HCI_OCF_LE_CREATE_CONN), 0);
+    ble_gap_test_util_bg_conn_run_events();
+
+    ble_gap_test_util_verify_tx_add_wl(&peer2);
+    ble_gap_test_util_verify_tx_bg_create_conn();
+
+    /* Remove first peer; ensure it is dropped from white list. */
+    ble_hs_test_util_hci_ack_set(
+        ble_hs_hci_util_opcode_join(BLE_HCI_OGF_LE,
+                                    BLE_HCI_OCF_LE_CREATE_CONN_CANCEL), 0);
+    rc = ble_gap_bg_conn_peer_remove(&peer1);
+    TEST_ASSERT(rc == 0);
+    ble_hs_test_util_hci_verify_tx_create_conn_cancel();
+    ble_hs_test_util_hci_rx_conn_cancel_evt();
+
+    ble_hs_test_util_hci_ack_set(
+        ble_hs_hci_util_opcode_join(BLE_HCI_OGF_LE,
+                                    BLE_HCI_OCF_LE_RMV_WHITE_LIST), 0);
+    ble_hs_test_util_hci_ack_append(
+        ble_hs_hci_util_opcode_join(BLE_HCI_OGF_LE,
+                                    BLE_HCI_OCF_LE_CREATE_CONN), 0);
+    ble_gap_test_util_bg_conn_run_events();
+
+    ble_gap_test_util_verify_tx_rmv_wl(&peer1);
+    ble_gap_test_util_verify_tx_bg_create_conn();
+
+    /* Stop; ensure connect procedure is cancelled and not re-armed. */
+    ble_hs_test_util_hci_ack_set(
+        ble_hs_hci_util_opcode_join(BLE_HCI_OGF_LE,
+                                    BLE_HCI_OCF_LE_CREATE_CONN_CANCEL), 0);
+    rc = ble_gap_bg_conn_stop();
+    TEST_ASSERT(rc == 0);
+    ble_hs_test_util_hci_verify_tx_create_conn_cancel();
+    ble_hs_test_util_hci_rx_conn_cancel_evt();
+
+    ble_gap_test_util_bg_conn_run_events();
+    TEST_ASSERT(!ble_gap_master_in_progress());
+    TEST_ASSERT(ble_hs_test_util_hci_out_first() == NULL);
+
+    ble_hs_test_util_assert_mbufs_freed(NULL);
+}
+
+TEST_CASE_SELF(ble_gap_test_case_bg_conn_yield)
+{
+    static const struct ble_gap_disc_params disc_params = { 0 };
+    ble_addr_t peer1 = { BLE_ADDR_PUBLIC, { 1, 2, 3, 4, 5, 6 }};
+    ble_addr_t peer2 = { BLE_ADDR_PUBLIC, { 2, 3, 4, 5, 6, 7 }};
+    int rc;
+
+    ble_gap_test_util_bg_conn_init();
+
+    ble_gap_test_util_bg_conn_start(4);
+
+    rc = ble_gap_bg_conn_peer_add(&peer1);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    ble_hs_test_util_hci_ack_set(
+        ble_hs_hci_util_opcode_join(BLE_HCI_OGF_LE,
+                                    BLE_HCI_OCF_LE_ADD_WHITE_LIST), 0);
+    ble_hs_test_util_hci_ack_append(
+        ble_hs_hci_util_opcode_join(BLE_HCI_OGF_LE,
+                                    BLE_HCI_OCF_LE_CREATE_CONN), 0);
+    ble_gap_test_util_bg_conn_run_events();
+
+    ble_gap_test_util_verify_tx_add_wl(&peer1);
+    ble_gap_test_util_verify_tx_bg_create_conn();
+
+    /*** Background connect can't be cancelled by the application. */
+    rc = ble_gap_conn_cancel();
+    TEST_ASSERT(rc == BLE_HS_EALREADY);
+    TEST_ASSERT(ble_gap_master_in_progress());
+    TEST_ASSERT(ble_hs_test_util_hci_out_first() == NULL);
+
+    /*** Discovery; ensure background connect is cancelled to make room. */
+    ble_hs_test_util_hci_ack_set(
+        ble_hs_hci_util_opcode_join(BLE_HCI_OGF_LE,
+                                    BLE_HCI_OCF_LE_CREATE_CONN_CANCEL), 0);
+    ble_hs_test_util_hci_ack_append(
+        ble_hs_hci_util_opcode_join(BLE_HCI_OGF_LE,
+                                    BLE_HCI_OCF_LE_SET_SCAN_PARAMS), 0);
+    ble_hs_test_util_hci_ack_append(
+        ble_hs_hci_util_opcode_join(BLE_HCI_OGF_LE,
+                                    BLE_HCI_OCF_LE_SET_SCAN_ENABLE), 0);
+    rc = ble_gap_disc(BLE_OWN_ADDR_PUBLIC, BLE_HS_FOREVER, &disc_params,
+                      ble_gap_test_util_disc_cb, NULL);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(ble_gap_disc_active());
+
+    ble_hs_test_util_hci_verify_tx_create_conn_cancel();
+    ble_gap_test_util_verify_tx_set_scan_params(
+        BLE_OWN_ADDR_PUBLIC, BLE_HCI_SCAN_TYPE_ACTIVE,
+        BLE_GAP_SCAN_FAST_INTERVAL_MIN, BLE_GAP_SCAN_FAST_WINDOW,
+        BLE_HCI_SCAN_FILT_NO_WL);
+    ble_gap_test_util_verify_tx_scan_enable(1, 0);
+
+    /* Ensure cancel doesn't affect discovery and isn't reported. */
+    ble_hs_test_util_hci_rx_conn_cancel_evt();
+    TEST_ASSERT(ble_gap_disc_active());
+    TEST_ASSERT(ble_gap_test_event.type == 0xff);
+    TEST_ASSERT(ble_gap_test_disc_event_type == -1);
+
+    /* Not re-armed while discovery is active. */
+    ble_gap_test_util_bg_conn_run_events();
+    TEST_ASSERT(ble_hs_test_util_hci_out_first() == NULL);
+
+    /* Re-armed when discovery is done. */
+    rc = ble_hs_test_util_disc_cancel(0);
+    TEST_ASSERT_FATAL(rc == 0);
+    ble_gap_test_util_verify_tx_scan_enable(0, 0);
+
+    ble_hs_test_util_hci_ack_set(
+        ble_hs_hci_util_opcode_join(BLE_HCI_OGF_LE,
+                                    BLE_HCI_OCF_LE_CREATE_CONN), 0);
+    ble_gap_test_util_bg_conn_run_events();
+    ble_gap_test_util_verify_tx_bg_create_conn();
+    TEST_ASSERT(ble_gap_conn_active());
+
+    /*** Connect by application; ensure it is given the master. */
+    ble_hs_test_util_hci_ack_set(
+        ble_hs_hci_util_opcode_join(BLE_HCI_OGF_LE,
+                                    BLE_HCI_OCF_LE_CREATE_CONN_CANCEL), 0);
+    ble_hs_test_util_hci_ack_append(
+        ble_hs_hci_util_opcode_join(BLE_HCI_OGF_LE,
+                                    BLE_HCI_OCF_LE_CREATE_CONN), 0);
+    rc = ble_gap_connect(BLE_OWN_ADDR_PUBLIC, &peer2, 0, NULL,
+                         ble_gap_test_util_connect_cb, NULL);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    ble_hs_test_util_hci_verify_tx_create_conn_cancel();
+    ble_hs_test_util_hci_verify_tx(BLE_HCI_OGF_LE,
+                                   BLE_HCI_OCF_LE_CREATE_CONN, NULL);
+
+    ble_hs_test_util_hci_rx_conn_cancel_evt();
+    TEST_ASSERT(ble_gap_conn_active());
+    TEST_ASSERT(ble_gap_test_event.type == 0xff);
+
+    ble_gap_test_util_bg_conn_rx_complete(2, &peer2);
+    TEST_ASSERT(ble_gap_test_event.type == BLE_GAP_EVENT_CONNECT);
+    TEST_ASSERT(ble_gap_test_conn_desc.conn_handle == 2);
+
+    /* Background connect resumes. */
+    ble_hs_test_util_hci_out_clear();
+    ble_hs_test_util_hci_ack_set(
+        ble_hs_hci_util_opcode_join(BLE_HCI_OGF_LE,
+                                    BLE_HCI_OCF_LE_CREATE_CONN), 0);
+    ble_gap_test_util_bg_conn_run_events();
+    ble_gap_test_util_verify_tx_bg_create_conn();
+
+    ble_hs_test_util_hci_ack_set(
+        ble_hs_hci_util_opcode_join(BLE_HCI_OGF_LE,
+                                    BLE_HCI_OCF_LE_CREATE_CONN_CANCEL), 0);
+    rc = ble_gap_bg_conn_stop();
+    TEST_ASSERT(rc == 0);
+    ble_hs_test_util_hci_rx_conn_cancel_evt();
+
+    ble_hs_test_util_assert_mbufs_freed(NULL);
+}
+
+TEST_CASE_SELF(ble_gap_test_case_bg_conn_rotate)
+{
+    ble_addr_t peer1 = { BLE_ADDR_PUBLIC, { 1, 2, 3, 4, 5, 6 }};
+    ble_addr_t peer2 = { BLE_ADDR_PUBLIC, { 2, 3, 4, 5, 6, 7 }};
+    int32_t ticks_from_now;
+    int rc;
+
+    ble_gap_test_util_bg_conn_init();
+
+    /* White list fits only one of the peers. */
+    ble_gap_test_util_bg_conn_start(1);
+
+    rc = ble_gap_bg_conn_peer_add(&peer1);
+    TEST_ASSERT_FATAL(rc == 0);
+    rc = ble_gap_bg_conn_peer_add(&peer2);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    ble_hs_test_util_hci_ack_set(
+        ble_hs_hci_util_opcode_join(BLE_HCI_OGF_LE,
+                                    BLE_HCI_OCF_LE_ADD_WHITE_LIST), 0);
+    ble_hs_test_util_hci_ack_append(
+        ble_hs_hci_util_opcode_join(BLE_HCI_OGF_LE,
+                                    BLE_HCI_OCF_LE_CREATE_CONN), 0);
+    ble_gap_test_util_bg_conn_run_events();
+
+    ble_gap_test_util_verify_tx_add_wl(&peer1);
+    ble_gap_test_util_verify_tx_bg_create_conn();
+
+    /* Ensure connect procedure is limited so that second peer gets its
+     * turn.
+     */
+    ticks_from_now = ble_gap_timer();
+    TEST_ASSERT(ticks_from_now ==
+                ble_npl_time_ms_to_ticks32(
+                    MYNEWT_VAL(BLE_GAP_BG_CONN_ROTATE_MS)));
+
+    os_time_advance(ticks_from_now);
+    ble_hs_test_util_hci_ack_set(
+        ble_hs_hci_util_opcode_join(BLE_HCI_OGF_LE,
+                                    BLE_HCI_OCF_LE_CREATE_CONN_CANCEL), 0);
+    ble_gap_timer();
+    ble_hs_test_util_hci_verify_tx_create_conn_cancel();
+    ble_hs_test_util_hci_rx_conn_cancel_evt();
+
+    /* Timeout is not reported to application. */
+    TEST_ASSERT(ble_gap_test_event.type == 0xff);
+
+    ble_hs_test_util_hci_ack_set(
+        ble_hs_hci_util_opcode_join(BLE_HCI_OGF_LE,
+                                    BLE_HCI_OCF_LE_RMV_WHITE_LIST), 0);
+    ble_hs_test_util_hci_ack_append(
+        ble_hs_hci_util_opcode_join(BLE_HCI_OGF_LE,
+                                    BLE_HCI_OCF_LE_ADD_WHITE_LIST), 0);
+    ble_hs_test_util_hci_ack_append(
+        ble_hs_hci_util_opcode_join(BLE_HCI_OGF_LE,
+                                    BLE_HCI_OCF_LE_CREATE_CONN), 0);
+    ble_gap_test_util_bg_conn_run_events();
+
+    ble_gap_test_util_verify_tx_rmv_wl(&peer1);
+    ble_gap_test_util_verify_tx_add_wl(&peer2);
+    ble_gap_test_util_verify_tx_bg_create_conn();
+
+    /* Connect to second peer; ensure first one takes its place and connect
+     * procedure no longer times out.
+     */
+    ble_gap_test_util_bg_conn_rx_complete(2, &peer2);
+    TEST_ASSERT(ble_gap_test_event.type == BLE_GAP_EVENT_CONNECT);
+    TEST_ASSERT(ble_gap_test_conn_desc.conn_handle == 2);
+
+    ble_hs_test_util_hci_out_clear();
+    ble_hs_test_util_hci_ack_set(
+        ble_hs_hci_util_opcode_join(BLE_HCI_OGF_LE,
+                                    BLE_HCI_OCF_LE_RMV_WHITE_LIST), 0);
+    ble_hs_test_util_hci_ack_append(
+        ble_hs_hci_util_opcode_join(BLE_HCI_OGF_LE,
+                                    BLE_HCI_OCF_LE_ADD_WHITE_LIST), 0);
+    ble_hs_test_util_hci_ack_append(
+        ble_hs_hci_util_opcode_join(BLE_HCI_OGF_LE,
+                                    BLE_HCI_OCF_LE_CREATE_CONN), 0);
+    ble_gap_test_util_bg_conn_run_events();
+
+    ble_gap_test_util_verify_tx_rmv_wl(&peer2);
+    ble_gap_test_util_verify_tx_add_wl(&peer1);
+    ble_gap_test_util_verify_tx_bg_create_conn();
+
+    ticks_from_now = ble_gap_timer();
+    TEST_ASSERT(ticks_from_now == BLE_HS_FOREVER);
+
+    ble_hs_test_util_hci_ack_set(
+        ble_hs_hci_util_opcode_join(BLE_HCI_OGF_LE,
+                                    BLE_HCI_OCF_LE_CREATE_CONN_CANCEL), 0);
+    rc = ble_gap_bg_conn_stop();
+    TEST_ASSERT(rc == 0);
+    ble_hs_test_util_hci_rx_conn_cancel_evt();
+
+    ble_hs_test_util_assert_mbufs_freed(NULL);
+}
+
+TEST_CASE_SELF(ble_gap_test_case_bg_conn_app_conn)
+{
+    ble_addr_t peer1 = { BLE_ADDR_PUBLIC, { 1, 2, 3, 4, 5, 6 }};
+    ble_addr_t peer;
+    int rc;
+    int i;
+
+    ble_gap_test_util_bg_conn_init();
+
+    /* Peer is connected by the application. */
+    ble_hs_test_util_create_conn(2, peer1.val, ble_gap_test_util_connect_cb,
+                                 NULL);
+
+    ble_gap_test_util_bg_conn_start(4);
+
+    rc = ble_gap_bg_conn_peer_add(&peer1);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    /* Ensure nothing is initiated for connected peer. */
+    ble_gap_test_util_bg_conn_run_events();
+    TEST_ASSERT(!ble_gap_master_in_progress());
+    TEST_ASSERT(ble_hs_test_util_hci_out_first() == NULL);
+
+    /*** Application connection is lost; ensure peer is picked up. */
+    ble_hs_test_util_hci_rx_disconn_complete_event(2, 0,
+                                                   BLE_ERR_REM_USER_CONN_TERM);
+    TEST_ASSERT(ble_gap_test_event.type == BLE_GAP_EVENT_DISCONNECT);
+
+    ble_hs_test_util_hci_ack_set(
+        ble_hs_hci_util_opcode_join(BLE_HCI_OGF_LE,
+                                    BLE_HCI_OCF_LE_ADD_WHITE_LIST), 0);
+    ble_hs_test_util_hci_ack_append(
+        ble_hs_hci_util_opcode_join(BLE_HCI_OGF_LE,
+                                    BLE_HCI_OCF_LE_CREATE_CONN), 0);
+    ble_gap_test_util_bg_conn_run_events();
+
+    ble_gap_test_util_verify_tx_add_wl(&peer1);
+    ble_gap_test_util_verify_tx_bg_create_conn();
+    TEST_ASSERT(ble_gap_master_in_progress());
+
+    ble_hs_test_util_hci_ack_set(
+        ble_hs_hci_util_opcode_join(BLE_HCI_OGF_LE,
+                                    BLE_HCI_OCF_LE_CREATE_CONN_CANCEL), 0);
+    rc = ble_gap_bg_conn_stop();
+    TEST_ASSERT(rc == 0);
+    ble_hs_test_util_hci_verify_tx_create_conn_cancel();
+    ble_hs_test_util_hci_rx_conn_cancel_evt();
+
+    /*** Peer removed while stopped; ensure its entry is freed. */
+    rc = ble_gap_bg_conn_peer_remove(&peer1);
+    TEST_ASSERT(rc == 0);
+
+    peer = peer1;
+    for (i = 0; i < MYNEWT_VAL(BLE_GAP_BG_CONN_MAX_PEERS); i++) {
+        peer.val[5] = 0x10 + i;
+        rc = ble_gap_bg_conn_peer_add(&peer);
+        TEST_ASSERT(rc == 0);
+    }
+
+    ble_gap_test_util_bg_conn_run_events();
+    TEST_ASSERT(ble_hs_test_util_hci_out_first() == NULL);
+
+    ble_hs_test_util_assert_mbufs_freed(NULL);
+}
+#endif
+
+TEST_SUITE(ble_gap_test_suite_bg_conn)
+{
+#if MYNEWT_VAL(BLE_GAP_BG_CONN_MAX_PEERS)
+    ble_gap_test_case_bg_conn_bad_args();
+    ble_gap_test_case_bg_conn_good();
+    ble_gap_test_case_bg_conn_yield();
+    ble_gap_test_case_bg_conn_rotate();
+    ble_gap_test_case_bg_conn_app_conn();
+#endif
+}
@@ -1272,9 +1272,377 @@ TEST_CASE_SELF(ble_hs_adv_test_case_user_full_payload)
     ble_hs_test_util_assert_mbufs_freed(NULL);
 }
 
+#if MYNEWT_VAL(BLE_HS_ADV_FILTER_MAX_RULES)
+static int ble_hs_adv_test_filter_num_reports;
+
+static int
+ble_hs_adv_test_filter_disc_cb(struct ble_gap_event *event, void *arg)
+{
+    if (event->type == BLE_GAP_EVENT_DISC) {
+        ble_hs_adv_test_filter_num_reports++;
+    }
+
+    return 0;
+}
+
+static void
+ble_hs_adv_test_filter_disc(void)
+{
+    struct ble_gap_disc_params disc_params = { 0 };
+    int rc;
+
+    rc = ble_hs_test_util_disc(BLE_OWN_ADDR_PUBLIC, BLE_HS_FOREVER,
+                               &disc_params, ble_hs_adv_test_filter_disc_cb,
+                               NULL, -1, 0);
+    TEST_ASSERT_FATAL(rc == 0);
+}
+
+/**
+ * Returns 1 if report was delivered to the application.
+ */
+static int
+ble_hs_adv_test_filter_rx(const ble_addr_t *addr, uint8_t event_type,
+                          int8_t rssi, const uint8_t *data, uint8_t data_len)
+{
+    struct ble_gap_disc_desc desc = { 0 };
+    int num_reports;
+
+    desc.event_type = event_type;
+    desc.addr = *addr;
+    desc.direct_addr = *BLE_ADDR_ANY;
+    desc.rssi = rssi;
+    desc.data = (uint8_t *)data;
+    desc.length_data = data_len;
+
+    num_reports = ble_hs_adv_test_filter_num_reports;
+    ble_gap_rx_adv_report(&desc);
+
+    return ble_hs_adv_test_filter_num_reports != num_reports;
+}
+
+TEST_CASE_SELF(ble_hs_adv_test_case_filter_rules)
+{
+    static const uint8_t mfg_prefix[] = { 0x01 };
+    static const ble_addr_t addr_in = {
+        BLE_ADDR_RANDOM, { 0x10, 0x00, 0x00, 0x00, 0x00, 0xc0 }
+    };
+    static const ble_addr_t addr_out = {
+        BLE_ADDR_RANDOM, { 0x11, 0x00, 0x00, 0x00, 0x00, 0xc0 }
+    };
+    struct ble_hs_adv_filter_rule rules[] = {
+        {
+            .type = BLE_HS_ADV_FILTER_TYPE_UUID,
+            .uuid = BLE_UUID16_DECLARE(0x180d),
+        },
+        {
+            .type = BLE_HS_ADV_FILTER_TYPE_MFG,
+            .mfg = { 0x0059, mfg_prefix, sizeof(mfg_prefix) },
+        },
+        {
+            .type = BLE_HS_ADV_FILTER_TYPE_NAME,
+            .name = { "Ther", 4 },
+        },
+        {
+            .type = BLE_HS_ADV_FILTER_TYPE_ADDR,
+            .addr = {
+                { BLE_ADDR_RANDOM, { 0x00, 0x00, 0x00, 0x00, 0x00, 0xc0 } },
+                { BLE_ADDR_RANDOM, { 0x10, 0x00, 0x00, 0x00, 0x00, 0xc0 } },
+            },
+        },
+    };
+    struct ble_hs_adv_filter_params params = {
+        .rules = rules,
+        .num_rules = 4,
+        .rssi_min = -70,
+    };
+    ble_addr_t addr = { BLE_ADDR_PUBLIC, { 1, 2, 3, 4, 5, 6 }};
+    uint32_t misses;
+    uint32_t hits;
+    int rc;
+
+    ble_hs_test_util_init();
+
+    rc = ble_hs_adv_filter_set(&params);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    ble_hs_adv_test_filter_disc();
+
+    /*** Service UUID in list and in service data. */
+    TEST_ASSERT(ble_hs_adv_test_filter_rx(&addr,
+        BLE_HCI_ADV_RPT_EVTYPE_ADV_IND,
+        -50, (uint8_t[]){ 0x02, 0x01, 0x06,
+                          0x05, 0x03, 0x0f, 0x18, 0x0d, 0x18 }, 9));
+    TEST_ASSERT(ble_hs_adv_test_filter_rx(&addr,
+        BLE_HCI_ADV_RPT_EVTYPE_ADV_IND,
+        -50, (uint8_t[]){ 0x04, 0x16, 0x0d, 0x18, 0x55 }, 5));
+    TEST_ASSERT(!ble_hs_adv_test_filter_rx(&addr,
+        BLE_HCI_ADV_RPT_EVTYPE_ADV_IND,
+        -50, (uint8_t[]){ 0x03, 0x03, 0x0f, 0x18 }, 4));
+
+    /*** Manufacturer data prefix. */
+    TEST_ASSERT(ble_hs_adv_test_filter_rx(&addr,
+        BLE_HCI_ADV_RPT_EVTYPE_ADV_IND,
+        -50, (uint8_t[]){ 0x05, 0xff, 0x59, 0x00, 0x01, 0xaa }, 6));
+    TEST_ASSERT(!ble_hs_adv_test_filter_rx(&addr,
+        BLE_HCI_ADV_RPT_EVTYPE_ADV_IND,
+        -50, (uint8_t[]){ 0x05, 0xff, 0x59, 0x00, 0x02, 0xaa }, 6));
+    TEST_ASSERT(!ble_hs_adv_test_filter_rx(&addr,
+        BLE_HCI_ADV_RPT_EVTYPE_ADV_IND,
+        -50, (uint8_t[]){ 0x03, 0xff, 0x59, 0x00 }, 4));
+
+    /*** Name prefix. */
+    TEST_ASSERT(ble_hs_adv_test_filter_rx(&addr,
+        BLE_HCI_ADV_RPT_EVTYPE_ADV_IND,
+        -50, (uint8_t[]){ 0x07, 0x09, 'T', 'h', 'e', 'r', 'm', 'o' }, 8));
+    TEST_ASSERT(!ble_hs_adv_test_filter_rx(&addr,
+        BLE_HCI_ADV_RPT_EVTYPE_ADV_IND,
+        -50, (uint8_t[]){ 0x04, 0x09, 'T', 'h', 'e' }, 5));
+
+    /*** Address range. */
+    TEST_ASSERT(ble_hs_adv_test_filter_rx(&addr_in,
+        BLE_HCI_ADV_RPT_EVTYPE_NONCONN_IND, -50, NULL, 0));
+    TEST_ASSERT(!ble_hs_adv_test_filter_rx(&addr_out,
+        BLE_HCI_ADV_RPT_EVTYPE_NONCONN_IND, -50, NULL, 0));
+
+    /*** RSSI floor. */
+    TEST_ASSERT(!ble_hs_adv_test_filter_rx(&addr_in,
+        BLE_HCI_ADV_RPT_EVTYPE_NONCONN_IND, -71, NULL, 0));
+    TEST_ASSERT(ble_hs_adv_test_filter_rx(&addr_in,
+        BLE_HCI_ADV_RPT_EVTYPE_NONCONN_IND, 127, NULL, 0));
+
+    /*** Malformed data. */
+    TEST_ASSERT(!ble_hs_adv_test_filter_rx(&addr,
+        BLE_HCI_ADV_RPT_EVTYPE_ADV_IND,
+        -50, (uint8_t[]){ 0x05, 0x03, 0x0d, 0x18 }, 4));
+
+    ble_hs_adv_filter_stats(&hits, &misses);
+    TEST_ASSERT(hits == 6);
+    TEST_ASSERT(misses == 7);
+
+    /*** Disabled filter; everything is reported. */
+    rc = ble_hs_adv_filter_set(NULL);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    TEST_ASSERT(ble_hs_adv_test_filter_rx(&addr_out,
+        BLE_HCI_ADV_RPT_EVTYPE_NONCONN_IND, -100, NULL, 0));
+
+    ble_hs_adv_filter_stats(&hits, &misses);
+    TEST_ASSERT(hits == 0);
+    TEST_ASSERT(misses == 0);
+
+    ble_hs_test_util_assert_mbufs_freed(NULL);
+}
+
+TEST_CASE_SELF(ble_hs_adv_test_case_filter_scan_rsp)
+{
+    struct ble_hs_adv_filter_rule rule = {
+        .type = BLE_HS_ADV_FILTER_TYPE_NAME,
+        .name = { "Ther", 4 },
+    };
+    struct ble_hs_adv_filter_params params = {
+        .rules = &rule,
+        .num_rules = 1,
+        .rssi_min = BLE_HS_ADV_FILTER_RSSI_ANY,
+    };
+    ble_addr_t addr1 = { BLE_ADDR_PUBLIC, { 1, 2, 3, 4, 5, 6 }};
+    ble_addr_t addr2 = { BLE_ADDR_PUBLIC, { 2, 2, 3, 4, 5, 6 }};
+    static const uint8_t name[] = { 0x05, 0x09, 'T', 'h', 'e', 'r' };
+    static const uint8_t rsp[] = { 0x03, 0xff, 0x59, 0x00 };
+    int rc;
+
+    ble_hs_test_util_init();
+
+    rc = ble_hs_adv_filter_set(&params);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    ble_hs_adv_test_filter_disc();
+
+    /* Scan response of matching advertiser is reported. */
+    TEST_ASSERT(ble_hs_adv_test_filter_rx(&addr1,
+        BLE_HCI_ADV_RPT_EVTYPE_ADV_IND, -50, name, sizeof(name)));
+    TEST_ASSERT(ble_hs_adv_test_filter_rx(&addr1,
+        BLE_HCI_ADV_RPT_EVTYPE_SCAN_RSP, -50, rsp, sizeof(rsp)));
+
+    /* Scan response of non-matching advertiser is not. */
+    TEST_ASSERT(!ble_hs_adv_test_filter_rx(&addr2,
+        BLE_HCI_ADV_RPT_EVTYPE_ADV_IND, -50, rsp, sizeof(rsp)));
+    TEST_ASSERT(!ble_hs_adv_test_filter_rx(&addr2,
+        BLE_HCI_ADV_RPT_EVTYPE_SCAN_RSP, -50, rsp, sizeof(rsp)));
+
+    /* Advertiser no longer matching is forgotten. */
+    TEST_ASSERT(!ble_hs_adv_test_filter_rx(&addr1,
+        BLE_HCI_ADV_RPT_EVTYPE_ADV_IND, -50, rsp, sizeof(rsp)));
+    TEST_ASSERT(!ble_hs_adv_test_filter_rx(&addr1,
+        BLE_HCI_ADV_RPT_EVTYPE_SCAN_RSP, -50, rsp, sizeof(rsp)));
+
+    rc = ble_hs_adv_filter_set(NULL);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    ble_hs_test_util_assert_mbufs_freed(NULL);
+}
+
+/**
+ * Extended advertising data may be split over several reports. Only the
+ * first fragment is evaluated and the rest of the chain shares its verdict.
+ */
+TEST_CASE_SELF(ble_hs_adv_test_case_filter_ext_frag)
+{
+    struct ble_hs_adv_filter_rule rule = {
+        .type = BLE_HS_ADV_FILTER_TYPE_NAME,
+        .name = { "Ther", 4 },
+    };
+    struct ble_hs_adv_filter_params params = {
+        .rules = &rule,
+        .num_rules = 1,
+        .rssi_min = BLE_HS_ADV_FILTER_RSSI_ANY,
+    };
+    ble_addr_t addr1 = { BLE_ADDR_PUBLIC, { 1, 2, 3, 4, 5, 6 }};
+    ble_addr_t addr2 = { BLE_ADDR_PUBLIC, { 2, 2, 3, 4, 5, 6 }};
+    ble_addr_t addr3 = { BLE_ADDR_PUBLIC, { 3, 2, 3, 4, 5, 6 }};
+    static const uint8_t name[] = { 0x05, 0x09, 'T', 'h', 'e', 'r' };
+    static const uint8_t mfg[] = { 0x03, 0xff, 0x59, 0x00 };
+    int rc;
+    int i;
+
+    ble_hs_test_util_init();
+
+    rc = ble_hs_adv_filter_set(&params);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    /*** Matching first fragment; whole chain is reported. */
+    TEST_ASSERT(ble_hs_adv_filter_rx(&addr1, 1, -50, name, sizeof(name),
+                                     BLE_HS_ADV_FILTER_F_INCOMPLETE));
+    TEST_ASSERT(ble_hs_adv_filter_rx(&addr1, 1, -50, mfg, sizeof(mfg),
+                                     BLE_HS_ADV_FILTER_F_INCOMPLETE));
+    TEST_ASSERT(ble_hs_adv_filter_rx(&addr1, 1, -50, mfg, sizeof(mfg), 0));
+
+    /*** Rejected first fragment; rest of chain is dropped even if it looks
+     * like matching AD structure.
+     */
+    TEST_ASSERT(!ble_hs_adv_filter_rx(&addr2, 1, -50, mfg, sizeof(mfg),
+                                      BLE_HS_ADV_FILTER_F_INCOMPLETE));
+    TEST_ASSERT(!ble_hs_adv_filter_rx(&addr2, 1, -50, name, sizeof(name),
+                                      BLE_HS_ADV_FILTER_F_INCOMPLETE));
+    TEST_ASSERT(!ble_hs_adv_filter_rx(&addr2, 1, -50, name, sizeof(name), 0));
+
+    /* Chain is complete; next report is evaluated on its own. */
+    TEST_ASSERT(ble_hs_adv_filter_rx(&addr2, 1, -50, name, sizeof(name), 0));
+
+    /*** Fragmented scan response of non-matching advertiser which matches
+     * on its own.
+     */
+    TEST_ASSERT(!ble_hs_adv_filter_rx(&addr3, 1, -50, mfg, sizeof(mfg), 0));
+    TEST_ASSERT(ble_hs_adv_filter_rx(&addr3, 1, -50, name, sizeof(name),
+                                     BLE_HS_ADV_FILTER_F_SCAN_RSP |
+                                     BLE_HS_ADV_FILTER_F_INCOMPLETE));
+    TEST_ASSERT(ble_hs_adv_filter_rx(&addr3, 1, -50, mfg, sizeof(mfg),
+                                     BLE_HS_ADV_FILTER_F_SCAN_RSP));
+
+    /*** Rejected fragmented scan response. */
+    TEST_ASSERT(!ble_hs_adv_filter_rx(&addr3, 1, -50, mfg, sizeof(mfg), 0));
+    TEST_ASSERT(!ble_hs_adv_filter_rx(&addr3, 1, -50, mfg, sizeof(mfg),
+                                      BLE_HS_ADV_FILTER_F_SCAN_RSP |
+                                      BLE_HS_ADV_FILTER_F_INCOMPLETE));
+    TEST_ASSERT(!ble_hs_adv_filter_rx(&addr3, 1, -50, name, sizeof(name),
+                                      BLE_HS_ADV_FILTER_F_SCAN_RSP));
+
+    /*** Chains of different advertising sets of one advertiser are
+     * interleaved.
+     */
+    TEST_ASSERT(!ble_hs_adv_filter_rx(&addr1, 1, -50, mfg, sizeof(mfg),
+                                      BLE_HS_ADV_FILTER_F_INCOMPLETE));
+    TEST_ASSERT(ble_hs_adv_filter_rx(&addr1, 2, -50, name, sizeof(name),
+                                     BLE_HS_ADV_FILTER_F_INCOMPLETE));
+    TEST_ASSERT(!ble_hs_adv_filter_rx(&addr1, 1, -50, name, sizeof(name), 0));
+    TEST_ASSERT(ble_hs_adv_filter_rx(&addr1, 2, -50, mfg, sizeof(mfg), 0));
+
+    /*** All entries taken by incomplete chains; ensure none of them is
+     * evicted and new chain is dropped.
+     */
+    for (i = 0; i < MYNEWT_VAL(BLE_HS_ADV_FILTER_CONT_CNT); i++) {
+        TEST_ASSERT(ble_hs_adv_filter_rx(&addr1, 3 + i, -50, name,
+                                         sizeof(name),
+                                         BLE_HS_ADV_FILTER_F_INCOMPLETE));
+    }
+
+    TEST_ASSERT(!ble_hs_adv_filter_rx(&addr2, 1, -50, name, sizeof(name),
+                                      BLE_HS_ADV_FILTER_F_INCOMPLETE));
+    TEST_ASSERT(!ble_hs_adv_filter_rx(&addr2, 1, -50, mfg, sizeof(mfg), 0));
+
+    for (i = 0; i < MYNEWT_VAL(BLE_HS_ADV_FILTER_CONT_CNT); i++) {
+        TEST_ASSERT(ble_hs_adv_filter_rx(&addr1, 3 + i, -50, mfg,
+                                         sizeof(mfg), 0));
+    }
+
+    /* Complete chains make room. */
+    TEST_ASSERT(ble_hs_adv_filter_rx(&addr2, 1, -50, name, sizeof(name),
+                                     BLE_HS_ADV_FILTER_F_INCOMPLETE));
+    TEST_ASSERT(ble_hs_adv_filter_rx(&addr2, 1, -50, mfg, sizeof(mfg), 0));
+
+    rc = ble_hs_adv_filter_set(NULL);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    ble_hs_test_util_assert_mbufs_freed(NULL);
+}
+
+TEST_CASE_SELF(ble_hs_adv_test_case_filter_bad_args)
+{
+    struct ble_hs_adv_filter_rule
+        rules[MYNEWT_VAL(BLE_HS_ADV_FILTER_MAX_RULES) + 1];
+    struct ble_hs_adv_filter_params params = {
+        .rules = rules,
+        .rssi_min = BLE_HS_ADV_FILTER_RSSI_ANY,
+    };
+    int rc;
+    int i;
+
+    ble_hs_test_util_init();
+
+    for (i = 0; i < MYNEWT_VAL(BLE_HS_ADV_FILTER_MAX_RULES) + 1; i++) {
+        rules[i].type = BLE_HS_ADV_FILTER_TYPE_UUID;
+        rules[i].uuid = BLE_UUID16_DECLARE(0x180d);
+    }
+
+    /*** Too many rules. */
+    params.num_rules = MYNEWT_VAL(BLE_HS_ADV_FILTER_MAX_RULES) + 1;
+    rc = ble_hs_adv_filter_set(&params);
+    TEST_ASSERT(rc == BLE_HS_ENOMEM);
+
+    params.num_rules = 1;
+
+    /*** Invalid rule type. */
+    rules[0].type = 0;
+    rc = ble_hs_adv_filter_set(&params);
+    TEST_ASSERT(rc == BLE_HS_EINVAL);
+
+    /*** Empty name prefix. */
+    rules[0].type = BLE_HS_ADV_FILTER_TYPE_NAME;
+    rules[0].name.prefix = "";
+    rules[0].name.prefix_len = 0;
+    rc = ble_hs_adv_filter_set(&params);
+    TEST_ASSERT(rc == BLE_HS_EINVAL);
+
+    /*** Address range of different types. */
+    rules[0].type = BLE_HS_ADV_FILTER_TYPE_ADDR;
+    rules[0].addr.min = *BLE_ADDR_ANY;
+    rules[0].addr.max = *BLE_ADDR_ANY;
+    rules[0].addr.max.type = BLE_ADDR_RANDOM;
+    rc = ble_hs_adv_filter_set(&params);
+    TEST_ASSERT(rc == BLE_HS_EINVAL);
+
+    ble_hs_test_util_assert_mbufs_freed(NULL);
+}
+#endif
+
 TEST_SUITE(ble_hs_adv_test_suite)
 {
     ble_hs_adv_test_case_user();
     ble_hs_adv_test_case_user_rsp();
     ble_hs_adv_test_case_user_full_payload();
+#if MYNEWT_VAL(BLE_HS_ADV_FILTER_MAX_RULES)
+    ble_hs_adv_test_case_filter_rules();
+    ble_hs_adv_test_case_filter_scan_rsp();
+    ble_hs_adv_test_case_filter_ext_frag();
+    ble_hs_adv_test_case_filter_bad_args();
+#endif
 }
@@ -44,6 +44,7 @@ main(int argc, char **argv)
     ble_att_clt_suite();
     ble_att_svr_suite();
     ble_gap_test_suite_adv();
+    ble_gap_test_suite_bg_conn();
     ble_gap_test_suite_conn_cancel();
     ble_gap_test_suite_conn_find();
     ble_gap_test_suite_conn_gen();
@@ -69,6 +70,7 @@ main(int argc, char **argv)
     ble_hs_hci_suite();
     ble_hs_id_test_suite_auto();
     ble_hs_pvcy_test_suite_irk();
+    ble_iso_test_suite();
     ble_l2cap_test_suite();
     ble_os_test_suite();
     ble_sm_gen_test_suite();
@@ -35,6 +35,11 @@ uint8_t g_dev_addr[BLE_DEV_ADDR_LEN];
 static STAILQ_HEAD(, os_mbuf_pkthdr) ble_hs_test_util_prev_tx_queue;
 struct os_mbuf *ble_hs_test_util_prev_tx_cur;
 
+#if MYNEWT_VAL(BLE_ISO)
+static int ble_hs_test_util_iso_tx_rc;
+static int ble_hs_test_util_iso_tx_cnt;
+#endif
+
 int ble_sm_test_store_obj_type;
 union ble_store_key ble_sm_test_store_key;
 union ble_store_value ble_sm_test_store_value;
@@ -1856,6 +1861,34 @@ ble_transport_to_ll_acl_impl(struct os_mbuf *om)
     return 0;
 }
 
+#if MYNEWT_VAL(BLE_ISO)
+void
+ble_hs_test_util_iso_tx_set_rc(int rc)
+{
+    ble_hs_test_util_iso_tx_rc = rc;
+}
+
+int
+ble_hs_test_util_iso_tx_cnt_get(void)
+{
+    return ble_hs_test_util_iso_tx_cnt;
+}
+
+int
+ble_transport_to_ll_iso_impl(struct os_mbuf *om)
+{
+    /* Packet is consumed by transport even if it fails */
+    os_mbuf_free_chain(om);
+
+    if (ble_hs_test_util_iso_tx_rc != 0) {
+        return ble_hs_test_util_iso_tx_rc;
+    }
+
+    ble_hs_test_util_iso_tx_cnt++;
+    return 0;
+}
+#endif
+
 int
 ble_transport_to_ll_cmd_impl(void *buf)
 {
@@ -2000,6 +2033,11 @@ ble_hs_test_util_init_no_sysinit_no_start(void)
     STAILQ_INIT(&ble_hs_test_util_prev_tx_queue);
     ble_hs_test_util_prev_tx_cur = NULL;
 
+#if MYNEWT_VAL(BLE_ISO)
+    ble_hs_test_util_iso_tx_rc = 0;
+    ble_hs_test_util_iso_tx_cnt = 0;
+#endif
+
     ble_hs_hci_set_phony_ack_cb(NULL);
 
     ble_hs_test_util_hci_ack_set_startup();
@@ -99,6 +99,8 @@ struct os_mbuf *ble_hs_test_util_prev_tx_dequeue(void);
 struct os_mbuf *ble_hs_test_util_prev_tx_dequeue_pullup(void);
 int ble_hs_test_util_prev_tx_queue_sz(void);
 void ble_hs_test_util_prev_tx_queue_clear(void);
+void ble_hs_test_util_iso_tx_set_rc(int rc);
+int ble_hs_test_util_iso_tx_cnt_get(void);
 
 void ble_hs_test_util_create_rpa_conn(uint16_t handle, uint8_t own_addr_type,
                                       const uint8_t *our_rpa,
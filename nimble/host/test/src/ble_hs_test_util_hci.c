@@ -596,6 +596,46 @@ ble_hs_test_util_hci_rx_disconn_complete_event(uint16_t conn_handle,
     ble_hs_test_util_hci_rx_evt(buf);
 }
 
+#if MYNEWT_VAL(BLE_ISO_BROADCAST_SOURCE)
+void
+ble_hs_test_util_hci_rx_create_big_complete_event(uint8_t big_handle,
+                                                  uint16_t conn_handle)
+{
+    struct ble_hci_ev_le_subev_create_big_complete *ev;
+    uint8_t buf[BLE_HCI_EVENT_HDR_LEN + sizeof(*ev) + sizeof(uint16_t)];
+
+    memset(buf, 0, sizeof(buf));
+    buf[0] = BLE_HCI_EVCODE_LE_META;
+    buf[1] = sizeof(buf) - BLE_HCI_EVENT_HDR_LEN;
+
+    ev = (void *)(buf + BLE_HCI_EVENT_HDR_LEN);
+    ev->subev_code = BLE_HCI_LE_SUBEV_CREATE_BIG_COMPLETE;
+    ev->big_handle = big_handle;
+    ev->num_bis = 1;
+    put_le16(&ev->conn_handle[0], conn_handle);
+
+    ble_hs_test_util_hci_rx_evt(buf);
+}
+
+void
+ble_hs_test_util_hci_rx_terminate_big_complete_event(uint8_t big_handle,
+                                                     uint8_t reason)
+{
+    struct ble_hci_ev_le_subev_terminate_big_complete *ev;
+    uint8_t buf[BLE_HCI_EVENT_HDR_LEN + sizeof(*ev)];
+
+    buf[0] = BLE_HCI_EVCODE_LE_META;
+    buf[1] = sizeof(*ev);
+
+    ev = (void *)(buf + BLE_HCI_EVENT_HDR_LEN);
+    ev->subev_code = BLE_HCI_LE_SUBEV_TERMINATE_BIG_COMPLETE;
+    ev->big_handle = big_handle;
+    ev->reason = reason;
+
+    ble_hs_test_util_hci_rx_evt(buf);
+}
+#endif
+
 void
 ble_hs_test_util_hci_rx_conn_cancel_evt(void)
 {
@@ -93,6 +93,10 @@ void ble_hs_test_util_hci_rx_num_completed_pkts_event(
 void ble_hs_test_util_hci_rx_disconn_complete_event(uint16_t conn_handle,
                                                     uint8_t status, uint8_t reason);
 void ble_hs_test_util_hci_rx_conn_cancel_evt(void);
+void ble_hs_test_util_hci_rx_create_big_complete_event(uint8_t big_handle,
+                                                       uint16_t conn_handle);
+void ble_hs_test_util_hci_rx_terminate_big_complete_event(uint8_t big_handle,
+                                                          uint8_t reason);
 
 /* $misc */
 int ble_hs_test_util_hci_misc_exp_status(int cmd_idx, int fail_idx,
@@ -0,0 +1,132 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+
+#include <string.h>
+#include "testutil/testutil.h"
+#include "nimble/hci_common.h"
+#include "host/ble_iso.h"
+#include "ble_hs_test.h"
+#include "ble_hs_test_util.h"
+
+#if MYNEWT_VAL(BLE_ISO_BROADCAST_SOURCE)
+
+#define BLE_ISO_TEST_BIS_HANDLE     0x0100
+
+static int
+ble_iso_test_util_cb(struct ble_iso_event *event, void *arg)
+{
+    return 0;
+}
+
+static uint8_t
+ble_iso_test_util_big_create(void)
+{
+    struct ble_iso_create_big_params create_params = {
+        .adv_handle = 0,
+        .bis_cnt = 1,
+        .cb = ble_iso_test_util_cb,
+    };
+    struct ble_iso_big_params big_params = {
+        .sdu_interval = 10000,
+        .max_sdu = 40,
+        .max_transport_latency = 10,
+        .rtn = 2,
+        .phy = BLE_HCI_LE_PHY_2M,
+    };
+    uint8_t big_handle;
+    int rc;
+
+    ble_hs_test_util_hci_ack_set(
+        BLE_HCI_OP(BLE_HCI_OGF_LE, BLE_HCI_OCF_LE_CREATE_BIG), 0);
+
+    rc = ble_iso_create_big(&create_params, &big_params, &big_handle);
+    TEST_ASSERT_FATAL(rc == 0);
+
+    ble_hs_test_util_hci_rx_create_big_complete_event(big_handle,
+                                                      BLE_ISO_TEST_BIS_HANDLE);
+
+    return big_handle;
+}
+
+TEST_CASE_SELF(ble_iso_test_case_tx_transport_fail)
+{
+    struct ble_hs_test_util_hci_num_completed_pkts_entry completed[] = {
+        { BLE_ISO_TEST_BIS_HANDLE, 1 },
+        { 0 },
+    };
+    struct ble_iso_tx_stats stats;
+    uint8_t data[40] = { 0 };
+    uint8_t big_handle;
+    int rc;
+    int i;
+
+    ble_hs_test_util_init();
+
+    big_handle = ble_iso_test_util_big_create();
+
+    /*** Packets rejected by transport are not outstanding. */
+    ble_hs_test_util_iso_tx_set_rc(BLE_HS_ENOMEM);
+    for (i = 0; i < MYNEWT_VAL(BLE_ISO_TX_MAX_OUTSTANDING) + 1; i++) {
+        rc = ble_iso_tx(BLE_ISO_TEST_BIS_HANDLE, data, sizeof(data));
+#if MYNEWT_VAL(BLE_ISO_TX_QUEUE_SIZE) > 0
+        TEST_ASSERT(rc == 0);
+#else
+        TEST_ASSERT(rc == BLE_HS_ENOMEM);
+#endif
+    }
+
+    rc = ble_iso_tx_stats_get(BLE_ISO_TEST_BIS_HANDLE, &stats);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(stats.outstanding == 0);
+#if MYNEWT_VAL(BLE_ISO_TX_QUEUE_SIZE) > 0
+    TEST_ASSERT(stats.queued == 0);
+    TEST_ASSERT(stats.dropped == MYNEWT_VAL(BLE_ISO_TX_MAX_OUTSTANDING) + 1);
+#endif
+
+    /*** Transmission continues once transport recovers. */
+    ble_hs_test_util_iso_tx_set_rc(0);
+    rc = ble_iso_tx(BLE_ISO_TEST_BIS_HANDLE, data, sizeof(data));
+    TEST_ASSERT(rc == 0);
+    TEST_ASSERT(ble_hs_test_util_iso_tx_cnt_get() == 1);
+
+    rc = ble_iso_tx_stats_get(BLE_ISO_TEST_BIS_HANDLE, &stats);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(stats.outstanding == 1);
+
+    ble_hs_test_util_hci_rx_num_completed_pkts_event(completed);
+
+    rc = ble_iso_tx_stats_get(BLE_ISO_TEST_BIS_HANDLE, &stats);
+    TEST_ASSERT_FATAL(rc == 0);
+    TEST_ASSERT(stats.outstanding == 0);
+    TEST_ASSERT(stats.completed == 1);
+
+    ble_hs_test_util_hci_rx_terminate_big_complete_event(
+        big_handle, BLE_ERR_CONN_TERM_LOCAL);
+
+    ble_hs_test_util_assert_mbufs_freed(NULL);
+}
+#endif
+
+TEST_SUITE(ble_iso_test_suite)
+{
+#if MYNEWT_VAL(BLE_ISO_BROADCAST_SOURCE)
+    ble_iso_test_case_tx_transport_fail();
+#endif
+}
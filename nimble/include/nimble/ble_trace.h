@@ -0,0 +1,160 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#ifndef H_BLE_TRACE_
+#define H_BLE_TRACE_
+
+/*
+ * Binary trace buffer shared by controller and host.
+ *
+ * Each tracepoint stores fixed size record (timestamp, event id and up to 3
+ * arguments) in RAM ring buffer. Recording is safe from both ISR and task
+ * context and does no formatting so it can be left enabled in production
+ * builds. Buffer can be read with ble_trace_walk() or dumped to file with
+ * ble_trace_dump_file() and decoded with tools/ble_trace/ble_trace_decode.py.
+ */
+
+#include <stdint.h>
+#include "syscfg/syscfg.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Event ID ranges, each layer defines its own IDs within range */
+#define BLE_TRACE_ID_LL_BASE        0x0000
+#define BLE_TRACE_ID_HS_BASE        0x0100
+
+#define BLE_TRACE_ID_LL(_id)        (BLE_TRACE_ID_LL_BASE + (_id))
+#define BLE_TRACE_ID_HS(_id)        (BLE_TRACE_ID_HS_BASE + (_id))
+
+/* Dump file format */
+#define BLE_TRACE_FILE_MAGIC        0x5254424e  /* "NBTR" */
+#define BLE_TRACE_FILE_VERSION      1
+
+struct ble_trace_rec {
+    uint32_t timestamp;
+    uint16_t id;
+    uint8_t nargs;
+    uint8_t _pad;
+    uint32_t args[3];
+};
+
+/**
+ * Called for each record by ble_trace_walk().
+ *
+ * @param rec   Trace record
+ * @param arg   User argument
+ *
+ * @return 0 to continue, non-zero to stop walk
+ */
+typedef int ble_trace_walk_fn(const struct ble_trace_rec *rec, void *arg);
+
+#if MYNEWT_VAL(BLE_TRACE)
+
+void ble_trace_rec(uint16_t id, uint8_t nargs, uint32_t p1, uint32_t p2,
+                   uint32_t p3);
+
+/**
+ * Walks over trace buffer, from oldest to newest record.
+ *
+ * Records are not removed from buffer. Records may be overwritten by new ones
+ * while walking, for consistent output tracing should be idle.
+ *
+ * @param cb    Callback called for each record
+ * @param arg   Callback argument
+ *
+ * @return Number of records walked
+ */
+int ble_trace_walk(ble_trace_walk_fn *cb, void *arg);
+
+/**
+ * Returns frequency (in Hz) of timestamps stored in trace records.
+ */
+uint32_t ble_trace_timestamp_freq(void);
+
+/**
+ * Drops all records from trace buffer.
+ */
+void ble_trace_clear(void);
+
+#if MYNEWT_VAL(BLE_TRACE_DUMP_FILE)
+/**
+ * Writes content of trace buffer to binary file.
+ *
+ * @param path  Path of file to be created or overwritten
+ *
+ * @return 0 on success, -1 on error
+ */
+int ble_trace_dump_file(const char *path);
+#endif
+
+static inline void
+ble_trace_void(uint16_t id)
+{
+    ble_trace_rec(id, 0, 0, 0, 0);
+}
+
+static inline void
+ble_trace_u32(uint16_t id, uint32_t p1)
+{
+    ble_trace_rec(id, 1, p1, 0, 0);
+}
+
+static inline void
+ble_trace_u32x2(uint16_t id, uint32_t p1, uint32_t p2)
+{
+    ble_trace_rec(id, 2, p1, p2, 0);
+}
+
+static inline void
+ble_trace_u32x3(uint16_t id, uint32_t p1, uint32_t p2, uint32_t p3)
+{
+    ble_trace_rec(id, 3, p1, p2, p3);
+}
+
+#else
+
+static inline void
+ble_trace_void(uint16_t id)
+{
+}
+
+static inline void
+ble_trace_u32(uint16_t id, uint32_t p1)
+{
+}
+
+static inline void
+ble_trace_u32x2(uint16_t id, uint32_t p1, uint32_t p2)
+{
+}
+
+static inline void
+ble_trace_u32x3(uint16_t id, uint32_t p1, uint32_t p2, uint32_t p3)
+{
+}
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* H_BLE_TRACE_ */
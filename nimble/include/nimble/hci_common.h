@@ -2458,7 +2458,7 @@ struct hci_data_hdr
 
 #define BLE_HCI_ISO_PKT_STATUS_VALID    0x00
 #define BLE_HCI_ISO_PKT_STATUS_INVALID  0x01
-#define BLE_HCI_ISO_PKT_STATUS_LOST     0x10
+#define BLE_HCI_ISO_PKT_STATUS_LOST     0x02
 
 #define BLE_HCI_ISO_BIG_HANDLE_MIN      0x00
 #define BLE_HCI_ISO_BIG_HANDLE_MAX      0xEF
@@ -0,0 +1,190 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "syscfg/syscfg.h"
+#include "nimble/nimble_npl.h"
+#include "nimble/ble_trace.h"
+
+#if MYNEWT_VAL(BLE_TRACE)
+
+#if MYNEWT_VAL(BLE_TRACE_DUMP_FILE)
+#include <stdio.h>
+#include "os/endian.h"
+#endif
+#if MYNEWT_VAL(BLE_CONTROLLER)
+#include "os/os_cputime.h"
+#endif
+
+#define BLE_TRACE_BUF_SIZE      MYNEWT_VAL(BLE_TRACE_BUF_SIZE)
+#define BLE_TRACE_BUF_MASK      (BLE_TRACE_BUF_SIZE - 1)
+
+#if (BLE_TRACE_BUF_SIZE & BLE_TRACE_BUF_MASK) != 0
+#error "BLE_TRACE_BUF_SIZE shall be power of 2"
+#endif
+
+static struct ble_trace_rec g_ble_trace_buf[BLE_TRACE_BUF_SIZE];
+
+/* Number of records written so far, old records are overwritten */
+static uint32_t g_ble_trace_head;
+
+static inline uint32_t
+ble_trace_timestamp(void)
+{
+    /* Use controller timer if available for better resolution */
+#if MYNEWT_VAL(BLE_CONTROLLER)
+    return os_cputime_get32();
+#else
+    return ble_npl_time_get();
+#endif
+}
+
+uint32_t
+ble_trace_timestamp_freq(void)
+{
+#if MYNEWT_VAL(BLE_CONTROLLER)
+    return MYNEWT_VAL(OS_CPUTIME_FREQ);
+#else
+    return ble_npl_time_ms_to_ticks32(1000);
+#endif
+}
+
+void
+ble_trace_rec(uint16_t id, uint8_t nargs, uint32_t p1, uint32_t p2,
+              uint32_t p3)
+{
+    struct ble_trace_rec *rec;
+    uint32_t sr;
+    uint32_t idx;
+
+    /*
+     * Only slot allocation needs to be atomic, record is then filled without
+     * blocking anyone. If we are preempted while filling record, preempting
+     * context simply uses next slot.
+     */
+    sr = ble_npl_hw_enter_critical();
+    idx = g_ble_trace_head++;
+    ble_npl_hw_exit_critical(sr);
+
+    rec = &g_ble_trace_buf[idx & BLE_TRACE_BUF_MASK];
+    rec->timestamp = ble_trace_timestamp();
+    rec->id = id;
+    rec->nargs = nargs;
+    rec->args[0] = p1;
+    rec->args[1] = p2;
+    rec->args[2] = p3;
+}
+
+int
+ble_trace_walk(ble_trace_walk_fn *cb, void *arg)
+{
+    uint32_t head;
+    uint32_t idx;
+    int cnt;
+
+    head = g_ble_trace_head;
+    if (head > BLE_TRACE_BUF_SIZE) {
+        idx = head - BLE_TRACE_BUF_SIZE;
+    } else {
+        idx = 0;
+    }
+
+    cnt = 0;
+    while (idx != head) {
+        cnt++;
+        if (cb(&g_ble_trace_buf[idx & BLE_TRACE_BUF_MASK], arg)) {
+            break;
+        }
+        idx++;
+    }
+
+    return cnt;
+}
+
+void
+ble_trace_clear(void)
+{
+    uint32_t sr;
+
+    sr = ble_npl_hw_enter_critical();
+    g_ble_trace_head = 0;
+    ble_npl_hw_exit_critical(sr);
+}
+
+#if MYNEWT_VAL(BLE_TRACE_DUMP_FILE)
+static int
+ble_trace_dump_file_rec(const struct ble_trace_rec *rec, void *arg)
+{
+    uint8_t buf[20];
+    FILE *f = arg;
+
+    put_le32(&buf[0], rec->timestamp);
+    put_le16(&buf[4], rec->id);
+    buf[6] = rec->nargs;
+    buf[7] = 0;
+    put_le32(&buf[8], rec->args[0]);
+    put_le32(&buf[12], rec->args[1]);
+    put_le32(&buf[16], rec->args[2]);
+
+    return fwrite(buf, sizeof(buf), 1, f) != 1;
+}
+
+int
+ble_trace_dump_file(const char *path)
+{
+    uint8_t hdr[16];
+    uint32_t head;
+    uint32_t cnt;
+    FILE *f;
+    int rc;
+
+    f = fopen(path, "wb");
+    if (!f) {
+        return -1;
+    }
+
+    head = g_ble_trace_head;
+    cnt = head > BLE_TRACE_BUF_SIZE ? BLE_TRACE_BUF_SIZE : head;
+
+    /* Header: magic, version, reserved, timestamp frequency, records count */
+    put_le32(&hdr[0], BLE_TRACE_FILE_MAGIC);
+    hdr[4] = BLE_TRACE_FILE_VERSION;
+    memset(&hdr[5], 0, 3);
+    put_le32(&hdr[8], ble_trace_timestamp_freq());
+    put_le32(&hdr[12], cnt);
+
+    rc = fwrite(hdr, sizeof(hdr), 1, f) != 1;
+    if (rc == 0) {
+        /* Count may be off if records were added meanwhile, decoder shall
+         * read records until end of file.
+         */
+        ble_trace_walk(ble_trace_dump_file_rec, f);
+        rc = ferror(f);
+    }
+
+    if (fclose(f) || rc) {
+        return -1;
+    }
+
+    return 0;
+}
+#endif
+
+#endif
@@ -27,9 +27,11 @@ extern "C" {
 #endif
 
 #define BLE_MONITOR     (MYNEWT_VAL(BLE_MONITOR_RTT) || \
-                         MYNEWT_VAL(BLE_MONITOR_UART))
+                         MYNEWT_VAL(BLE_MONITOR_UART) || \
+                         MYNEWT_VAL(BLE_MONITOR_FILE))
 
 #if BLE_MONITOR
+void ble_monitor_init(void);
 int ble_monitor_out(int c);
 int ble_monitor_log(int level, const char *fmt, ...);
 #else
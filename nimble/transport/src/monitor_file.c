@@ -0,0 +1,564 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+
+/*
+ * Capture of HCI traffic to btsnoop or pcap file.
+ *
+ * Packets are copied (directly from mbuf chains, without intermediate
+ * buffer) into ring buffer by host and transport. Ring is drained by
+ * dedicated writer thread which formats records and does all file I/O, so
+ * neither host nor transport is ever blocked by file operations. Producers
+ * are serialized with short lock, the writer is lock-free with respect to
+ * producers.
+ */
+
+#include <syscfg/syscfg.h>
+
+#if MYNEWT_VAL(BLE_MONITOR_FILE)
+
+#include <assert.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <os/endian.h>
+#include <os/os_mbuf.h>
+#include <nimble/hci_common.h>
+#include <nimble/transport.h>
+#include "monitor_priv.h"
+
+#define MONITOR_FILE_BUF_SIZE   MYNEWT_VAL(BLE_MONITOR_FILE_BUFFER_SIZE)
+#define MONITOR_FILE_BUF_MASK   (MONITOR_FILE_BUF_SIZE - 1)
+
+#if (MONITOR_FILE_BUF_SIZE & MONITOR_FILE_BUF_MASK) != 0
+#error "BLE_MONITOR_FILE_BUFFER_SIZE shall be power of 2"
+#endif
+
+/* Microseconds between 0000-01-01 and 1970-01-01, as used by btsnoop */
+#define BTSNOOP_EPOCH_DELTA     0x00dcddb30f2f8000ULL
+#define BTSNOOP_DLT_MONITOR     2001
+
+#define PCAP_MAGIC              0xa1b2c3d4
+#define PCAP_SNAPLEN            0xffff
+#define PCAP_DLT_H4_WITH_PHDR   201
+
+#define H4_CMD                  0x01
+#define H4_ACL                  0x02
+#define H4_EVT                  0x04
+#define H4_ISO                  0x05
+
+/* Queued packet, followed by data in ring */
+struct monitor_file_rec {
+    uint64_t ts;
+    uint16_t opcode;
+    uint16_t len;
+    uint32_t drops;
+};
+
+struct pcap_hdr {
+    uint32_t magic;
+    uint16_t version_major;
+    uint16_t version_minor;
+    int32_t thiszone;
+    uint32_t sigfigs;
+    uint32_t snaplen;
+    uint32_t network;
+};
+
+struct pcap_rec_hdr {
+    uint32_t ts_sec;
+    uint32_t ts_usec;
+    uint32_t incl_len;
+    uint32_t orig_len;
+    /* LINKTYPE_BLUETOOTH_HCI_H4_WITH_PHDR pseudo header and H4 type */
+    uint8_t direction[4];
+    uint8_t h4;
+} __attribute__((packed));
+
+static struct {
+    uint8_t buf[MONITOR_FILE_BUF_SIZE];
+    /* Free running counters, updated by producers and writer respectively */
+    uint32_t head;
+    uint32_t tail;
+    /* Position of data written by current producer (not yet visible) */
+    uint32_t wr;
+    uint32_t drops;
+    pthread_mutex_t lock;
+    sem_t sem;
+    pthread_t thread;
+    FILE *f;
+    size_t f_size;
+} monitor_file;
+
+static void
+ring_put(const void *data, size_t len)
+{
+    uint32_t idx = monitor_file.wr & MONITOR_FILE_BUF_MASK;
+    size_t chunk;
+
+    chunk = MONITOR_FILE_BUF_SIZE - idx;
+    if (chunk > len) {
+        chunk = len;
+    }
+
+    memcpy(&monitor_file.buf[idx], data, chunk);
+    memcpy(monitor_file.buf, (const uint8_t *)data + chunk, len - chunk);
+
+    monitor_file.wr += len;
+}
+
+static void
+ring_get(uint32_t pos, void *data, size_t len)
+{
+    uint32_t idx = pos & MONITOR_FILE_BUF_MASK;
+    size_t chunk;
+
+    chunk = MONITOR_FILE_BUF_SIZE - idx;
+    if (chunk > len) {
+        chunk = len;
+    }
+
+    memcpy(data, &monitor_file.buf[idx], chunk);
+    memcpy((uint8_t *)data + chunk, monitor_file.buf, len - chunk);
+}
+
+static void
+ring_fwrite(uint32_t pos, size_t len)
+{
+    uint32_t idx = pos & MONITOR_FILE_BUF_MASK;
+    size_t chunk;
+
+    chunk = MONITOR_FILE_BUF_SIZE - idx;
+    if (chunk > len) {
+        chunk = len;
+    }
+
+    fwrite(&monitor_file.buf[idx], 1, chunk, monitor_file.f);
+    fwrite(monitor_file.buf, 1, len - chunk, monitor_file.f);
+}
+
+/*
+ * Starts new packet in ring, shall be followed by ring_put() of exactly
+ * 'len' bytes and monitor_file_commit(). Returns 0 if there is no space in
+ * ring buffer and packet shall be dropped.
+ */
+static int
+monitor_file_start(uint16_t opcode, uint16_t len)
+{
+    struct monitor_file_rec rec;
+    struct timespec ts;
+    uint32_t tail;
+
+    pthread_mutex_lock(&monitor_file.lock);
+
+    tail = __atomic_load_n(&monitor_file.tail, __ATOMIC_ACQUIRE);
+    if (monitor_file.head - tail + sizeof(rec) + len > MONITOR_FILE_BUF_SIZE) {
+        monitor_file.drops++;
+        pthread_mutex_unlock(&monitor_file.lock);
+        return 0;
+    }
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+
+    rec.ts = (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+    rec.opcode = opcode;
+    rec.len = len;
+    rec.drops = monitor_file.drops;
+
+    monitor_file.wr = monitor_file.head;
+    ring_put(&rec, sizeof(rec));
+
+    return 1;
+}
+
+static void
+monitor_file_commit(void)
+{
+    __atomic_store_n(&monitor_file.head, monitor_file.wr, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&monitor_file.lock);
+
+    sem_post(&monitor_file.sem);
+}
+
+static void
+monitor_file_write_hdr(void)
+{
+#if MYNEWT_VAL_CHOICE(BLE_MONITOR_FILE_FORMAT, pcap)
+    /* pcap uses host byte order, readers detect it from magic */
+    struct pcap_hdr hdr = {
+        .magic = PCAP_MAGIC,
+        .version_major = 2,
+        .version_minor = 4,
+        .snaplen = PCAP_SNAPLEN,
+        .network = PCAP_DLT_H4_WITH_PHDR,
+    };
+#else
+    uint8_t hdr[16];
+
+    memcpy(hdr, "btsnoop", 8);
+    put_be32(&hdr[8], 1);
+    put_be32(&hdr[12], BTSNOOP_DLT_MONITOR);
+#endif
+
+    fwrite(&hdr, 1, sizeof(hdr), monitor_file.f);
+    monitor_file.f_size = sizeof(hdr);
+}
+
+static void
+monitor_file_open(void)
+{
+    monitor_file.f = fopen(MYNEWT_VAL(BLE_MONITOR_FILE_PATH), "wb");
+    if (monitor_file.f) {
+        monitor_file_write_hdr();
+    }
+}
+
+#if MYNEWT_VAL(BLE_MONITOR_FILE_MAX_SIZE)
+static void
+monitor_file_rotate(void)
+{
+    char from[256];
+    char to[256];
+    int i;
+
+    fclose(monitor_file.f);
+
+    /* path.N-1 -> path.N, ..., path -> path.1 */
+    for (i = MYNEWT_VAL(BLE_MONITOR_FILE_ROTATE_CNT); i > 0; i--) {
+        if (i > 1) {
+            snprintf(from, sizeof(from), "%s.%d",
+                     MYNEWT_VAL(BLE_MONITOR_FILE_PATH), i - 1);
+        } else {
+            snprintf(from, sizeof(from), "%s",
+                     MYNEWT_VAL(BLE_MONITOR_FILE_PATH));
+        }
+        snprintf(to, sizeof(to), "%s.%d", MYNEWT_VAL(BLE_MONITOR_FILE_PATH), i);
+        rename(from, to);
+    }
+
+    monitor_file_open();
+}
+#endif
+
+/* Returns length of record header written to file, 0 if record is skipped */
+static size_t
+monitor_file_write_rec_hdr(const struct monitor_file_rec *rec)
+{
+#if MYNEWT_VAL_CHOICE(BLE_MONITOR_FILE_FORMAT, pcap)
+    struct pcap_rec_hdr hdr;
+    uint8_t h4;
+    uint8_t dir;
+
+    switch (rec->opcode) {
+    case BLE_MONITOR_OPCODE_COMMAND_PKT:
+        h4 = H4_CMD;
+        dir = 0;
+        break;
+    case BLE_MONITOR_OPCODE_EVENT_PKT:
+        h4 = H4_EVT;
+        dir = 1;
+        break;
+    case BLE_MONITOR_OPCODE_ACL_TX_PKT:
+        h4 = H4_ACL;
+        dir = 0;
+        break;
+    case BLE_MONITOR_OPCODE_ACL_RX_PKT:
+        h4 = H4_ACL;
+        dir = 1;
+        break;
+    case BLE_MONITOR_OPCODE_ISO_TX_PKT:
+        h4 = H4_ISO;
+        dir = 0;
+        break;
+    case BLE_MONITOR_OPCODE_ISO_RX_PKT:
+        h4 = H4_ISO;
+        dir = 1;
+        break;
+    default:
+        /* Only HCI packets can be stored in pcap */
+        return 0;
+    }
+
+    hdr.ts_sec = rec->ts / 1000000;
+    hdr.ts_usec = rec->ts % 1000000;
+    hdr.incl_len = rec->len + sizeof(hdr.direction) + sizeof(hdr.h4);
+    hdr.orig_len = hdr.incl_len;
+    put_be32(hdr.direction, dir);
+    hdr.h4 = h4;
+#else
+    uint8_t hdr[24];
+
+    put_be32(&hdr[0], rec->len);
+    put_be32(&hdr[4], rec->len);
+    put_be32(&hdr[8], rec->opcode);
+    put_be32(&hdr[12], rec->drops);
+    put_be64(&hdr[16], rec->ts + BTSNOOP_EPOCH_DELTA);
+#endif
+
+#if MYNEWT_VAL(BLE_MONITOR_FILE_MAX_SIZE)
+    if (monitor_file.f_size + sizeof(hdr) + rec->len >
+        MYNEWT_VAL(BLE_MONITOR_FILE_MAX_SIZE)) {
+        monitor_file_rotate();
+        if (!monitor_file.f) {
+            return 0;
+        }
+    }
+#endif
+
+    fwrite(&hdr, 1, sizeof(hdr), monitor_file.f);
+
+    return sizeof(hdr);
+}
+
+static void *
+monitor_file_thread(void *arg)
+{
+    struct monitor_file_rec rec;
+    uint32_t head;
+    uint32_t tail;
+    size_t len;
+
+    while (1) {
+        sem_wait(&monitor_file.sem);
+
+        head = __atomic_load_n(&monitor_file.head, __ATOMIC_ACQUIRE);
+        tail = monitor_file.tail;
+
+        while (tail != head) {
+            ring_get(tail, &rec, sizeof(rec));
+            tail += sizeof(rec);
+
+            if (monitor_file.f) {
+                len = monitor_file_write_rec_hdr(&rec);
+                if (len) {
+                    ring_fwrite(tail, rec.len);
+                    monitor_file.f_size += len + rec.len;
+                }
+            }
+
+            tail += rec.len;
+            __atomic_store_n(&monitor_file.tail, tail, __ATOMIC_RELEASE);
+        }
+
+        /* Flush only when idle so file is written in large chunks */
+        if (monitor_file.f &&
+            __atomic_load_n(&monitor_file.head, __ATOMIC_ACQUIRE) == tail) {
+            fflush(monitor_file.f);
+        }
+    }
+
+    return NULL;
+}
+
+void
+ble_monitor_init(void)
+{
+    int rc;
+
+    rc = pthread_mutex_init(&monitor_file.lock, NULL);
+    assert(rc == 0);
+    rc = sem_init(&monitor_file.sem, 0, 0);
+    assert(rc == 0);
+
+    monitor_file_open();
+
+    rc = pthread_create(&monitor_file.thread, NULL, monitor_file_thread, NULL);
+    assert(rc == 0);
+
+    ble_monitor_new_index(0, (uint8_t[6]){ }, "nimble0");
+}
+
+int
+ble_monitor_send(uint16_t opcode, const void *data, size_t len)
+{
+    if (!monitor_file_start(opcode, len)) {
+        return -1;
+    }
+
+    ring_put(data, len);
+    monitor_file_commit();
+
+    return 0;
+}
+
+int
+ble_monitor_send_om(uint16_t opcode, const struct os_mbuf *om)
+{
+    if (!monitor_file_start(opcode, OS_MBUF_PKTLEN(om))) {
+        return -1;
+    }
+
+    while (om) {
+        ring_put(om->om_data, om->om_len);
+        om = SLIST_NEXT(om, om_next);
+    }
+
+    monitor_file_commit();
+
+    return 0;
+}
+
+int
+ble_monitor_new_index(uint8_t bus, uint8_t *addr, const char *name)
+{
+    struct ble_monitor_new_index pkt;
+
+    pkt.type = 0; /* Primary controller, we don't support other */
+    pkt.bus = bus;
+    memcpy(pkt.bdaddr, addr, 6);
+    strncpy(pkt.name, name, sizeof(pkt.name) - 1);
+    pkt.name[sizeof(pkt.name) - 1] = '\0';
+
+    return ble_monitor_send(BLE_MONITOR_OPCODE_NEW_INDEX, &pkt, sizeof(pkt));
+}
+
+int
+ble_monitor_log(int level, const char *fmt, ...)
+{
+    static const char id[] = "nimble";
+    struct ble_monitor_user_logging ulog;
+    char buf[MYNEWT_VAL(BLE_MONITOR_CONSOLE_BUFFER_SIZE)];
+    va_list va;
+    int len;
+
+    va_start(va, fmt);
+    len = vsnprintf(buf, sizeof(buf), fmt, va);
+    va_end(va);
+
+    if (len < 0) {
+        return -1;
+    }
+    if (len >= (int)sizeof(buf)) {
+        len = sizeof(buf) - 1;
+    }
+
+    /* Same mapping as log levels (debug, info, warn, error) to syslog */
+    switch (level) {
+    case 0:
+        ulog.priority = 7;
+        break;
+    case 1:
+        ulog.priority = 6;
+        break;
+    case 2:
+        ulog.priority = 4;
+        break;
+    case 3:
+        ulog.priority = 3;
+        break;
+    default:
+        ulog.priority = 8;
+        break;
+    }
+
+    ulog.ident_len = sizeof(id);
+
+    if (!monitor_file_start(BLE_MONITOR_OPCODE_USER_LOGGING,
+                            sizeof(ulog) + sizeof(id) + len + 1)) {
+        return -1;
+    }
+
+    ring_put(&ulog, sizeof(ulog));
+    ring_put(id, sizeof(id));
+    ring_put(buf, len + 1);
+    monitor_file_commit();
+
+    return 0;
+}
+
+int
+ble_monitor_out(int c)
+{
+    static char buf[MYNEWT_VAL(BLE_MONITOR_CONSOLE_BUFFER_SIZE)];
+    static size_t len;
+
+    if (c != '\n') {
+        buf[len++] = c;
+
+        if (len < sizeof(buf) - 1) {
+            return c;
+        }
+    }
+
+    buf[len++] = '\0';
+
+    ble_monitor_send(BLE_MONITOR_OPCODE_SYSTEM_NOTE, buf, len);
+    len = 0;
+
+    return c;
+}
+
+int
+ble_transport_to_ll_cmd(void *buf)
+{
+    struct ble_hci_cmd *cmd = buf;
+
+    ble_monitor_send(BLE_MONITOR_OPCODE_COMMAND_PKT, buf, cmd->length +
+                                                          sizeof(*cmd));
+
+    return ble_transport_to_ll_cmd_impl(buf);
+}
+
+int
+ble_transport_to_ll_acl(struct os_mbuf *om)
+{
+    ble_monitor_send_om(BLE_MONITOR_OPCODE_ACL_TX_PKT, om);
+
+    return ble_transport_to_ll_acl_impl(om);
+}
+
+int
+ble_transport_to_ll_iso(struct os_mbuf *om)
+{
+    ble_monitor_send_om(BLE_MONITOR_OPCODE_ISO_TX_PKT, om);
+
+    return ble_transport_to_ll_iso_impl(om);
+}
+
+int
+ble_transport_to_hs_acl(struct os_mbuf *om)
+{
+    ble_monitor_send_om(BLE_MONITOR_OPCODE_ACL_RX_PKT, om);
+
+    return ble_transport_to_hs_acl_impl(om);
+}
+
+int
+ble_transport_to_hs_evt(void *buf)
+{
+    struct ble_hci_ev *ev = buf;
+
+    ble_monitor_send(BLE_MONITOR_OPCODE_EVENT_PKT, buf, ev->length +
+                                                        sizeof(*ev));
+
+    return ble_transport_to_hs_evt_impl(buf);
+}
+
+int
+ble_transport_to_hs_iso(struct os_mbuf *om)
+{
+    ble_monitor_send_om(BLE_MONITOR_OPCODE_ISO_RX_PKT, om);
+
+    return ble_transport_to_hs_iso_impl(om);
+}
+
+#endif /* MYNEWT_VAL(BLE_MONITOR_FILE) */
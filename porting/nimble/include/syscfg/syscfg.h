@@ -513,6 +513,18 @@
 #define MYNEWT_VAL_BLE_ROLE_PERIPHERAL (1)
 #endif
 
+#ifndef MYNEWT_VAL_BLE_TRACE
+#define MYNEWT_VAL_BLE_TRACE (0)
+#endif
+
+#ifndef MYNEWT_VAL_BLE_TRACE_BUF_SIZE
+#define MYNEWT_VAL_BLE_TRACE_BUF_SIZE (256)
+#endif
+
+#ifndef MYNEWT_VAL_BLE_TRACE_DUMP_FILE
+#define MYNEWT_VAL_BLE_TRACE_DUMP_FILE (0)
+#endif
+
 #ifndef MYNEWT_VAL_BLE_VERSION
 #define MYNEWT_VAL_BLE_VERSION (50)
 #endif
@@ -1055,6 +1067,37 @@
 #define MYNEWT_VAL_BLE_MONITOR_CONSOLE_BUFFER_SIZE (128)
 #endif
 
+#ifndef MYNEWT_VAL_BLE_MONITOR_FILE
+#define MYNEWT_VAL_BLE_MONITOR_FILE (0)
+#endif
+
+#ifndef MYNEWT_VAL_BLE_MONITOR_FILE_BUFFER_SIZE
+#define MYNEWT_VAL_BLE_MONITOR_FILE_BUFFER_SIZE (65536)
+#endif
+
+#ifndef MYNEWT_VAL_BLE_MONITOR_FILE_FORMAT
+#define MYNEWT_VAL_BLE_MONITOR_FILE_FORMAT (1)
+#endif
+
+#ifndef MYNEWT_VAL_BLE_MONITOR_FILE_FORMAT__btsnoop
+#define MYNEWT_VAL_BLE_MONITOR_FILE_FORMAT__btsnoop (1)
+#endif
+#ifndef MYNEWT_VAL_BLE_MONITOR_FILE_FORMAT__pcap
+#define MYNEWT_VAL_BLE_MONITOR_FILE_FORMAT__pcap (0)
+#endif
+
+#ifndef MYNEWT_VAL_BLE_MONITOR_FILE_MAX_SIZE
+#define MYNEWT_VAL_BLE_MONITOR_FILE_MAX_SIZE (0)
+#endif
+
+#ifndef MYNEWT_VAL_BLE_MONITOR_FILE_PATH
+#define MYNEWT_VAL_BLE_MONITOR_FILE_PATH "nimble.btsnoop"
+#endif
+
+#ifndef MYNEWT_VAL_BLE_MONITOR_FILE_ROTATE_CNT
+#define MYNEWT_VAL_BLE_MONITOR_FILE_ROTATE_CNT (4)
+#endif
+
 #ifndef MYNEWT_VAL_BLE_MONITOR_RTT
 #define MYNEWT_VAL_BLE_MONITOR_RTT (0)
 #endif
@@ -49,6 +49,11 @@ nimble_port_init(void)
     ble_ll_init();
 #endif
 
+#if MYNEWT_VAL(BLE_MONITOR_FILE)
+    /* Start capture before transport so no packets are missed */
+    ble_monitor_init();
+#endif
+
     /* Initialize transport */
     ble_transport_init();
     /* Initialize the host */
@@ -1236,6 +1236,18 @@
 #define MYNEWT_VAL_BLE_ROLE_PERIPHERAL (1)
 #endif
 
+#ifndef MYNEWT_VAL_BLE_TRACE
+#define MYNEWT_VAL_BLE_TRACE (0)
+#endif
+
+#ifndef MYNEWT_VAL_BLE_TRACE_BUF_SIZE
+#define MYNEWT_VAL_BLE_TRACE_BUF_SIZE (256)
+#endif
+
+#ifndef MYNEWT_VAL_BLE_TRACE_DUMP_FILE
+#define MYNEWT_VAL_BLE_TRACE_DUMP_FILE (0)
+#endif
+
 #ifndef MYNEWT_VAL_BLE_VERSION
 #define MYNEWT_VAL_BLE_VERSION (50)
 #endif
@@ -1512,6 +1524,10 @@
 #define MYNEWT_VAL_BLE_LL_ISO (0)
 #endif
 
+#ifndef MYNEWT_VAL_BLE_LL_ISOAL_MUX_LAYOUT_MAX
+#define MYNEWT_VAL_BLE_LL_ISOAL_MUX_LAYOUT_MAX (8)
+#endif
+
 #ifndef MYNEWT_VAL_BLE_LL_ISOAL_MUX_PREFILL
 #define MYNEWT_VAL_BLE_LL_ISOAL_MUX_PREFILL (0)
 #endif
@@ -1600,6 +1616,10 @@
 #define MYNEWT_VAL_BLE_LL_RESOLV_LIST_SIZE (4)
 #endif
 
+#ifndef MYNEWT_VAL_BLE_LL_RESOLV_RPA_CACHE_SIZE
+#define MYNEWT_VAL_BLE_LL_RESOLV_RPA_CACHE_SIZE (8)
+#endif
+
 #ifndef MYNEWT_VAL_BLE_LL_RFMGMT_ENABLE_TIME
 #define MYNEWT_VAL_BLE_LL_RFMGMT_ENABLE_TIME (1500)
 #endif
@@ -1836,6 +1856,14 @@
 #define MYNEWT_VAL_BLE_EATT_MTU (128)
 #endif
 
+#ifndef MYNEWT_VAL_BLE_GAP_BG_CONN_MAX_PEERS
+#define MYNEWT_VAL_BLE_GAP_BG_CONN_MAX_PEERS (0)
+#endif
+
+#ifndef MYNEWT_VAL_BLE_GAP_BG_CONN_ROTATE_MS
+#define MYNEWT_VAL_BLE_GAP_BG_CONN_ROTATE_MS (2000)
+#endif
+
 #ifndef MYNEWT_VAL_BLE_GAP_MAX_PENDING_CONN_PARAM_UPDATE
 #define MYNEWT_VAL_BLE_GAP_MAX_PENDING_CONN_PARAM_UPDATE (1)
 #endif
@@ -1936,6 +1964,14 @@
 #define MYNEWT_VAL_BLE_HOST (1)
 #endif
 
+#ifndef MYNEWT_VAL_BLE_HS_ADV_FILTER_CONT_CNT
+#define MYNEWT_VAL_BLE_HS_ADV_FILTER_CONT_CNT (4)
+#endif
+
+#ifndef MYNEWT_VAL_BLE_HS_ADV_FILTER_MAX_RULES
+#define MYNEWT_VAL_BLE_HS_ADV_FILTER_MAX_RULES (0)
+#endif
+
 #ifndef MYNEWT_VAL_BLE_HS_AUTO_START
 #define MYNEWT_VAL_BLE_HS_AUTO_START (1)
 #endif
@@ -2004,6 +2040,18 @@
 #define MYNEWT_VAL_BLE_ISO_MAX_BISES (4)
 #endif
 
+#ifndef MYNEWT_VAL_BLE_ISO_TX_MAX_OUTSTANDING
+#define MYNEWT_VAL_BLE_ISO_TX_MAX_OUTSTANDING (2)
+#endif
+
+#ifndef MYNEWT_VAL_BLE_ISO_TX_QUEUE_MAX_LATENCY
+#define MYNEWT_VAL_BLE_ISO_TX_QUEUE_MAX_LATENCY (20)
+#endif
+
+#ifndef MYNEWT_VAL_BLE_ISO_TX_QUEUE_SIZE
+#define MYNEWT_VAL_BLE_ISO_TX_QUEUE_SIZE (0)
+#endif
+
 #ifndef MYNEWT_VAL_BLE_L2CAP_COC_MAX_NUM
 #define MYNEWT_VAL_BLE_L2CAP_COC_MAX_NUM (0)
 #endif
@@ -2174,6 +2222,37 @@
 #define MYNEWT_VAL_BLE_MONITOR_CONSOLE_BUFFER_SIZE (128)
 #endif
 
+#ifndef MYNEWT_VAL_BLE_MONITOR_FILE
+#define MYNEWT_VAL_BLE_MONITOR_FILE (0)
+#endif
+
+#ifndef MYNEWT_VAL_BLE_MONITOR_FILE_BUFFER_SIZE
+#define MYNEWT_VAL_BLE_MONITOR_FILE_BUFFER_SIZE (65536)
+#endif
+
+#ifndef MYNEWT_VAL_BLE_MONITOR_FILE_FORMAT
+#define MYNEWT_VAL_BLE_MONITOR_FILE_FORMAT (1)
+#endif
+
+#ifndef MYNEWT_VAL_BLE_MONITOR_FILE_FORMAT__btsnoop
+#define MYNEWT_VAL_BLE_MONITOR_FILE_FORMAT__btsnoop (1)
+#endif
+#ifndef MYNEWT_VAL_BLE_MONITOR_FILE_FORMAT__pcap
+#define MYNEWT_VAL_BLE_MONITOR_FILE_FORMAT__pcap (0)
+#endif
+
+#ifndef MYNEWT_VAL_BLE_MONITOR_FILE_MAX_SIZE
+#define MYNEWT_VAL_BLE_MONITOR_FILE_MAX_SIZE (0)
+#endif
+
+#ifndef MYNEWT_VAL_BLE_MONITOR_FILE_PATH
+#define MYNEWT_VAL_BLE_MONITOR_FILE_PATH "nimble.btsnoop"
+#endif
+
+#ifndef MYNEWT_VAL_BLE_MONITOR_FILE_ROTATE_CNT
+#define MYNEWT_VAL_BLE_MONITOR_FILE_ROTATE_CNT (4)
+#endif
+
 #ifndef MYNEWT_VAL_BLE_MONITOR_RTT
 #define MYNEWT_VAL_BLE_MONITOR_RTT (0)
 #endif
@@ -0,0 +1,145 @@
+#!/usr/bin/env python3
+#
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#  http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+#
+
+"""
+Decoder for NimBLE binary trace dumps (see nimble/include/nimble/ble_trace.h).
+
+Usage: ble_trace_decode.py [--raw] <dump file>
+
+Prints one line per record with timestamp (in microseconds, relative to the
+first record) and delta from the previous record.
+"""
+
+import argparse
+import struct
+import sys
+
+MAGIC = 0x5254424e
+VERSION = 1
+
+HDR = struct.Struct("<IB3xII")
+REC = struct.Struct("<IHBxIII")
+
+ID_LL_BASE = 0x0000
+ID_HS_BASE = 0x0100
+
+# Keep in sync with nimble/controller/src/ble_ll_trace.c
+LL_EVENTS = {
+    0: ("ll_sched", ("lls", "cputime", "start_time")),
+    1: ("ll_rx_start", ("lls", "pdu_type")),
+    2: ("ll_rx_end", ("pdu_type", "len", "flags")),
+    3: ("ll_wfr_timer_exp", ("lls", "xcvr", "rx_start")),
+    4: ("ll_ctrl_rx", ("opcode", "len")),
+    5: ("ll_conn_ev_start", ("conn_handle",)),
+    6: ("ll_conn_ev_end", ("conn_handle", "event_cntr")),
+    7: ("ll_conn_end", ("conn_handle", "event_cntr", "err")),
+    8: ("ll_conn_tx", ("len", "offset")),
+    9: ("ll_conn_rx", ("conn_sn", "pdu_nesn")),
+    10: ("ll_adv_txdone", ("inst", "chanset")),
+    11: ("ll_adv_halt", ("inst",)),
+    12: ("ll_aux_ref", ("aux", "ref")),
+    13: ("ll_aux_unref", ("aux", "ref")),
+    14: ("ll_scan_start", ("chan", "type")),
+}
+
+# Keep in sync with nimble/host/src/ble_hs_trace_priv.h
+HS_EVENTS = {
+    0: ("hs_att_rx", ("conn_handle", "cid", "opcode")),
+    1: ("hs_att_tx", ("conn_handle", "cid", "opcode")),
+    2: ("hs_l2cap_rx", ("conn_handle", "cid", "len")),
+    3: ("hs_l2cap_tx", ("conn_handle", "cid", "len")),
+    4: ("hs_gap_event", ("type",)),
+    5: ("hs_gap_event_done", ("type", "rc")),
+}
+
+
+def event_desc(ev_id):
+    if ev_id >= ID_HS_BASE:
+        return HS_EVENTS.get(ev_id - ID_HS_BASE)
+    return LL_EVENTS.get(ev_id - ID_LL_BASE)
+
+
+def decode(f, raw):
+    hdr = f.read(HDR.size)
+    if len(hdr) != HDR.size:
+        raise ValueError("file too short")
+
+    magic, version, freq, cnt = HDR.unpack(hdr)
+    if magic != MAGIC:
+        raise ValueError("invalid magic 0x%08x" % magic)
+    if version != VERSION:
+        raise ValueError("unsupported version %d" % version)
+
+    print("# %d records, timestamp frequency %d Hz" % (cnt, freq))
+
+    prev = None
+    # Timestamps are 32-bit and wrap around, accumulate deltas instead
+    elapsed = 0
+
+    while True:
+        data = f.read(REC.size)
+        if len(data) < REC.size:
+            break
+
+        ts, ev_id, nargs, *args = REC.unpack(data)
+        if prev is None:
+            prev = ts
+
+        delta = (ts - prev) & 0xffffffff
+        elapsed += delta
+        prev = ts
+
+        if raw:
+            t = "%10d %+8d" % (elapsed, delta)
+        else:
+            t = "%12.1f %+10.1f" % (elapsed * 1e6 / freq, delta * 1e6 / freq)
+
+        desc = event_desc(ev_id)
+        if desc is None:
+            name = "id_0x%04x" % ev_id
+            arg_names = ("p1", "p2", "p3")
+        else:
+            name, arg_names = desc
+
+        params = " ".join("%s=%d" % (arg_names[i] if i < len(arg_names) else
+                                     "p%d" % (i + 1), args[i])
+                          for i in range(min(nargs, 3)))
+        print("%s %-18s %s" % (t, name, params))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode NimBLE trace dump")
+    parser.add_argument("--raw", action="store_true",
+                        help="print timestamps in ticks instead of usecs")
+    parser.add_argument("file", help="dump created by ble_trace_dump_file()")
+    args = parser.parse_args()
+
+    try:
+        with open(args.file, "rb") as f:
+            decode(f, args.raw)
+    except (OSError, ValueError) as e:
+        print("error: %s" % e, file=sys.stderr)
+        return 1
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())